@@ -11,6 +11,12 @@
  * Ejemplos:
  *   T,T-001,25.5  (Temperatura)
  *   P,P-105,80    (Presión)
+ *
+ * Al recibir 'B' cambia a tramas binarias de 7 bytes (ver TramaBinaria.h
+ * en el programa principal) y con 'A' vuelve al texto:
+ *   0xA5, tipo|canal, valor int16 LE, secuencia, CRC-16 LE
+ * El canal es el número del ID (T-001 -> 1) y la temperatura viaja en
+ * décimas de grado.
  */
 
 // Configuración
@@ -21,6 +27,90 @@ const int DELAY_LECTURA = 2000; // 2 segundos entre lecturas
 float temperaturaBase = 20.0;
 int presionBase = 75;
 
+// Protocolo binario
+const byte SINCRONIA = 0xA5;
+bool modoBinario = false;
+byte secuencia = 0;
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polinomio 0x1021, valor inicial 0xFFFF)
+ */
+unsigned int crc16(const byte* datos, int longitud) {
+  unsigned int crc = 0xFFFF;
+  for (int i = 0; i < longitud; i++) {
+    crc ^= (unsigned int)datos[i] << 8;
+    for (int k = 0; k < 8; k++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/**
+ * @brief Atiende los comandos del programa: 'B' = binario, 'A' = texto
+ */
+void revisarComandos() {
+  while (Serial.available() > 0) {
+    char comando = Serial.read();
+    if (comando == 'B' && !modoBinario) {
+      Serial.println("# Formato: binario");
+      modoBinario = true;
+    } else if (comando == 'A' && modoBinario) {
+      modoBinario = false;
+      Serial.println("# Formato: TIPO,ID,VALOR");
+    }
+  }
+}
+
+/**
+ * @brief Envía una trama binaria
+ * @param tipo 'T' o 'P'
+ * @param canal Número del sensor (0-127)
+ * @param valor Décimas de grado o Pa
+ */
+void enviarTrama(char tipo, byte canal, int valor) {
+  byte trama[7];
+  trama[0] = SINCRONIA;
+  trama[1] = (tipo == 'P' ? 0x80 : 0x00) | (canal & 0x7F);
+  trama[2] = valor & 0xFF;
+  trama[3] = (valor >> 8) & 0xFF;
+  trama[4] = secuencia++;
+  unsigned int crc = crc16(trama + 1, 4);
+  trama[5] = crc & 0xFF;
+  trama[6] = crc >> 8;
+  Serial.write(trama, 7);
+}
+
+/**
+ * @brief Envía una lectura de temperatura en el formato activo
+ */
+void enviarTemperatura(const char* id, byte canal, float valor) {
+  revisarComandos();
+  if (modoBinario) {
+    enviarTrama('T', canal, (int)(valor * 10.0 + (valor >= 0 ? 0.5 : -0.5)));
+  } else {
+    Serial.print("T,");
+    Serial.print(id);
+    Serial.print(",");
+    Serial.println(valor, 1);
+  }
+}
+
+/**
+ * @brief Envía una lectura de presión en el formato activo
+ */
+void enviarPresion(const char* id, byte canal, int valor) {
+  revisarComandos();
+  if (modoBinario) {
+    enviarTrama('P', canal, valor);
+  } else {
+    Serial.print("P,");
+    Serial.print(id);
+    Serial.print(",");
+    Serial.println(valor);
+  }
+}
+
 void setup() {
   // Inicializar comunicación serial
   Serial.begin(BAUDRATE);
@@ -38,29 +128,25 @@ void setup() {
 void loop() {
   // Simular lectura de temperatura
   float temperatura = temperaturaBase + random(-50, 50) / 10.0;
-  Serial.print("T,T-001,");
-  Serial.println(temperatura, 1);
+  enviarTemperatura("T-001", 1, temperatura);
   
   delay(DELAY_LECTURA);
   
   // Simular otra lectura de temperatura
   temperatura = temperaturaBase + random(-30, 70) / 10.0;
-  Serial.print("T,T-002,");
-  Serial.println(temperatura, 1);
+  enviarTemperatura("T-002", 2, temperatura);
   
   delay(DELAY_LECTURA);
   
   // Simular lectura de presión
   int presion = presionBase + random(-10, 15);
-  Serial.print("P,P-105,");
-  Serial.println(presion);
+  enviarPresion("P-105", 105, presion);
   
   delay(DELAY_LECTURA);
   
   // Simular otra lectura de presión
   presion = presionBase + random(-5, 20);
-  Serial.print("P,P-106,");
-  Serial.println(presion);
+  enviarPresion("P-106", 106, presion);
   
   delay(DELAY_LECTURA);
 }
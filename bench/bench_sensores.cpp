@@ -0,0 +1,789 @@
+/**
+ * @file bench_sensores.cpp
+ * @brief Microbenchmarks de las listas, el registro, el análisis y la ingesta
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ *
+ * Uso: bench_sensores [--completo] [--filtro TEXTO]
+ *   --completo  Incluye los tamaños de 10^7 elementos
+ *   --filtro    Ejecuta sólo los casos cuyo nombre contiene TEXTO
+ *
+ * Cada caso reporta nanosegundos por operación y reservas de memoria
+ * (llamadas a operator new) por operación.
+ */
+
+#include "AgregadosTiempo.h"
+#include "ArchivoComprimido.h"
+#include "ListaSensor.h"
+#include "ListaGeneral.h"
+#include "Kernels.h"
+#include "DiarioLecturas.h"
+#include "Instantanea.h"
+#include "SensorPresion.h"
+#include "SensorTemperatura.h"
+#include "ParserLineas.h"
+#include "MotorIngesta.h"
+#include "PoolTrabajo.h"
+#include "TramaBinaria.h"
+#include "Log.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// ---------------------------------------------------------------------------
+// Conteo de reservas: se reemplazan todas las formas no alineadas del
+// operator new/delete global sobre un mismo par malloc/free. No se dejan
+// expandir en línea: así el compilador ve en cada sitio el par new/delete
+// que escribió el programa y no un free() sobre memoria de operator new
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__)
+#define SIN_EN_LINEA __attribute__((noinline))
+#else
+#define SIN_EN_LINEA
+#endif
+
+static std::atomic<long long> reservas(0);
+
+SIN_EN_LINEA void* operator new(std::size_t n) {
+    reservas.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(n > 0 ? n : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+SIN_EN_LINEA void* operator new[](std::size_t n) {
+    return ::operator new(n);
+}
+
+SIN_EN_LINEA void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    reservas.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(n > 0 ? n : 1);
+}
+
+SIN_EN_LINEA void* operator new[](std::size_t n, const std::nothrow_t& nt) noexcept {
+    return ::operator new(n, nt);
+}
+
+SIN_EN_LINEA void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+SIN_EN_LINEA void operator delete[](void* p) noexcept {
+    ::operator delete(p);
+}
+
+SIN_EN_LINEA void operator delete(void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
+
+SIN_EN_LINEA void operator delete[](void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
+
+SIN_EN_LINEA void operator delete(void* p, const std::nothrow_t&) noexcept {
+    ::operator delete(p);
+}
+
+SIN_EN_LINEA void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    ::operator delete(p);
+}
+
+// ---------------------------------------------------------------------------
+// Infraestructura de medición
+// ---------------------------------------------------------------------------
+
+/// Evita que el compilador descarte los resultados medidos
+static volatile double sumidero = 0.0;
+
+/// Filtro de casos (nullptr = todos)
+static const char* filtro = nullptr;
+
+/**
+ * @brief Indica si un caso debe ejecutarse según el filtro
+ * @param nombre Nombre del caso
+ */
+static bool seleccionado(const char* nombre) {
+    return filtro == nullptr || strstr(nombre, filtro) != nullptr;
+}
+
+/**
+ * @brief Ejecuta una función, mide su duración y sus reservas, e imprime el resultado
+ * @tparam Funcion Invocable sin argumentos
+ * @param caso Nombre del caso
+ * @param n Tamaño del problema (elementos o sensores)
+ * @param operaciones Número de operaciones que realiza la función
+ * @param f Trabajo a medir
+ */
+template <typename Funcion>
+static void medir(const char* caso, long long n, long long operaciones, Funcion&& f) {
+    typedef std::chrono::steady_clock Reloj;
+    long long reservasAntes = reservas.load(std::memory_order_relaxed);
+    Reloj::time_point t0 = Reloj::now();
+    f();
+    Reloj::time_point t1 = Reloj::now();
+    long long reservasHechas = reservas.load(std::memory_order_relaxed) - reservasAntes;
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%-44s n=%-9lld %12.2f ns/op %10.4f reservas/op\n",
+           caso, n, ns / operaciones, static_cast<double>(reservasHechas) / operaciones);
+    fflush(stdout);
+}
+
+/**
+ * @brief Generador congruencial determinista (no depende de <random>)
+ */
+static unsigned int semilla = 12345u;
+static unsigned int aleatorio() {
+    semilla = semilla * 1103515245u + 12345u;
+    return (semilla >> 8) & 0xFFFFFF;
+}
+
+/**
+ * @brief Genera un flujo TIPO,ID,VALOR sintético
+ * @param lineas Número de líneas
+ * @param sensores Número de sensores distintos
+ * @param longitud Destino de la longitud en bytes
+ * @return Búfer reservado con new[] (lo libera quien llama)
+ */
+static char* generarFlujo(long long lineas, int sensores, size_t& longitud) {
+    size_t capacidad = static_cast<size_t>(lineas) * 24 + 1;
+    char* flujo = new char[capacidad];
+    size_t pos = 0;
+    for (long long i = 0; i < lineas; i++) {
+        int s = static_cast<int>(aleatorio() % sensores);
+        int escritos;
+        if (s % 2 == 0) {
+            escritos = snprintf(flujo + pos, capacidad - pos, "T,T-%05d,%d.%d\n",
+                                s, 15 + static_cast<int>(aleatorio() % 15), static_cast<int>(aleatorio() % 10));
+        } else {
+            escritos = snprintf(flujo + pos, capacidad - pos, "P,P-%05d,%d\n",
+                                s, 60 + static_cast<int>(aleatorio() % 40));
+        }
+        pos += static_cast<size_t>(escritos);
+    }
+    longitud = pos;
+    return flujo;
+}
+
+// ---------------------------------------------------------------------------
+// Casos
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Casos de ListaSensor<T> para un tamaño dado
+ * @tparam T Tipo de lectura
+ * @param tipo Nombre del tipo para el reporte
+ * @param n Número de elementos
+ */
+template <typename T>
+static void benchListaSensor(const char* tipo, long long n) {
+    char caso[64];
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::insertarAlFinal", tipo);
+    if (seleccionado(caso)) {
+        ListaSensor<T> lista;
+        medir(caso, n, n, [&] {
+            for (long long i = 0; i < n; i++) {
+                lista.insertarAlFinal(static_cast<T>(aleatorio() % 1000));
+            }
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::insertarAlFinal (retener 4096)", tipo);
+    if (seleccionado(caso)) {
+        ListaSensor<T> lista;
+        lista.setRetencion(PoliticaRetencion(4096));
+        medir(caso, n, n, [&] {
+            for (long long i = 0; i < n; i++) {
+                lista.insertarAlFinal(static_cast<T>(aleatorio() % 1000));
+            }
+        });
+    }
+
+    ListaSensor<T> lista;
+    for (long long i = 0; i < n; i++) {
+        lista.insertarAlFinal(static_cast<T>(aleatorio() % 1000));
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::insertarVarias", tipo);
+    if (seleccionado(caso)) {
+        T* valores = new T[n];
+        for (long long i = 0; i < n; i++) {
+            valores[i] = static_cast<T>(aleatorio() % 1000);
+        }
+        ListaSensor<T> destino;
+        medir(caso, n, n, [&] {
+            destino.insertarVarias(valores, static_cast<int>(n));
+        });
+        delete[] valores;
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s> (copia)", tipo);
+    if (seleccionado(caso)) {
+        medir(caso, n, n, [&] {
+            ListaSensor<T> copia(lista);
+            sumidero = sumidero + copia.getSuma();
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::empalmar", tipo);
+    if (seleccionado(caso)) {
+        ListaSensor<T> origen(lista);
+        ListaSensor<T> destino;
+        medir(caso, n, 1, [&] {
+            destino.empalmar(origen);
+        });
+        sumidero = sumidero + destino.getTamanio();
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::mezclar (intercaladas)", tipo);
+    if (seleccionado(caso)) {
+        // Marcas pares en una lista e impares en la otra: el peor caso
+        ListaSensor<T> pares;
+        ListaSensor<T> impares;
+        for (long long i = 0; i < n; i++) {
+            pares.insertarAlFinal(static_cast<T>(aleatorio() % 1000), 2 * i);
+            impares.insertarAlFinal(static_cast<T>(aleatorio() % 1000), 2 * i + 1);
+        }
+        medir(caso, n, 2 * n, [&] {
+            pares.mezclar(impares);
+        });
+        sumidero = sumidero + pares.getTamanio();
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::buscar (ausente)", tipo);
+    if (seleccionado(caso)) {
+        long long repeticiones = n >= 1000000 ? 3 : 1000000 / n;
+        medir(caso, n, repeticiones, [&] {
+            for (long long r = 0; r < repeticiones; r++) {
+                sumidero = sumidero + (lista.buscar(static_cast<T>(-1)) ? 1.0 : 0.0);
+            }
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::calcularPromedio", tipo);
+    if (seleccionado(caso)) {
+        long long repeticiones = 1000000;
+        medir(caso, n, repeticiones, [&] {
+            for (long long r = 0; r < repeticiones; r++) {
+                sumidero = sumidero + static_cast<double>(lista.calcularPromedio());
+            }
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::resumirRango (1%% de n)", tipo);
+    if (seleccionado(caso)) {
+        // Una lectura por milisegundo; ventanas aleatorias con n/100 lecturas
+        ListaSensor<T> serie;
+        for (long long i = 0; i < n; i++) {
+            serie.insertarAlFinal(static_cast<T>(aleatorio() % 1000), i);
+        }
+        long long ancho = n / 100 > 0 ? n / 100 : 1;
+        long long repeticiones = 100000 / ancho > 10 ? 100000 / ancho : 10;
+        sumidero = sumidero + serie.resumirRango(0, 1).cantidad;   // construye el índice
+        medir(caso, n, repeticiones, [&] {
+            for (long long r = 0; r < repeticiones; r++) {
+                long long t0 = static_cast<long long>(aleatorio() % static_cast<unsigned long long>(n));
+                sumidero = sumidero + serie.resumirRango(t0, t0 + ancho).promedio();
+            }
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::eliminarMasBajo (n/2)", tipo);
+    if (seleccionado(caso)) {
+        long long quitar = n / 2;
+        medir(caso, n, quitar, [&] {
+            for (long long r = 0; r < quitar; r++) {
+                sumidero = sumidero + static_cast<double>(lista.eliminarMasBajo());
+            }
+        });
+    }
+}
+
+/**
+ * @brief Recorridos completos de ListaSensor<T> con el nivel SIMD activo
+ * @tparam T Tipo de lectura
+ * @param tipo Nombre del tipo para el reporte
+ * @param n Número de elementos
+ */
+template <typename T>
+static void benchRecorridos(const char* tipo, long long n) {
+    ListaSensor<T> lista;
+    for (long long i = 0; i < n; i++) {
+        lista.insertarAlFinal(static_cast<T>(aleatorio() % 1000), i);
+    }
+    long long repeticiones = n >= 1000000 ? 10 : 10000000 / n;
+    sumidero = sumidero + lista.resumirRango(0, 1).cantidad;   // construye el índice
+    char caso[80];
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::buscar (ausente) [%s]", tipo, Kernels::nombreNivel());
+    if (seleccionado(caso)) {
+        medir(caso, n, repeticiones * n, [&] {
+            for (long long r = 0; r < repeticiones; r++) sumidero = sumidero + (lista.buscar(static_cast<T>(-1)) ? 1.0 : 0.0);
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::resumirRango (todo) [%s]", tipo, Kernels::nombreNivel());
+    if (seleccionado(caso)) {
+        medir(caso, n, repeticiones * n, [&] {
+            for (long long r = 0; r < repeticiones; r++) sumidero = sumidero + lista.resumirRango(0, n).promedio();
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::calcularVarianza [%s]", tipo, Kernels::nombreNivel());
+    if (seleccionado(caso)) {
+        medir(caso, n, repeticiones * n, [&] {
+            for (long long r = 0; r < repeticiones; r++) sumidero = sumidero + lista.calcularVarianza();
+        });
+    }
+
+    snprintf(caso, sizeof(caso), "ListaSensor<%s>::buscarMinimo [%s]", tipo, Kernels::nombreNivel());
+    if (seleccionado(caso)) {
+        medir(caso, n, repeticiones * n, [&] {
+            T valor = T();
+            long long tiempo = 0;
+            for (long long r = 0; r < repeticiones; r++) {
+                if (lista.buscarMinimo(valor, tiempo)) sumidero = sumidero + static_cast<double>(tiempo);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Agregados por nivel: inserción y consultas largas (una lectura por segundo)
+ * @param dias Días de lecturas
+ */
+static void benchAgregados(int dias) {
+    const long long segundos = static_cast<long long>(dias) * 86400;
+    AgregadosTiempo agregados;
+
+    const char* caso = "AgregadosTiempo::agregar";
+    bool medirAgregar = seleccionado(caso);
+    if (medirAgregar || seleccionado("AgregadosTiempo::resumir")) {
+        medir(caso, segundos, segundos, [&] {
+            for (long long s = 0; s < segundos; s++) {
+                agregados.agregar(static_cast<double>(aleatorio() % 1000), s * 1000);
+            }
+        });
+    }
+
+    caso = "AgregadosTiempo::resumir (30 días)";
+    if (seleccionado(caso)) {
+        long long repeticiones = 10000;
+        const long long mes = 30LL * 86400 * 1000;
+        medir(caso, segundos, repeticiones, [&] {
+            for (long long r = 0; r < repeticiones; r++) {
+                // Bordes sin alinear para que intervengan los tres niveles
+                long long t0 = static_cast<long long>(aleatorio() % 3600) * 1000 + 1234;
+                sumidero = sumidero + agregados.resumir(t0, t0 + mes).promedio();
+            }
+        });
+    }
+}
+
+/**
+ * @brief Lectura sintética con la forma de un sensor real
+ *
+ * Paseo aleatorio: temperatura en décimas de grado (como las envía el
+ * Arduino) y presión en unidades enteras.
+ */
+template <typename T>
+static T lecturaRealista(int& paso);
+
+template <>
+float lecturaRealista<float>(int& paso) {
+    paso += static_cast<int>(aleatorio() % 3) - 1;
+    return static_cast<float>(200 + paso) / 10.0f;
+}
+
+template <>
+int lecturaRealista<int>(int& paso) {
+    paso += static_cast<int>(aleatorio() % 3) - 1;
+    return 1013 + paso;
+}
+
+/**
+ * @brief Archivo comprimido: inserción, decodificación, consulta y bytes por lectura
+ * @tparam T Tipo de lectura
+ * @param tipo Nombre del tipo para el reporte
+ * @param n Número de lecturas (una por segundo, con variación de pocos ms)
+ */
+template <typename T>
+static void benchArchivo(const char* tipo, long long n) {
+    char caso[80];
+    snprintf(caso, sizeof(caso), "ArchivoComprimido<%s>", tipo);
+    if (!seleccionado(caso)) return;
+
+    T* valores = new T[n];
+    long long* tiempos = new long long[n];
+    int paso = 0;
+    for (long long i = 0; i < n; i++) {
+        valores[i] = lecturaRealista<T>(paso);
+        tiempos[i] = i * 1000 + static_cast<long long>(aleatorio() % 3) * 4;  // Tics del reloj grueso
+    }
+
+    ArchivoComprimido<T> archivo;
+    snprintf(caso, sizeof(caso), "ArchivoComprimido<%s>::agregar", tipo);
+    medir(caso, n, n, [&] {
+        for (long long i = 0; i < n; i++) {
+            archivo.agregar(valores[i], tiempos[i]);
+        }
+    });
+
+    snprintf(caso, sizeof(caso), "ArchivoComprimido<%s>::lecturas (decodificar)", tipo);
+    medir(caso, n, n, [&] {
+        T valor;
+        long long tiempo;
+        double acumulado = 0.0;
+        for (typename ArchivoComprimido<T>::Iterador it = archivo.lecturas(); it.siguiente(valor, tiempo);) {
+            acumulado += valor;
+        }
+        sumidero = sumidero + acumulado;
+    });
+
+    snprintf(caso, sizeof(caso), "ArchivoComprimido<%s>::resumirRango (1%% de n)", tipo);
+    long long repeticiones = 1000;
+    long long ventana = n * 10;
+    medir(caso, n, repeticiones, [&] {
+        for (long long r = 0; r < repeticiones; r++) {
+            long long t0 = static_cast<long long>(aleatorio() % static_cast<unsigned int>(n)) * 1000;
+            sumidero = sumidero + archivo.resumirRango(t0, t0 + ventana).promedio();
+        }
+    });
+
+    // Mismas lecturas sin comprimir, para comparar la memoria
+    ListaSensor<T> lista;
+    lista.insertarVarias(valores, static_cast<int>(n), 0);
+    snprintf(caso, sizeof(caso), "ArchivoComprimido<%s> (memoria)", tipo);
+    printf("%-44s n=%-9lld %12.2f B/lectura %8.2f B/lectura en ListaSensor\n", caso, n,
+           static_cast<double>(archivo.memoriaUsada()) / static_cast<double>(n),
+           static_cast<double>(lista.memoriaUsada()) / static_cast<double>(n));
+    fflush(stdout);
+
+    delete[] valores;
+    delete[] tiempos;
+}
+
+/**
+ * @brief Búsqueda de sensores en ListaGeneral con n sensores registrados
+ * @param n Número de sensores
+ */
+static void benchBuscarSensor(long long n) {
+    const char* caso = "ListaGeneral::buscarSensor";
+    const char* casoId = "ListaGeneral::buscarPorId";
+    if (!seleccionado(caso) && !seleccionado(casoId)) return;
+
+    ListaGeneral lista;
+    char (*nombres)[16] = new char[n][16];
+    for (long long i = 0; i < n; i++) {
+        snprintf(nombres[i], 16, "P-%07d", static_cast<int>(i));
+        lista.insertarSensor(new SensorPresion(nombres[i]));
+    }
+
+    long long consultas = 1000000;
+    if (seleccionado(caso)) {
+        medir(caso, n, consultas, [&] {
+            for (long long c = 0; c < consultas; c++) {
+                SensorBase* s = lista.buscarSensor(nombres[aleatorio() % n]);
+                sumidero = sumidero + (s != nullptr ? 1.0 : 0.0);
+            }
+        });
+    }
+
+    // Lo que paga el camino de ingesta una vez internado el ID
+    if (seleccionado(casoId)) {
+        IdNombre* ids = new IdNombre[n];
+        for (long long i = 0; i < n; i++) {
+            ids[i] = TablaNombres::global().buscar(nombres[i], static_cast<int>(strlen(nombres[i])));
+        }
+        medir(casoId, n, consultas, [&] {
+            for (long long c = 0; c < consultas; c++) {
+                SensorBase* s = lista.buscarPorId(ids[aleatorio() % n]);
+                sumidero = sumidero + (s != nullptr ? 1.0 : 0.0);
+            }
+        });
+        delete[] ids;
+    }
+    delete[] nombres;
+}
+
+/**
+ * @brief Análisis de líneas con ParserLineas::parsearBloque
+ * @param lineas Número de líneas del flujo sintético
+ */
+static void benchParser(long long lineas) {
+    const char* caso = "ParserLineas::parsearBloque (por linea)";
+    if (!seleccionado(caso)) return;
+
+    size_t longitud = 0;
+    char* flujo = generarFlujo(lineas, 1000, longitud);
+    ParserLineas parser;
+    medir(caso, lineas, lineas, [&] {
+        double acumulado = 0.0;
+        parser.parsearBloque(flujo, longitud, [&](const LecturaParseada& l) {
+            acumulado += l.tipo == 'T' ? l.valorFloat : l.valorEntero;
+        });
+        sumidero = sumidero + acumulado;
+    });
+    delete[] flujo;
+}
+
+/**
+ * @brief Ingesta completa (análisis, búsqueda, creación y registro) en bloques de 256 KiB
+ * @param lineas Número de líneas del flujo sintético
+ * @param sensores Número de sensores distintos
+ */
+static void benchIngesta(long long lineas, int sensores) {
+    char caso[64];
+    snprintf(caso, sizeof(caso), "MotorIngesta::alimentar (%d sensores)", sensores);
+    if (!seleccionado(caso)) return;
+
+    size_t longitud = 0;
+    char* flujo = generarFlujo(lineas, sensores, longitud);
+    ListaGeneral lista;
+    MotorIngesta motor(lista);
+    const size_t bloque = 256 * 1024;
+    medir(caso, lineas, lineas, [&] {
+        for (size_t pos = 0; pos < longitud; pos += bloque) {
+            size_t n = longitud - pos < bloque ? longitud - pos : bloque;
+            motor.alimentar(flujo + pos, n);
+        }
+        motor.finalizar();
+    });
+    delete[] flujo;
+}
+
+/**
+ * @brief Registro de lecturas ya analizadas en sensores ya encontrados
+ * @param lecturas Número de lecturas
+ * @param sensores Número de sensores (mitad temperatura, mitad presión)
+ *
+ * Aísla el despacho por tipo (etiqueta + static_cast) y el registro en el
+ * historial, sin análisis ni búsqueda por nombre.
+ */
+static void benchAplicarLectura(long long lecturas, int sensores) {
+    if (!seleccionado("MotorIngesta::aplicarLectura")) return;
+
+    SensorBase** destinos = new SensorBase*[sensores];
+    for (int i = 0; i < sensores; i++) {
+        char nombre[16];
+        snprintf(nombre, sizeof(nombre), "S-%05d", i);
+        if (i % 2 == 0) {
+            destinos[i] = new SensorTemperatura(nombre);
+        } else {
+            destinos[i] = new SensorPresion(nombre);
+        }
+    }
+    LecturaParseada lectura;
+    lectura.valorFloat = 21.5f;
+    lectura.valorEntero = 1013;
+    medir("MotorIngesta::aplicarLectura", lecturas, lecturas, [&] {
+        for (long long i = 0; i < lecturas; i++) {
+            int k = static_cast<int>(i % sensores);
+            lectura.tipo = k % 2 == 0 ? 'T' : 'P';
+            MotorIngesta::aplicarLectura(destinos[k], lectura, i);
+        }
+    });
+    for (int i = 0; i < sensores; i++) {
+        delete destinos[i];
+    }
+    delete[] destinos;
+}
+
+/**
+ * @brief Ingesta de tramas binarias (mismo contenido que el flujo de texto)
+ * @param lecturas Número de tramas
+ * @param sensores Número de canales distintos (máximo 128)
+ */
+static void benchIngestaBinaria(long long lecturas, int sensores) {
+    char caso[64];
+    snprintf(caso, sizeof(caso), "MotorIngesta::alimentar tramas (%d sensores)", sensores);
+    if (!seleccionado(caso)) return;
+
+    size_t longitud = static_cast<size_t>(lecturas) * TramaBinaria::LONGITUD;
+    unsigned char* flujo = new unsigned char[longitud];
+    for (long long i = 0; i < lecturas; i++) {
+        int canal = static_cast<int>(aleatorio() % sensores);
+        char tipo = canal % 2 == 0 ? 'T' : 'P';
+        int valor = tipo == 'T' ? static_cast<int>(aleatorio() % 1000) : static_cast<int>(aleatorio() % 20000);
+        TramaBinaria::codificar(tipo, canal, valor, static_cast<unsigned char>(i),
+                                flujo + i * TramaBinaria::LONGITUD);
+    }
+    ListaGeneral lista;
+    MotorIngesta motor(lista);
+    const size_t bloque = 256 * 1024;
+    medir(caso, lecturas, lecturas, [&] {
+        for (size_t pos = 0; pos < longitud; pos += bloque) {
+            size_t n = longitud - pos < bloque ? longitud - pos : bloque;
+            motor.alimentar(reinterpret_cast<const char*>(flujo) + pos, n);
+        }
+        motor.finalizar();
+    });
+    delete[] flujo;
+}
+
+/**
+ * @brief Guardado y restauración de una instantánea del registro completo
+ * @param lineas Lecturas totales
+ * @param sensores Número de sensores distintos
+ *
+ * El archivo se escribe en el directorio actual y se borra al terminar.
+ */
+static void benchInstantanea(long long lineas, int sensores) {
+    if (!seleccionado("Instantanea::")) return;
+    const char* ruta = "bench_instantanea.snap";
+
+    size_t longitud = 0;
+    char* flujo = generarFlujo(lineas, sensores, longitud);
+    ListaGeneral lista;
+    MotorIngesta motor(lista);
+    motor.alimentar(flujo, longitud);
+    motor.finalizar();
+    delete[] flujo;
+
+    medir("Instantanea::guardar", lineas, lineas, [&] {
+        Instantanea::guardar(lista, ruta);
+    });
+    ListaGeneral restaurada;
+    medir("Instantanea::cargar", lineas, lineas, [&] {
+        Instantanea::cargar(restaurada, ruta);
+    });
+    std::remove(ruta);
+}
+
+/**
+ * @brief Anotación de lecturas en el diario (con fsync por grupo) y su reproducción
+ * @param lecturas Lecturas a anotar
+ * @param sensores Número de sensores distintos
+ *
+ * El tiempo de registrar incluye confirmar(): todas las lecturas quedan
+ * en el disco. El archivo se escribe en el directorio actual y se borra
+ * al terminar.
+ */
+static void benchDiario(long long lecturas, int sensores) {
+    if (!seleccionado("DiarioLecturas::")) return;
+    const char* ruta = "bench_diario.wal";
+    std::remove(ruta);
+
+    IdNombre ids[64];
+    int total = sensores < 64 ? sensores : 64;
+    for (int i = 0; i < total; i++) {
+        char nombre[16];
+        snprintf(nombre, sizeof(nombre), "T-%03d", i);
+        ids[i] = TablaNombres::global().internar(nombre, static_cast<int>(strlen(nombre)));
+    }
+
+    DiarioLecturas diario;
+    diario.abrir(ruta);
+    medir("DiarioLecturas::registrar", lecturas, lecturas, [&] {
+        for (long long i = 0; i < lecturas; i++) {
+            diario.registrar('T', ids[i % total], static_cast<float>(i % 1000) / 10.0f, 0, i);
+        }
+        diario.confirmar();
+    });
+    diario.cerrar();
+
+    ListaGeneral lista;
+    MotorIngesta motor(lista);
+    medir("DiarioLecturas::reproducir", lecturas, lecturas, [&] {
+        DiarioLecturas::reproducir(ruta, motor);
+    });
+    std::remove(ruta);
+}
+
+/**
+ * @brief Procesamiento polimórfico de sensores con historiales muy desiguales
+ * @param sensores Número de sensores
+ * @param hilos Hilos del grupo (1 = versión secuencial, 0 = núcleos)
+ */
+static void benchProcesar(int sensores, int hilos) {
+    char caso[80];
+    if (hilos == 1) {
+        snprintf(caso, sizeof(caso), "ListaGeneral::procesarTodosSensores (secuencial)");
+    } else {
+        snprintf(caso, sizeof(caso), "ListaGeneral::procesarTodosSensores (paralelo)");
+    }
+    if (!seleccionado(caso)) return;
+
+    // El sensor i recibe ~200000/(i+1) lecturas: unos pocos dominan el costo
+    ListaGeneral lista;
+    for (int i = 0; i < sensores; i++) {
+        char nombre[16];
+        snprintf(nombre, sizeof(nombre), "T-%06d", i);
+        SensorTemperatura* sensor = new SensorTemperatura(nombre);
+        int lecturas = 200000 / (i + 1) + 16;
+        for (int k = 0; k < lecturas; k++) {
+            sensor->registrarLectura(static_cast<float>(aleatorio() % 100000) / 100.0f);
+        }
+        lista.insertarSensor(sensor);
+    }
+
+    PoolTrabajo* pool = hilos != 1 ? new PoolTrabajo(hilos) : nullptr;
+    medir(caso, sensores, sensores, [&] {
+        if (pool != nullptr) {
+            lista.procesarTodosSensores(*pool);
+        } else {
+            lista.procesarTodosSensores();
+        }
+    });
+    delete pool;
+}
+
+int main(int argc, char* argv[]) {
+    bool completo = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--completo") == 0) {
+            completo = true;
+        } else if (strcmp(argv[i], "--filtro") == 0 && i + 1 < argc) {
+            filtro = argv[++i];
+        } else {
+            printf("Uso: %s [--completo] [--filtro TEXTO]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Se mide la estructura de datos, no la bitácora
+    Log::setNivel(NivelLog::NINGUNO);
+
+    long long maximo = completo ? 10000000 : 1000000;
+    for (long long n = 1000; n <= maximo; n *= 10) {
+        benchListaSensor<float>("float", n);
+        benchListaSensor<int>("int", n);
+    }
+
+    // Mismos datos con el nivel detectado y con el escalar, para comparar
+    for (long long n = 1000; n <= maximo; n *= 1000) {
+        benchRecorridos<float>("float", n);
+        benchRecorridos<int>("int", n);
+    }
+    NivelSimd detectado = Kernels::nivel();
+    if (detectado != NivelSimd::ESCALAR && Kernels::forzarNivel(NivelSimd::ESCALAR)) {
+        benchRecorridos<float>("float", maximo);
+        benchRecorridos<int>("int", maximo);
+        Kernels::forzarNivel(detectado);
+    }
+
+    for (long long n = 10; n <= 100000; n *= 10) {
+        benchBuscarSensor(n);
+    }
+
+    benchParser(maximo);
+    benchIngesta(maximo, 10);
+    benchIngesta(maximo, 10000);
+    benchIngestaBinaria(maximo, 10);
+    benchAplicarLectura(maximo, 1000);
+    benchInstantanea(maximo, 100);
+    benchDiario(maximo, 64);
+
+    benchAgregados(31);
+    benchArchivo<float>("float", maximo);
+    benchArchivo<int>("int", maximo);
+
+    benchProcesar(10000, 1);
+    benchProcesar(10000, 0);
+    return 0;
+}
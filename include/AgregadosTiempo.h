@@ -0,0 +1,231 @@
+/**
+ * @file AgregadosTiempo.h
+ * @brief Resúmenes de lecturas por segundo, minuto y hora mantenidos al insertar
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef AGREGADOS_TIEMPO_H
+#define AGREGADOS_TIEMPO_H
+
+#include "VentanaTiempo.h"
+
+/**
+ * @brief Niveles de resolución de los agregados
+ */
+enum class NivelAgregado {
+    SEGUNDO,    ///< Cubetas de 1 s
+    MINUTO,     ///< Cubetas de 1 min
+    HORA        ///< Cubetas de 1 h
+};
+
+/**
+ * @brief Conteo, suma, mínimo y máximo de las lecturas de un sensor por intervalos fijos
+ *
+ * Cada lectura actualiza en O(1) la cubeta en curso de los tres niveles
+ * (segundo, minuto y hora). Las cubetas en curso viven dentro del objeto,
+ * así que una lectura sólo toca memoria del propio sensor; al cerrarse,
+ * cada cubeta pasa a un anillo de su nivel que crece al doble bajo demanda
+ * hasta un horizonte fijo (1 h de segundos, 7 días de minutos, 1 año de
+ * horas). Con el anillo lleno se pisa la cubeta más antigua. Sólo se
+ * guardan los intervalos con lecturas, así que un sensor poco activo
+ * ocupa poca memoria.
+ *
+ * resumir(t0, t1) descompone el intervalo: las horas completas salen del
+ * nivel de horas, los bordes de minutos del nivel de minutos y el resto
+ * del de segundos. Un mes se responde con unas 800 cubetas. Los agregados
+ * no dependen del historial crudo: siguen disponibles aunque la retención
+ * haya descartado las lecturas, y no cambian con eliminarMasBajo.
+ *
+ * Las marcas deben llegar en orden no decreciente (como en ListaSensor);
+ * una marca anterior se cuenta en la cubeta en curso.
+ */
+class AgregadosTiempo {
+private:
+    /// Número de niveles
+    static constexpr int NUM_NIVELES = 3;
+
+    /**
+     * @brief Agregados de un intervalo [inicio, inicio + ancho)
+     */
+    struct Cubeta {
+        long long inicio;       ///< Comienzo del intervalo (ms, múltiplo del ancho)
+        long long cantidad;     ///< Lecturas
+        double suma;            ///< Suma de las lecturas
+        double minimo;          ///< Mínimo
+        double maximo;          ///< Máximo
+    };
+
+    /**
+     * @brief Cubeta en curso y anillo de cubetas cerradas de un nivel, ordenadas por inicio
+     */
+    struct Nivel {
+        long long ancho;        ///< Duración de cada cubeta (ms)
+        Cubeta enCurso;         ///< Cubeta abierta (vacía si cantidad == 0)
+        int maxCubetas;         ///< Cubetas cerradas conservadas como máximo
+        Cubeta* cubetas;        ///< Anillo (nullptr hasta cerrar la primera cubeta)
+        int capacidad;          ///< Cubetas reservadas
+        int primera;            ///< Posición de la cubeta más antigua
+        int cantidad;           ///< Cubetas cerradas en el anillo
+        long long horizonte;    ///< Inicio de la más antigua tras pisar alguna (o LLONG_MIN)
+    };
+
+    Nivel niveles[NUM_NIVELES];     ///< Segundos, minutos y horas
+    long long lecturas;             ///< Lecturas agregadas desde la creación
+
+    /**
+     * @brief Cubetas de un nivel contando la que está en curso
+     */
+    static int numCubetas(const Nivel& nivel) {
+        return nivel.cantidad + (nivel.enCurso.cantidad > 0 ? 1 : 0);
+    }
+
+    /**
+     * @brief Cubeta lógica i (0 = la más antigua, numCubetas - 1 = la en curso)
+     */
+    static const Cubeta& cubeta(const Nivel& nivel, int i) {
+        if (i == nivel.cantidad) return nivel.enCurso;
+        return nivel.cubetas[(nivel.primera + i) % nivel.capacidad];
+    }
+
+    /**
+     * @brief Suma una lectura a una cubeta que ya tiene alguna
+     */
+    static void sumarEnCubeta(Cubeta& cubeta, double valor) {
+        if (valor < cubeta.minimo) cubeta.minimo = valor;
+        if (cubeta.maximo < valor) cubeta.maximo = valor;
+        cubeta.cantidad++;
+        cubeta.suma += valor;
+    }
+
+    /**
+     * @brief Agrega una lectura al nivel indicado
+     */
+    static void agregarEnNivel(Nivel& nivel, double valor, long long tiempo);
+
+    /**
+     * @brief Camino general de agregar(): alguna cubeta en curso se cierra
+     */
+    void agregarCerrando(double valor, long long tiempo);
+
+    /**
+     * @brief Pasa la cubeta en curso al final del anillo (crece o pisa la más antigua)
+     */
+    static void cerrarCubeta(Nivel& nivel);
+
+    /**
+     * @brief Acumula las cubetas de un nivel con inicio en [desde, hasta)
+     */
+    static void sumarCubetas(const Nivel& nivel, long long desde, long long hasta, ResumenVentana& resumen);
+
+    /**
+     * @brief Acumula [a, b) usando el nivel indicado y los más finos para los bordes
+     */
+    void acumular(int nivel, long long a, long long b, ResumenVentana& resumen) const;
+
+    /**
+     * @brief Deja los niveles vacíos (sin liberar)
+     */
+    void inicializarNiveles();
+
+    /**
+     * @brief Copia las cubetas de otro objeto (los niveles propios deben estar vacíos)
+     */
+    void copiarDesde(const AgregadosTiempo& otro);
+
+    /**
+     * @brief Libera todas las cubetas
+     */
+    void liberar();
+
+public:
+    /// Resolución de las consultas: ancho de las cubetas más finas (ms)
+    static constexpr long long RESOLUCION_MS = 1000;
+
+    /**
+     * @brief Indica si [t0, t1) cae en segundos completos (resolución de 1 s o más gruesa)
+     * @param t0 Inicio (ms)
+     * @param t1 Fin (ms)
+     * @return true si resumir() la responde sin redondear los bordes
+     */
+    static bool alineada(long long t0, long long t1) {
+        return t0 % RESOLUCION_MS == 0 && t1 % RESOLUCION_MS == 0;
+    }
+
+    /**
+     * @brief Constructor (no reserva memoria hasta la primera lectura)
+     */
+    AgregadosTiempo();
+
+    /**
+     * @brief Destructor
+     */
+    ~AgregadosTiempo();
+
+    /**
+     * @brief Constructor de copia (Regla de los Tres)
+     * @param otro Agregados a copiar
+     */
+    AgregadosTiempo(const AgregadosTiempo& otro);
+
+    /**
+     * @brief Operador de asignación (Regla de los Tres)
+     * @param otro Agregados a asignar
+     * @return Referencia a este objeto
+     */
+    AgregadosTiempo& operator=(const AgregadosTiempo& otro);
+
+    /**
+     * @brief Incorpora una lectura a los tres niveles (O(1) amortizado)
+     * @param valor Lectura
+     * @param tiempo Marca de tiempo en ms de relojMs
+     */
+    void agregar(double valor, long long tiempo) {
+        Cubeta& segundo = niveles[0].enCurso;
+        if (segundo.cantidad > 0 && tiempo < segundo.inicio + niveles[0].ancho) {
+            // Mismo segundo: también el mismo minuto y la misma hora
+            for (int i = 0; i < NUM_NIVELES; i++) {
+                sumarEnCubeta(niveles[i].enCurso, valor);
+            }
+            lecturas++;
+            return;
+        }
+        agregarCerrando(valor, tiempo);
+    }
+
+    /**
+     * @brief Resume las lecturas de [t0, t1) con el nivel más grueso posible
+     * @param t0 Inicio (ms, incluido)
+     * @param t1 Fin (ms, excluido)
+     * @return Resumen de la ventana
+     *
+     * La resolución es de 1 s: se cuentan completos los segundos que tocan
+     * el intervalo. Donde un nivel fino ya pisó sus cubetas se usa la
+     * cubeta completa del nivel siguiente.
+     */
+    ResumenVentana resumir(long long t0, long long t1) const;
+
+    /**
+     * @brief Resumen de las lecturas de los últimos ventanaMs milisegundos
+     * @param ventanaMs Duración de la ventana (ms)
+     */
+    ResumenVentana resumirUltimos(long long ventanaMs) const;
+
+    /**
+     * @brief Cubetas en uso de un nivel (incluida la en curso)
+     * @param nivel Nivel consultado
+     */
+    int getCubetas(NivelAgregado nivel) const;
+
+    /**
+     * @brief Lecturas agregadas desde la creación
+     */
+    long long getLecturas() const;
+
+    /**
+     * @brief Bytes reservados para las cubetas
+     */
+    long long memoriaUsada() const;
+};
+
+#endif // AGREGADOS_TIEMPO_H
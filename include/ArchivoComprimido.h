@@ -0,0 +1,799 @@
+/**
+ * @file ArchivoComprimido.h
+ * @brief Historial comprimido en bloques sellados (XOR tipo Gorilla y delta de deltas)
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef ARCHIVO_COMPRIMIDO_H
+#define ARCHIVO_COMPRIMIDO_H
+
+#include <cstring>
+#include <type_traits>
+#include "FlujoBits.h"
+#include "VentanaTiempo.h"
+
+/**
+ * @brief Escribe un entero pequeño con prefijo: 0 → "0", < 16 → "10" + 4 bits, resto "11" + varint
+ *
+ * Es el código de las diferencias de diferencias: las series regulares
+ * producen casi siempre 0 o valores de pocas unidades.
+ */
+inline void escribirPequenio(EscritorBits& escritor, unsigned long long valor) {
+    if (valor == 0) {
+        escritor.escribir(0, 1);
+    } else if (valor < 16) {
+        escritor.escribir(2, 2);
+        escritor.escribir(valor, 4);
+    } else {
+        escritor.escribir(3, 2);
+        escritor.escribirVarint(valor);
+    }
+}
+
+/**
+ * @brief Inversa de escribirPequenio()
+ */
+inline unsigned long long leerPequenio(LectorBits& lector) {
+    if (!lector.leerBit()) return 0;
+    if (!lector.leerBit()) return lector.leer(4);
+    return lector.leerVarint();
+}
+
+/**
+ * @brief Codificación de los valores de un historial comprimido
+ * @tparam T float o int
+ *
+ * Cada especialización define un Estado (lo que se recuerda de las
+ * lecturas anteriores del bloque) y las funciones codificar/decodificar.
+ * La lectura i == 0 de cada bloque se guarda completa.
+ */
+template <typename T>
+struct CodecValores;
+
+/**
+ * @brief Valores float con XOR respecto al anterior (esquema Gorilla)
+ *
+ * Si el valor se repite se escribe un bit 0. Las lecturas del Arduino
+ * llegan en décimas: si el valor y el anterior son décimas exactas y
+ * difieren en pocas décimas se escribe "10" y la diferencia en 4 bits.
+ * Si no, "11" y los bits significativos del XOR: reusando la ventana
+ * (ceros a la izquierda y a la derecha) del XOR anterior si cabe en ella
+ * (bit 0), o con una ventana nueva de 5 + 5 bits (bit 1).
+ */
+template <>
+struct CodecValores<float> {
+    /**
+     * @brief Valor y ventana anteriores
+     */
+    struct Estado {
+        unsigned int anterior;  ///< Bits del valor anterior
+        int cerosIzq;           ///< Ceros a la izquierda de la ventana vigente
+        int cerosDer;           ///< Ceros a la derecha de la ventana vigente
+        bool enDecimas;         ///< El valor anterior es una décima exacta
+        long long decimas;      ///< Valor anterior en décimas (si enDecimas)
+    };
+
+    static unsigned int bits(float valor) {
+        unsigned int b;
+        memcpy(&b, &valor, sizeof(b));
+        return b;
+    }
+
+    static float desdeBits(unsigned int b) {
+        float valor;
+        memcpy(&valor, &b, sizeof(valor));
+        return valor;
+    }
+
+    /**
+     * @brief Indica si valor es exactamente la conversión de decimas / 10 (como la haría from_chars)
+     */
+    static bool aDecimas(float valor, long long& decimas) {
+        if (!(valor > -1.0e6f && valor < 1.0e6f)) return false;
+        double escalado = static_cast<double>(valor) * 10.0;
+        decimas = static_cast<long long>(escalado < 0.0 ? escalado - 0.5 : escalado + 0.5);
+        return bits(static_cast<float>(decimas) / 10.0f) == bits(valor);  // Distingue -0 de 0
+    }
+
+    static void fijar(Estado& estado, unsigned int b) {
+        estado.anterior = b;
+        estado.enDecimas = aDecimas(desdeBits(b), estado.decimas);
+    }
+
+    static void codificar(EscritorBits& escritor, Estado& estado, float valor, int i) {
+        unsigned int actual = bits(valor);
+        if (i == 0) {
+            escritor.escribir(actual, 32);
+            estado.cerosIzq = 32;   // Sin ventana vigente
+            estado.cerosDer = 0;
+            fijar(estado, actual);
+            return;
+        }
+
+        unsigned int x = actual ^ estado.anterior;
+        if (x == 0) {
+            escritor.escribir(0, 1);
+            return;
+        }
+
+        long long decimas;
+        if (estado.enDecimas && aDecimas(valor, decimas)) {
+            unsigned long long z = zigzag(decimas - estado.decimas);
+            if (z < 16) {
+                escritor.escribir(2, 2);
+                escritor.escribir(z, 4);
+                estado.anterior = actual;
+                estado.decimas = decimas;
+                return;
+            }
+        }
+
+        escritor.escribir(3, 2);
+        int izq = __builtin_clz(x);
+        int der = __builtin_ctz(x);
+        if (izq >= estado.cerosIzq && der >= estado.cerosDer) {
+            escritor.escribir(0, 1);
+            escritor.escribir(x >> estado.cerosDer, 32 - estado.cerosIzq - estado.cerosDer);
+        } else {
+            int significativos = 32 - izq - der;
+            escritor.escribir(1, 1);
+            escritor.escribir(static_cast<unsigned long long>(izq), 5);
+            escritor.escribir(static_cast<unsigned long long>(significativos - 1), 5);
+            escritor.escribir(x >> der, significativos);
+            estado.cerosIzq = izq;
+            estado.cerosDer = der;
+        }
+        fijar(estado, actual);
+    }
+
+    static float decodificar(LectorBits& lector, Estado& estado, int i) {
+        if (i == 0) {
+            estado.cerosIzq = 32;
+            estado.cerosDer = 0;
+            fijar(estado, static_cast<unsigned int>(lector.leer(32)));
+        } else if (lector.leerBit()) {
+            if (!lector.leerBit()) {
+                estado.decimas += deszigzag(lector.leer(4));
+                estado.anterior = bits(static_cast<float>(estado.decimas) / 10.0f);
+            } else {
+                if (lector.leerBit()) {
+                    estado.cerosIzq = static_cast<int>(lector.leer(5));
+                    int significativos = static_cast<int>(lector.leer(5)) + 1;
+                    estado.cerosDer = 32 - estado.cerosIzq - significativos;
+                }
+                int significativos = 32 - estado.cerosIzq - estado.cerosDer;
+                unsigned int x = static_cast<unsigned int>(lector.leer(significativos)) << estado.cerosDer;
+                fijar(estado, estado.anterior ^ x);
+            }
+        }
+        return desdeBits(estado.anterior);
+    }
+};
+
+/**
+ * @brief Valores int con delta de deltas en zigzag (prefijo corto o varint)
+ *
+ * Una serie constante o que cambia a ritmo constante cuesta un bit por
+ * lectura; cambios de pocas unidades, seis.
+ */
+template <>
+struct CodecValores<int> {
+    /**
+     * @brief Valor y diferencia anteriores
+     */
+    struct Estado {
+        long long anterior;         ///< Valor anterior
+        long long deltaAnterior;    ///< Diferencia anterior
+    };
+
+    static void codificar(EscritorBits& escritor, Estado& estado, int valor, int i) {
+        long long actual = valor;
+        if (i == 0) {
+            escritor.escribirVarint(zigzag(actual));
+            estado.deltaAnterior = 0;
+        } else {
+            long long delta = actual - estado.anterior;
+            escribirPequenio(escritor, zigzag(delta - estado.deltaAnterior));
+            estado.deltaAnterior = delta;
+        }
+        estado.anterior = actual;
+    }
+
+    static int decodificar(LectorBits& lector, Estado& estado, int i) {
+        if (i == 0) {
+            estado.anterior = deszigzag(lector.leerVarint());
+            estado.deltaAnterior = 0;
+        } else {
+            estado.deltaAnterior += deszigzag(leerPequenio(lector));
+            estado.anterior += estado.deltaAnterior;
+        }
+        return static_cast<int>(estado.anterior);
+    }
+};
+
+/**
+ * @brief Codificación de las marcas de tiempo: delta de deltas con prefijos (Gorilla)
+ *
+ * La primera marca del bloque va completa (64 bits) y la segunda como
+ * delta en varint. Después, el delta de deltas en zigzag ocupa 1 bit si es
+ * 0 (muestreo regular), 7 bits si cabe en ±16 ms (la variación típica con
+ * el reloj grueso de relojMs) y 12, 16 o 68 bits si es mayor.
+ */
+struct CodecTiempos {
+    /**
+     * @brief Marca y diferencia anteriores
+     */
+    struct Estado {
+        long long anterior;         ///< Marca anterior
+        long long deltaAnterior;    ///< Diferencia anterior
+    };
+
+    static void codificar(EscritorBits& escritor, Estado& estado, long long tiempo, int i) {
+        if (i == 0) {
+            escritor.escribir(static_cast<unsigned long long>(tiempo), 64);
+            estado.deltaAnterior = 0;
+        } else if (i == 1) {
+            estado.deltaAnterior = tiempo - estado.anterior;
+            escritor.escribirVarint(zigzag(estado.deltaAnterior));
+        } else {
+            long long delta = tiempo - estado.anterior;
+            unsigned long long dd = zigzag(delta - estado.deltaAnterior);
+            if (dd == 0) {
+                escritor.escribir(0, 1);
+            } else if (dd < (1ULL << 5)) {
+                escritor.escribir(2, 2);
+                escritor.escribir(dd, 5);
+            } else if (dd < (1ULL << 9)) {
+                escritor.escribir(6, 3);
+                escritor.escribir(dd, 9);
+            } else if (dd < (1ULL << 12)) {
+                escritor.escribir(14, 4);
+                escritor.escribir(dd, 12);
+            } else {
+                escritor.escribir(15, 4);
+                escritor.escribir(dd, 64);
+            }
+            estado.deltaAnterior = delta;
+        }
+        estado.anterior = tiempo;
+    }
+
+    static long long decodificar(LectorBits& lector, Estado& estado, int i) {
+        if (i == 0) {
+            estado.anterior = static_cast<long long>(lector.leer(64));
+            estado.deltaAnterior = 0;
+            return estado.anterior;
+        }
+        if (i == 1) {
+            estado.deltaAnterior = deszigzag(lector.leerVarint());
+        } else {
+            unsigned long long dd = 0;
+            if (lector.leerBit()) {
+                if (!lector.leerBit()) {
+                    dd = lector.leer(5);
+                } else if (!lector.leerBit()) {
+                    dd = lector.leer(9);
+                } else if (!lector.leerBit()) {
+                    dd = lector.leer(12);
+                } else {
+                    dd = lector.leer(64);
+                }
+            }
+            estado.deltaAnterior += deszigzag(dd);
+        }
+        estado.anterior += estado.deltaAnterior;
+        return estado.anterior;
+    }
+};
+
+/**
+ * @brief Historial de lecturas con marca de tiempo, comprimido en bloques sellados
+ * @tparam T float (XOR tipo Gorilla) o int (delta de deltas + varint)
+ *
+ * Las lecturas se agregan al final en orden de tiempo y se codifican en el
+ * bloque abierto; al llegar a LECTURAS_POR_BLOQUE el bloque se sella: sus
+ * bits se copian a un arreglo del tamaño justo. Cada bloque guarda en su
+ * cabecera cantidad, primera y última marca, suma, mínimo y máximo, así que
+ * el promedio, los extremos y los resúmenes por intervalo sólo decodifican
+ * los bloques de los bordes; buscar salta los bloques cuyo rango no
+ * contiene el valor. El Iterador decodifica en flujo, sin descomprimir
+ * bloques completos en memoria.
+ *
+ * Con un límite de lecturas se descartan bloques sellados completos desde
+ * el más antiguo. Es el destino de las lecturas que la retención de
+ * ListaSensor saca del historial crudo.
+ *
+ * Sólo se comprime esa parte: el historial vivo de ListaSensor sigue en
+ * bloques crudos, porque eliminarMasBajo, el montículo y las búsquedas
+ * los modifican en su lugar. Sin retención con archivo (lecturasArchivo,
+ * --archivar en modo por lotes) no se comprime ninguna lectura.
+ */
+template <typename T>
+class ArchivoComprimido {
+    static_assert(std::is_same<T, float>::value || std::is_same<T, int>::value,
+                  "ArchivoComprimido sólo admite float o int");
+
+public:
+    /// Lecturas por bloque sellado
+    static constexpr int LECTURAS_POR_BLOQUE = 1024;
+
+private:
+    typedef CodecValores<T> Codec;
+
+    /**
+     * @brief Bloque de lecturas codificadas con su resumen
+     */
+    struct Bloque {
+        unsigned char* bytes;       ///< Bits sellados (nullptr mientras está abierto)
+        int numBytes;               ///< Bytes de bits sellados
+        int cantidad;               ///< Lecturas del bloque
+        long long tiempoInicial;    ///< Marca de la primera lectura
+        long long tiempoFinal;      ///< Marca de la última lectura
+        double suma;                ///< Suma de las lecturas
+        T minimo;                   ///< Mínimo del bloque
+        T maximo;                   ///< Máximo del bloque
+        Bloque* siguiente;          ///< Bloque más reciente
+    };
+
+    Bloque* cabeza;             ///< Bloque más antiguo
+    Bloque* cola;               ///< Bloque más reciente (abierto si colaAbierta)
+    bool colaAbierta;           ///< La cola aún admite lecturas
+    EscritorBits escritor;      ///< Bits del bloque abierto
+    typename Codec::Estado estadoValores;   ///< Estado del codificador de valores
+    CodecTiempos::Estado estadoTiempos;     ///< Estado del codificador de marcas
+
+    long long tamanio;          ///< Lecturas almacenadas
+    int numBloques;             ///< Bloques (incluido el abierto)
+    int maxLecturas;            ///< Límite de lecturas (0 = sin límite)
+    long long descartadas;      ///< Lecturas descartadas por el límite
+    long long bytesSellados;    ///< Bytes de los bloques sellados
+
+    double suma;                ///< Suma de todas las lecturas
+    mutable T minimo;           ///< Mínimo (válido si extremosValidos)
+    mutable T maximo;           ///< Máximo (válido si extremosValidos)
+    mutable bool extremosValidos;   ///< false si hay que recalcularlos con las cabeceras
+
+public:
+    /**
+     * @brief Recorrido en orden de las lecturas, decodificando en flujo
+     */
+    class Iterador {
+    private:
+        const ArchivoComprimido* archivo;   ///< Archivo recorrido
+        const Bloque* bloque;               ///< Bloque actual
+        LectorBits lector;                  ///< Posición en los bits del bloque
+        typename Codec::Estado estadoValores;   ///< Estado del decodificador de valores
+        CodecTiempos::Estado estadoTiempos;     ///< Estado del decodificador de marcas
+        int indice;                         ///< Siguiente lectura del bloque
+
+        void entrar(const Bloque* b) {
+            bloque = b;
+            indice = 0;
+            if (b != nullptr) {
+                lector = LectorBits(archivo->datosDe(b));
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructor
+         * @param archivo Archivo a recorrer
+         * @param inicio Primer bloque del recorrido
+         */
+        Iterador(const ArchivoComprimido* archivo, const Bloque* inicio)
+            : archivo(archivo), bloque(nullptr), estadoValores(), estadoTiempos(), indice(0) {
+            entrar(inicio);
+        }
+
+        /**
+         * @brief Decodifica la siguiente lectura
+         * @param valor Destino del valor
+         * @param tiempo Destino de la marca de tiempo
+         * @return false si no quedan lecturas
+         */
+        bool siguiente(T& valor, long long& tiempo) {
+            while (bloque != nullptr && indice == bloque->cantidad) {
+                entrar(bloque->siguiente);
+            }
+            if (bloque == nullptr) return false;
+            tiempo = CodecTiempos::decodificar(lector, estadoTiempos, indice);
+            valor = Codec::decodificar(lector, estadoValores, indice);
+            indice++;
+            return true;
+        }
+
+        /**
+         * @brief Salta, sin decodificarlo, el resto del bloque que contiene la siguiente lectura
+         */
+        void saltarBloque() {
+            while (bloque != nullptr && indice == bloque->cantidad) {
+                entrar(bloque->siguiente);
+            }
+            if (bloque != nullptr) entrar(bloque->siguiente);
+        }
+    };
+
+    /**
+     * @brief Constructor
+     * @param maxLecturas Límite de lecturas (0 = sin límite)
+     */
+    explicit ArchivoComprimido(int maxLecturas = 0)
+        : cabeza(nullptr), cola(nullptr), colaAbierta(false), estadoValores(), estadoTiempos(),
+          tamanio(0), numBloques(0), maxLecturas(maxLecturas), descartadas(0), bytesSellados(0),
+          suma(0.0), minimo(T()), maximo(T()), extremosValidos(true) {}
+
+    /**
+     * @brief Destructor
+     */
+    ~ArchivoComprimido() {
+        liberarTodo();
+    }
+
+    /**
+     * @brief Constructor de copia (Regla de los Tres): recodifica las lecturas
+     * @param otro Archivo a copiar
+     */
+    ArchivoComprimido(const ArchivoComprimido& otro)
+        : cabeza(nullptr), cola(nullptr), colaAbierta(false), estadoValores(), estadoTiempos(),
+          tamanio(0), numBloques(0), maxLecturas(otro.maxLecturas), descartadas(otro.descartadas),
+          bytesSellados(0), suma(0.0), minimo(T()), maximo(T()), extremosValidos(true) {
+        copiarDesde(otro);
+    }
+
+    /**
+     * @brief Operador de asignación (Regla de los Tres)
+     * @param otro Archivo a asignar
+     * @return Referencia a este archivo
+     */
+    ArchivoComprimido& operator=(const ArchivoComprimido& otro) {
+        if (this != &otro) {
+            liberarTodo();
+            maxLecturas = otro.maxLecturas;
+            descartadas = otro.descartadas;
+            copiarDesde(otro);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Agrega una lectura al final (O(1))
+     * @param valor Lectura
+     * @param tiempo Marca de tiempo (no menor que la última)
+     */
+    void agregar(T valor, long long tiempo) {
+        if (!colaAbierta) {
+            abrirBloque();
+        }
+        int i = cola->cantidad;
+        CodecTiempos::codificar(escritor, estadoTiempos, tiempo, i);
+        Codec::codificar(escritor, estadoValores, valor, i);
+
+        if (i == 0) {
+            cola->tiempoInicial = tiempo;
+            cola->minimo = valor;
+            cola->maximo = valor;
+        } else {
+            if (valor < cola->minimo) cola->minimo = valor;
+            if (cola->maximo < valor) cola->maximo = valor;
+        }
+        cola->tiempoFinal = tiempo;
+        cola->suma += valor;
+        cola->cantidad++;
+
+        if (tamanio == 0) {
+            minimo = valor;
+            maximo = valor;
+            extremosValidos = true;
+        } else if (extremosValidos) {
+            if (valor < minimo) minimo = valor;
+            if (maximo < valor) maximo = valor;
+        }
+        tamanio++;
+        suma += valor;
+
+        if (cola->cantidad == LECTURAS_POR_BLOQUE) {
+            sellar();
+        }
+        if (maxLecturas > 0) {
+            while (tamanio - cabeza->cantidad >= maxLecturas && cabeza != cola) {
+                descartarBloqueMasAntiguo();
+            }
+        }
+    }
+
+    /**
+     * @brief Cambia el límite de lecturas y lo aplica
+     * @param limite Lecturas máximas (0 = sin límite)
+     */
+    void setMaxLecturas(int limite) {
+        maxLecturas = limite;
+        if (maxLecturas > 0) {
+            while (cabeza != nullptr && cabeza != cola && tamanio - cabeza->cantidad >= maxLecturas) {
+                descartarBloqueMasAntiguo();
+            }
+        }
+    }
+
+    /**
+     * @brief Iterador al inicio del archivo
+     */
+    Iterador lecturas() const {
+        return Iterador(this, cabeza);
+    }
+
+    /**
+     * @brief Promedio de las lecturas (O(1))
+     */
+    T calcularPromedio() const {
+        if (tamanio == 0) return static_cast<T>(0);
+        return static_cast<T>(suma / static_cast<double>(tamanio));
+    }
+
+    /**
+     * @brief Suma de las lecturas
+     */
+    double getSuma() const {
+        return suma;
+    }
+
+    /**
+     * @brief Mínimo (0 si está vacío); tras descartar bloques se recalcula con las cabeceras
+     */
+    T getMinimo() const {
+        if (tamanio == 0) return static_cast<T>(0);
+        recalcularExtremos();
+        return minimo;
+    }
+
+    /**
+     * @brief Máximo (0 si está vacío)
+     */
+    T getMaximo() const {
+        if (tamanio == 0) return static_cast<T>(0);
+        recalcularExtremos();
+        return maximo;
+    }
+
+    /**
+     * @brief Varianza poblacional, decodificando en una sola pasada
+     */
+    double calcularVarianza() const {
+        if (tamanio == 0) return 0.0;
+        double media = suma / static_cast<double>(tamanio);
+        double acumulado = 0.0;
+        T valor;
+        long long tiempo;
+        for (Iterador it = lecturas(); it.siguiente(valor, tiempo);) {
+            double d = static_cast<double>(valor) - media;
+            acumulado += d * d;
+        }
+        return acumulado / static_cast<double>(tamanio);
+    }
+
+    /**
+     * @brief Busca un valor; sólo decodifica los bloques cuyo rango lo contiene
+     * @param buscado Valor a buscar
+     */
+    bool buscar(T buscado) const {
+        Iterador it = lecturas();
+        for (const Bloque* b = cabeza; b != nullptr; b = b->siguiente) {
+            if (buscado < b->minimo || b->maximo < buscado) {
+                it.saltarBloque();
+                continue;
+            }
+            T valor;
+            long long tiempo;
+            for (int i = 0; i < b->cantidad; i++) {
+                if (!it.siguiente(valor, tiempo)) return false;
+                if (valor == buscado) return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Conteo, suma, mínimo y máximo de las lecturas con marca en [t0, t1)
+     * @param t0 Inicio (ms, incluido)
+     * @param t1 Fin (ms, excluido)
+     *
+     * Los bloques completamente dentro del intervalo se resumen con su
+     * cabecera; sólo se decodifican los de los bordes.
+     */
+    ResumenVentana resumirRango(long long t0, long long t1) const {
+        ResumenVentana resumen;
+        if (t1 <= t0) return resumen;
+        Iterador it = lecturas();
+        for (const Bloque* b = cabeza; b != nullptr && b->tiempoInicial < t1; b = b->siguiente) {
+            if (b->tiempoFinal < t0) {
+                it.saltarBloque();
+                continue;
+            }
+            if (t0 <= b->tiempoInicial && b->tiempoFinal < t1) {
+                fusionar(resumen, b->cantidad, b->suma, static_cast<double>(b->minimo), static_cast<double>(b->maximo));
+                it.saltarBloque();
+                continue;
+            }
+            T valor;
+            long long tiempo;
+            for (int i = 0; i < b->cantidad; i++) {
+                if (!it.siguiente(valor, tiempo)) return resumen;
+                if (t0 <= tiempo && tiempo < t1) {
+                    double v = static_cast<double>(valor);
+                    fusionar(resumen, 1, v, v, v);
+                }
+            }
+        }
+        return resumen;
+    }
+
+    /**
+     * @brief Lecturas almacenadas
+     */
+    long long getTamanio() const {
+        return tamanio;
+    }
+
+    /**
+     * @brief Verifica si está vacío
+     */
+    bool estaVacio() const {
+        return tamanio == 0;
+    }
+
+    /**
+     * @brief Bloques (incluido el abierto)
+     */
+    int getNumeroBloques() const {
+        return numBloques;
+    }
+
+    /**
+     * @brief Lecturas descartadas por el límite
+     */
+    long long getDescartadas() const {
+        return descartadas;
+    }
+
+    /**
+     * @brief Marca de la lectura más antigua (0 si está vacío)
+     */
+    long long getPrimerTiempo() const {
+        return cabeza != nullptr ? cabeza->tiempoInicial : 0;
+    }
+
+    /**
+     * @brief Bytes ocupados: bits sellados, cabeceras y búfer del bloque abierto
+     */
+    long long memoriaUsada() const {
+        return bytesSellados + static_cast<long long>(numBloques) * static_cast<long long>(sizeof(Bloque))
+             + escritor.getCapacidad();
+    }
+
+private:
+    /**
+     * @brief Bits de un bloque (los del escritor si es el abierto)
+     */
+    const unsigned char* datosDe(const Bloque* b) const {
+        return b->bytes != nullptr ? b->bytes : escritor.getDatos();
+    }
+
+    /**
+     * @brief Incorpora los agregados de un bloque o una lectura a un resumen
+     */
+    static void fusionar(ResumenVentana& resumen, long long cantidad, double sumaParcial, double menor, double mayor) {
+        if (resumen.cantidad == 0) {
+            resumen.minimo = menor;
+            resumen.maximo = mayor;
+        } else {
+            if (menor < resumen.minimo) resumen.minimo = menor;
+            if (resumen.maximo < mayor) resumen.maximo = mayor;
+        }
+        resumen.cantidad += cantidad;
+        resumen.suma += sumaParcial;
+    }
+
+    /**
+     * @brief Enlaza un bloque vacío al final y lo deja abierto
+     */
+    void abrirBloque() {
+        Bloque* nuevo = new Bloque();
+        nuevo->bytes = nullptr;
+        nuevo->numBytes = 0;
+        nuevo->cantidad = 0;
+        nuevo->tiempoInicial = 0;
+        nuevo->tiempoFinal = 0;
+        nuevo->suma = 0.0;
+        nuevo->minimo = T();
+        nuevo->maximo = T();
+        nuevo->siguiente = nullptr;
+        if (cola == nullptr) {
+            cabeza = nuevo;
+        } else {
+            cola->siguiente = nuevo;
+        }
+        cola = nuevo;
+        colaAbierta = true;
+        numBloques++;
+    }
+
+    /**
+     * @brief Sella el bloque abierto: copia sus bits a un arreglo del tamaño justo
+     */
+    void sellar() {
+        cola->numBytes = escritor.getBytes();
+        cola->bytes = escritor.sellar();
+        bytesSellados += cola->numBytes;
+        colaAbierta = false;
+    }
+
+    /**
+     * @brief Libera el bloque más antiguo (debe estar sellado)
+     */
+    void descartarBloqueMasAntiguo() {
+        Bloque* viejo = cabeza;
+        cabeza = viejo->siguiente;
+        tamanio -= viejo->cantidad;
+        descartadas += viejo->cantidad;
+        suma -= viejo->suma;
+        if (!(minimo < viejo->minimo) || !(viejo->maximo < maximo)) {
+            extremosValidos = false;
+        }
+        bytesSellados -= viejo->numBytes;
+        delete[] viejo->bytes;
+        delete viejo;
+        numBloques--;
+    }
+
+    /**
+     * @brief Recalcula mínimo y máximo con las cabeceras de los bloques
+     */
+    void recalcularExtremos() const {
+        if (extremosValidos) return;
+        minimo = cabeza->minimo;
+        maximo = cabeza->maximo;
+        for (const Bloque* b = cabeza->siguiente; b != nullptr; b = b->siguiente) {
+            if (b->minimo < minimo) minimo = b->minimo;
+            if (maximo < b->maximo) maximo = b->maximo;
+        }
+        extremosValidos = true;
+    }
+
+    /**
+     * @brief Agrega las lecturas de otro archivo (recodificándolas)
+     */
+    void copiarDesde(const ArchivoComprimido& otro) {
+        int limite = maxLecturas;
+        maxLecturas = 0;
+        T valor;
+        long long tiempo;
+        for (Iterador it = otro.lecturas(); it.siguiente(valor, tiempo);) {
+            agregar(valor, tiempo);
+        }
+        maxLecturas = limite;
+    }
+
+    /**
+     * @brief Libera todos los bloques
+     */
+    void liberarTodo() {
+        while (cabeza != nullptr) {
+            Bloque* siguiente = cabeza->siguiente;
+            delete[] cabeza->bytes;
+            delete cabeza;
+            cabeza = siguiente;
+        }
+        cola = nullptr;
+        if (colaAbierta) {
+            delete[] escritor.sellar();
+            colaAbierta = false;
+        }
+        tamanio = 0;
+        numBloques = 0;
+        bytesSellados = 0;
+        suma = 0.0;
+        extremosValidos = true;
+    }
+};
+
+#endif // ARCHIVO_COMPRIMIDO_H
@@ -0,0 +1,135 @@
+/**
+ * @file ColaAcotada.h
+ * @brief Cola acotada sin bloqueos para varios productores y consumidores
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef COLA_ACOTADA_H
+#define COLA_ACOTADA_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Cola circular de capacidad fija sin bloqueos (MPMC)
+ * @tparam T Tipo de elemento (copiable)
+ *
+ * Cada celda lleva un número de secuencia que indica si está lista para
+ * escribirse o para leerse, de modo que productores y consumidores sólo
+ * compiten por un contador atómico y nunca toman un mutex. Si la cola
+ * está llena encolar() devuelve false en lugar de esperar.
+ */
+template <typename T>
+class ColaAcotada {
+private:
+    /**
+     * @brief Celda de la cola con su número de secuencia
+     */
+    struct Celda {
+        std::atomic<size_t> secuencia;  ///< Estado de la celda
+        T dato;                         ///< Elemento almacenado
+    };
+
+    Celda* celdas;                                  ///< Arreglo circular de celdas
+    size_t mascara;                                 ///< capacidad - 1 (capacidad potencia de 2)
+    alignas(64) std::atomic<size_t> posEncolar;     ///< Próxima posición de escritura
+    alignas(64) std::atomic<size_t> posDesencolar;  ///< Próxima posición de lectura
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidad Número de celdas (se redondea a potencia de 2)
+     */
+    explicit ColaAcotada(size_t capacidad) : celdas(nullptr), mascara(0), posEncolar(0), posDesencolar(0) {
+        size_t cap = 2;
+        while (cap < capacidad) {
+            cap *= 2;
+        }
+        mascara = cap - 1;
+        celdas = new Celda[cap];
+        for (size_t i = 0; i < cap; i++) {
+            celdas[i].secuencia.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Destructor: libera las celdas
+     */
+    ~ColaAcotada() {
+        delete[] celdas;
+    }
+
+    ColaAcotada(const ColaAcotada&) = delete;               ///< No copiable
+    ColaAcotada& operator=(const ColaAcotada&) = delete;    ///< No asignable
+
+    /**
+     * @brief Agrega un elemento al final de la cola
+     * @param valor Elemento a copiar en la cola
+     * @return false si la cola está llena
+     */
+    bool encolar(const T& valor) {
+        size_t pos = posEncolar.load(std::memory_order_relaxed);
+        while (true) {
+            Celda& celda = celdas[pos & mascara];
+            size_t sec = celda.secuencia.load(std::memory_order_acquire);
+            long long diferencia = static_cast<long long>(sec) - static_cast<long long>(pos);
+            if (diferencia == 0) {
+                if (posEncolar.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    celda.dato = valor;
+                    celda.secuencia.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diferencia < 0) {
+                return false;
+            } else {
+                pos = posEncolar.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Extrae el elemento más antiguo de la cola
+     * @param valor Destino del elemento extraído
+     * @return false si la cola está vacía
+     */
+    bool desencolar(T& valor) {
+        size_t pos = posDesencolar.load(std::memory_order_relaxed);
+        while (true) {
+            Celda& celda = celdas[pos & mascara];
+            size_t sec = celda.secuencia.load(std::memory_order_acquire);
+            long long diferencia = static_cast<long long>(sec) - static_cast<long long>(pos + 1);
+            if (diferencia == 0) {
+                if (posDesencolar.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    valor = celda.dato;
+                    celda.secuencia.store(pos + mascara + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diferencia < 0) {
+                return false;
+            } else {
+                pos = posDesencolar.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Número aproximado de elementos en la cola
+     * @return Elementos encolados (puede variar en concurrencia)
+     */
+    size_t tamanioAproximado() const {
+        size_t e = posEncolar.load(std::memory_order_relaxed);
+        size_t d = posDesencolar.load(std::memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+
+    /**
+     * @brief Capacidad de la cola
+     * @return Número de celdas
+     */
+    size_t capacidad() const {
+        return mascara + 1;
+    }
+};
+
+#endif // COLA_ACOTADA_H
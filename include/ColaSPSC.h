@@ -0,0 +1,102 @@
+/**
+ * @file ColaSPSC.h
+ * @brief Cola circular acotada para un productor y un consumidor
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef COLA_SPSC_H
+#define COLA_SPSC_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Cola circular sin bloqueos para exactamente un hilo productor y uno consumidor
+ * @tparam T Tipo de elemento (copiable)
+ *
+ * Cada índice lo escribe un solo hilo, así que basta con cargas y
+ * almacenamientos atómicos (sin compare-and-swap). Cada extremo guarda
+ * una copia del índice contrario para no leer la línea de caché ajena
+ * en cada operación.
+ */
+template <typename T>
+class ColaSPSC {
+private:
+    T* elementos;                                   ///< Arreglo circular
+    size_t mascara;                                 ///< capacidad - 1 (potencia de 2)
+    alignas(64) std::atomic<size_t> cabeza;         ///< Próxima posición a leer (consumidor)
+    size_t colaVista;                               ///< Copia de cola vista por el consumidor
+    alignas(64) std::atomic<size_t> cola;           ///< Próxima posición a escribir (productor)
+    size_t cabezaVista;                             ///< Copia de cabeza vista por el productor
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidad Número de elementos (se redondea a potencia de 2)
+     */
+    explicit ColaSPSC(size_t capacidad) : elementos(nullptr), mascara(0), cabeza(0), colaVista(0), cola(0), cabezaVista(0) {
+        size_t cap = 2;
+        while (cap < capacidad) {
+            cap *= 2;
+        }
+        mascara = cap - 1;
+        elementos = new T[cap];
+    }
+
+    /**
+     * @brief Destructor: libera el arreglo
+     */
+    ~ColaSPSC() {
+        delete[] elementos;
+    }
+
+    ColaSPSC(const ColaSPSC&) = delete;             ///< No copiable
+    ColaSPSC& operator=(const ColaSPSC&) = delete;  ///< No asignable
+
+    /**
+     * @brief Agrega un elemento (sólo desde el hilo productor)
+     * @param valor Elemento a copiar
+     * @return false si la cola está llena
+     */
+    bool encolar(const T& valor) {
+        size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabezaVista > mascara) {
+            cabezaVista = cabeza.load(std::memory_order_acquire);
+            if (c - cabezaVista > mascara) {
+                return false;
+            }
+        }
+        elementos[c & mascara] = valor;
+        cola.store(c + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Extrae el elemento más antiguo (sólo desde el hilo consumidor)
+     * @param valor Destino del elemento
+     * @return false si la cola está vacía
+     */
+    bool desencolar(T& valor) {
+        size_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == colaVista) {
+            colaVista = cola.load(std::memory_order_acquire);
+            if (h == colaVista) {
+                return false;
+            }
+        }
+        valor = elementos[h & mascara];
+        cabeza.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Capacidad de la cola
+     * @return Número de elementos que caben
+     */
+    size_t capacidad() const {
+        return mascara + 1;
+    }
+};
+
+#endif // COLA_SPSC_H
@@ -0,0 +1,183 @@
+/**
+ * @file DiarioLecturas.h
+ * @brief Diario de escritura anticipada (WAL) de las lecturas aceptadas
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef DIARIO_LECTURAS_H
+#define DIARIO_LECTURAS_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "TablaNombres.h"
+
+class MotorIngesta;
+
+/**
+ * @brief Parámetros del diario
+ */
+struct ConfiguracionDiario {
+    int intervaloMs;        ///< Espera máxima de una lectura en memoria antes de escribirse (ms, mínimo 1)
+    bool sincronizar;       ///< fsync en cada grupo (si no, el sistema decide cuándo llega al disco)
+    int tamBuffer;          ///< Bytes de cada uno de los dos búferes
+
+    /**
+     * @brief Constructor con valores por defecto
+     */
+    ConfiguracionDiario() : intervaloMs(10), sincronizar(true), tamBuffer(1 << 20) {}
+};
+
+/**
+ * @brief Contadores del diario
+ */
+struct EstadisticasDiario {
+    long long lecturas;         ///< Lecturas registradas
+    long long grupos;           ///< Grupos escritos (una escritura y a lo sumo un fsync cada uno)
+    long long bytes;            ///< Bytes escritos al archivo
+    long long sincronizaciones; ///< Llamadas a fsync
+    long long esperas;          ///< Veces que un productor esperó por un búfer lleno
+};
+
+/**
+ * @brief Registro binario de sólo agregado con confirmación en grupo
+ *
+ * Cada lectura aceptada se copia como registro binario de tamaño fijo
+ * (tipo, IdNombre, valor, marca) al búfer activo bajo un mutex: no hay
+ * llamada al sistema por lectura. Como los IdNombre sólo valen dentro de
+ * un proceso, la primera vez que aparece un id en la sesión se antepone
+ * un registro con su nombre. Un hilo escritor intercambia el búfer
+ * activo con el de escritura cada intervaloMs (o antes si se llena a la
+ * mitad) y lo escribe como un grupo: longitud, CRC-32 y registros. Con sincronizar
+ * se hace un fsync por grupo, así que una caída pierde a lo sumo las
+ * lecturas del último intervalo. Si el escritor se atrasa y el búfer se
+ * llena, los productores esperan (contrapresión) en lugar de crecer sin
+ * límite.
+ *
+ * Al abrir se escribe un registro de inicio con el reloj monotónico y la
+ * hora de pared; reproducir() traslada las marcas de cada tramo al reloj
+ * del proceso actual conservando su antigüedad real y traduce sus ids a
+ * los de la tabla de nombres actual. Un grupo incompleto o con CRC
+ * inválido al final (caída a media escritura) se descarta y el archivo
+ * se recorta ahí, para que lo que se agregue después sea legible.
+ */
+class DiarioLecturas {
+private:
+    ConfiguracionDiario config;     ///< Parámetros
+    int fd;                         ///< Descriptor del archivo (-1 si cerrado)
+
+    mutable std::mutex mutex;       ///< Protege búferes, contadores y banderas
+    std::condition_variable avisoEscritor;  ///< Despierta al hilo escritor
+    std::condition_variable avisoLibre;     ///< Despierta a productores y a confirmar()
+    std::thread hiloEscritor;       ///< Escribe los grupos
+
+    char* activo;                   ///< Búfer que reciben los productores
+    char* enEscritura;              ///< Búfer que escribe el hilo escritor
+    int usados;                     ///< Bytes ocupados en activo
+    unsigned long long gruposCerrados;  ///< Grupos entregados al escritor
+    unsigned long long gruposDurables;  ///< Grupos ya escritos (y sincronizados si aplica)
+    bool confirmarPedido;           ///< Alguien espera en confirmar()
+    bool detener;                   ///< El escritor debe vaciar y salir
+    bool fallo;                     ///< Una escritura falló (el diario dejó de ser durable)
+    unsigned char* definidos;       ///< definidos[id] != 0 si el nombre del id ya está en el archivo
+    IdNombre capacidadDefinidos;    ///< Casillas de definidos
+    EstadisticasDiario stats;       ///< Contadores
+
+    /**
+     * @brief Bucle del hilo escritor
+     */
+    void bucleEscritor();
+
+    /**
+     * @brief Copia un registro al búfer activo (espera si está lleno)
+     * @param registro Bytes del registro
+     * @param longitud Tamaño del registro
+     * @param lecturas 1 si el registro es una lectura, 0 si no
+     * @param id Id cuyo nombre debe preceder al registro, o TablaNombres::NINGUNO
+     */
+    void agregar(const char* registro, int longitud, int lecturas, IdNombre id = TablaNombres::NINGUNO);
+
+    /**
+     * @brief Anota que el nombre de un id ya está en el archivo (sólo bajo el mutex)
+     * @param id Id definido
+     */
+    void marcarDefinido(IdNombre id);
+
+public:
+    /**
+     * @brief Constructor (no abre ningún archivo)
+     * @param configuracion Parámetros del diario
+     */
+    explicit DiarioLecturas(const ConfiguracionDiario& configuracion = ConfiguracionDiario());
+
+    /**
+     * @brief Destructor: escribe lo pendiente y cierra
+     */
+    ~DiarioLecturas();
+
+    DiarioLecturas(const DiarioLecturas&) = delete;             ///< No copiable
+    DiarioLecturas& operator=(const DiarioLecturas&) = delete;  ///< No asignable
+
+    /**
+     * @brief Abre (o crea) el archivo para agregar y arranca el hilo escritor
+     * @param ruta Archivo del diario
+     * @return false si no se pudo abrir
+     *
+     * Para recuperar lo registrado en una ejecución anterior, llamar antes
+     * a reproducir(), que además recorta un final dañado.
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Registra una lectura aceptada
+     * @param tipo 'T' o 'P'
+     * @param id Id internado del sensor
+     * @param valorFloat Valor si tipo == 'T'
+     * @param valorEntero Valor si tipo == 'P'
+     * @param tiempo Marca de tiempo en ms de relojMs
+     */
+    void registrar(char tipo, IdNombre id, float valorFloat, int valorEntero, long long tiempo);
+
+    /**
+     * @brief Registra la creación de un sensor sin lecturas (p. ej. desde el menú)
+     * @param tipo 'T' o 'P'
+     * @param nombre Nombre del sensor
+     */
+    void registrarSensor(char tipo, const char* nombre);
+
+    /**
+     * @brief Espera a que todo lo registrado hasta ahora sea durable
+     * @return false si alguna escritura falló
+     */
+    bool confirmar();
+
+    /**
+     * @brief Escribe lo pendiente, detiene el hilo escritor y cierra el archivo
+     */
+    void cerrar();
+
+    /**
+     * @brief Indica si el diario está abierto
+     */
+    bool estaAbierto() const;
+
+    /**
+     * @brief Copia de los contadores
+     */
+    EstadisticasDiario estadisticas() const;
+
+    /**
+     * @brief Vuelve a registrar en el motor todas las lecturas de un diario
+     * @param ruta Archivo del diario
+     * @param motor Motor que recibe las lecturas (crea los sensores que falten)
+     * @param lecturas Destino opcional del número de lecturas reproducidas
+     * @return false si el archivo no existe o no se pudo leer
+     *
+     * El motor no debe tener este diario asignado (las lecturas se
+     * duplicarían en él).
+     */
+    static bool reproducir(const char* ruta, MotorIngesta& motor, long long* lecturas = nullptr);
+};
+
+#endif // DIARIO_LECTURAS_H
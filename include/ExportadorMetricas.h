@@ -0,0 +1,154 @@
+/**
+ * @file ExportadorMetricas.h
+ * @brief Exportación de las métricas en formato de texto de Prometheus
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef EXPORTADOR_METRICAS_H
+#define EXPORTADOR_METRICAS_H
+
+#include <cstddef>
+
+class ListaGeneral;
+struct ResumenMetricas;
+
+/**
+ * @brief Escribe las métricas como texto de Prometheus en un archivo o un socket Unix
+ *
+ * Con un archivo, cada intervaloMs se genera el texto completo y se
+ * reemplaza el archivo con un rename atómico (lo que espera el textfile
+ * collector de node_exporter). Con "unix:RUTA" se escucha en un socket
+ * Unix y a cada conexión se le responde con las métricas del momento en
+ * una respuesta HTTP mínima, así que basta
+ * curl --unix-socket RUTA http://localhost/metrics.
+ *
+ * El exportador no tiene hilo propio: lo atiende revisar(), que el bucle
+ * de ingesta llama entre bloques. Las métricas por sensor (lecturas,
+ * antigüedad de la última, nodos y memoria del historial) recorren la
+ * lista, así que sólo se incluyen si revisar() recibe la lista desde el
+ * hilo que la modifica; los contadores y las latencias de Metricas se
+ * pueden exportar desde cualquier hilo.
+ */
+class ExportadorMetricas {
+private:
+    const char* destino;        ///< Ruta del archivo o del socket
+    bool esSocket;              ///< destino es un socket Unix
+    int intervaloMs;            ///< Periodo de escritura del archivo (ms)
+    long long proximaMs;        ///< relojMs() de la siguiente revisión
+    int fdSocket;               ///< Socket que escucha (-1 si no hay)
+    bool iniciado;              ///< iniciar() tuvo éxito
+
+    char* texto;                ///< Última exposición generada
+    size_t tamTexto;            ///< Bytes en texto
+    size_t capTexto;            ///< Capacidad de texto
+    ResumenMetricas* resumen;   ///< Suma de los hilos (se reutiliza)
+    long long exportaciones;    ///< Archivos escritos o respuestas enviadas
+
+    /**
+     * @brief Agrega texto con formato de printf
+     * @param formato Formato
+     */
+    void agregar(const char* formato, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    /**
+     * @brief Agrega un nombre de sensor como valor de etiqueta (con escapes)
+     * @param nombre Nombre del sensor
+     */
+    void agregarEtiqueta(const char* nombre);
+
+    /**
+     * @brief Encabezado HELP/TYPE de una familia de métricas
+     * @param nombre Nombre de la métrica
+     * @param tipo counter, gauge o histogram
+     * @param ayuda Descripción
+     */
+    void agregarFamilia(const char* nombre, const char* tipo, const char* ayuda);
+
+    /**
+     * @brief Genera la exposición completa en texto
+     * @param lista Lista para las métricas por sensor, o nullptr para omitirlas
+     */
+    void generar(const ListaGeneral* lista);
+
+    /**
+     * @brief Genera las familias de métricas por sensor y los totales de memoria
+     * @param lista Lista de sensores
+     */
+    void generarSensores(const ListaGeneral& lista);
+
+    /**
+     * @brief Genera el histograma y los cuantiles de las latencias
+     */
+    void generarLatencias();
+
+    /**
+     * @brief Reemplaza el archivo destino con el texto generado
+     * @return false si no se pudo escribir
+     */
+    bool escribirArchivo();
+
+    /**
+     * @brief Responde a las conexiones pendientes del socket
+     * @param lista Lista para las métricas por sensor, o nullptr
+     */
+    void atenderClientes(const ListaGeneral* lista);
+
+public:
+    /// Prefijo del destino que indica un socket Unix
+    static constexpr const char* PREFIJO_SOCKET = "unix:";
+    /// Cada cuánto se aceptan conexiones del socket (ms)
+    static const int SONDEO_SOCKET_MS = 50;
+
+    /**
+     * @brief Constructor (no abre nada)
+     * @param destino Archivo o "unix:RUTA" (debe vivir tanto como el exportador); nullptr = inactivo
+     * @param intervaloMs Periodo de escritura del archivo (ms)
+     */
+    ExportadorMetricas(const char* destino, int intervaloMs);
+
+    /**
+     * @brief Destructor: cierra y elimina el socket
+     */
+    ~ExportadorMetricas();
+
+    ExportadorMetricas(const ExportadorMetricas&) = delete;             ///< No copiable
+    ExportadorMetricas& operator=(const ExportadorMetricas&) = delete;  ///< No asignable
+
+    /**
+     * @brief Abre el socket (si aplica) y activa la recolección de Metricas
+     * @return false si el socket no se pudo crear o no está disponible en la plataforma
+     */
+    bool iniciar();
+
+    /**
+     * @brief Escribe el archivo si venció el intervalo o atiende el socket
+     * @param lista Lista para las métricas por sensor (sólo desde el hilo que la modifica), o nullptr
+     *
+     * Si no hay nada que hacer cuesta una lectura del reloj grueso.
+     */
+    void revisar(const ListaGeneral* lista);
+
+    /**
+     * @brief Escribe el archivo ahora (p. ej. al terminar la ingesta)
+     * @param lista Lista para las métricas por sensor, o nullptr
+     * @return false si no se pudo escribir; con un socket, sólo atiende las conexiones pendientes
+     */
+    bool exportar(const ListaGeneral* lista);
+
+    /**
+     * @brief Archivos escritos o respuestas enviadas
+     */
+    long long getExportaciones() const;
+
+    /**
+     * @brief Destino configurado (nullptr si está inactivo)
+     */
+    const char* getDestino() const;
+};
+
+#endif // EXPORTADOR_METRICAS_H
@@ -0,0 +1,217 @@
+/**
+ * @file FlujoBits.h
+ * @brief Escritura y lectura de secuencias de bits para los historiales comprimidos
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef FLUJO_BITS_H
+#define FLUJO_BITS_H
+
+#include <cstring>
+
+/**
+ * @brief Convierte un entero con signo en uno sin signo de magnitud parecida (zigzag)
+ *
+ * 0, -1, 1, -2, 2... pasan a 0, 1, 2, 3, 4..., así los valores pequeños
+ * de cualquier signo ocupan pocos bits.
+ */
+inline unsigned long long zigzag(long long v) {
+    return (static_cast<unsigned long long>(v) << 1) ^ static_cast<unsigned long long>(v >> 63);
+}
+
+/**
+ * @brief Inversa de zigzag()
+ */
+inline long long deszigzag(unsigned long long u) {
+    return static_cast<long long>(u >> 1) ^ -static_cast<long long>(u & 1);
+}
+
+/**
+ * @brief Escritor de bits sobre un arreglo de bytes que crece al doble
+ *
+ * Los bits se escriben del más significativo al menos significativo. El
+ * arreglo siempre refleja todo lo escrito, de modo que un LectorBits puede
+ * recorrerlo mientras el escritor sigue abierto.
+ */
+class EscritorBits {
+private:
+    unsigned char* bytes;   ///< Datos escritos (bytes completos y el último parcial)
+    long long numBits;      ///< Bits escritos
+    int capacidad;          ///< Bytes reservados
+
+    /**
+     * @brief Garantiza espacio para nBytes bytes
+     */
+    void asegurar(int nBytes) {
+        if (nBytes <= capacidad) return;
+        int nueva = capacidad > 0 ? capacidad * 2 : 64;
+        while (nueva < nBytes) nueva *= 2;
+        unsigned char* nuevos = new unsigned char[nueva];
+        if (capacidad > 0) {
+            memcpy(nuevos, bytes, capacidad);
+        }
+        memset(nuevos + capacidad, 0, nueva - capacidad);
+        delete[] bytes;
+        bytes = nuevos;
+        capacidad = nueva;
+    }
+
+public:
+    /**
+     * @brief Constructor (no reserva memoria)
+     */
+    EscritorBits() : bytes(nullptr), numBits(0), capacidad(0) {}
+
+    /**
+     * @brief Destructor
+     */
+    ~EscritorBits() {
+        delete[] bytes;
+    }
+
+    EscritorBits(const EscritorBits&) = delete;             ///< No copiable
+    EscritorBits& operator=(const EscritorBits&) = delete;  ///< No asignable
+
+    /**
+     * @brief Escribe los n bits menos significativos de valor
+     * @param valor Bits a escribir
+     * @param n Número de bits (0 a 64)
+     */
+    void escribir(unsigned long long valor, int n) {
+        if (n == 0) return;
+        asegurar(static_cast<int>((numBits + n + 7) / 8));
+        if (n < 64) {
+            valor &= (1ULL << n) - 1;
+        }
+        while (n > 0) {
+            int libres = 8 - static_cast<int>(numBits & 7);
+            int tramo = n < libres ? n : libres;
+            unsigned int bits = static_cast<unsigned int>((valor >> (n - tramo)) & ((1u << tramo) - 1));
+            bytes[numBits >> 3] |= static_cast<unsigned char>(bits << (libres - tramo));
+            numBits += tramo;
+            n -= tramo;
+        }
+    }
+
+    /**
+     * @brief Escribe un entero sin signo en grupos de 7 bits (varint)
+     * @param valor Entero a escribir
+     *
+     * Cada grupo va precedido de un bit de continuación: los valores
+     * menores que 128 ocupan 8 bits.
+     */
+    void escribirVarint(unsigned long long valor) {
+        while (valor >= 0x80) {
+            escribir(0x80 | (valor & 0x7F), 8);
+            valor >>= 7;
+        }
+        escribir(valor, 8);
+    }
+
+    /**
+     * @brief Bits escritos
+     */
+    long long getBits() const {
+        return numBits;
+    }
+
+    /**
+     * @brief Bytes ocupados por los bits escritos
+     */
+    int getBytes() const {
+        return static_cast<int>((numBits + 7) / 8);
+    }
+
+    /**
+     * @brief Bytes reservados
+     */
+    int getCapacidad() const {
+        return capacidad;
+    }
+
+    /**
+     * @brief Acceso de solo lectura a los datos
+     */
+    const unsigned char* getDatos() const {
+        return bytes;
+    }
+
+    /**
+     * @brief Copia los datos a un arreglo del tamaño justo y reinicia el escritor
+     * @return Arreglo de getBytes() bytes reservado con new[] (lo libera quien llama)
+     *
+     * Conserva la memoria reservada para el siguiente uso.
+     */
+    unsigned char* sellar() {
+        int n = getBytes();
+        unsigned char* exactos = new unsigned char[n > 0 ? n : 1];
+        if (n > 0) {
+            memcpy(exactos, bytes, n);
+            memset(bytes, 0, n);
+        }
+        numBits = 0;
+        return exactos;
+    }
+};
+
+/**
+ * @brief Lector de bits escritos por EscritorBits
+ */
+class LectorBits {
+private:
+    const unsigned char* bytes;     ///< Datos
+    long long pos;                  ///< Siguiente bit a leer
+
+public:
+    /**
+     * @brief Constructor
+     * @param datos Bytes a leer (nullptr para un lector vacío)
+     */
+    explicit LectorBits(const unsigned char* datos = nullptr) : bytes(datos), pos(0) {}
+
+    /**
+     * @brief Lee n bits como entero sin signo
+     * @param n Número de bits (0 a 64)
+     */
+    unsigned long long leer(int n) {
+        unsigned long long valor = 0;
+        while (n > 0) {
+            int disponibles = 8 - static_cast<int>(pos & 7);
+            int tramo = n < disponibles ? n : disponibles;
+            unsigned int byte = bytes[pos >> 3];
+            unsigned int bits = (byte >> (disponibles - tramo)) & ((1u << tramo) - 1);
+            valor = (valor << tramo) | bits;
+            pos += tramo;
+            n -= tramo;
+        }
+        return valor;
+    }
+
+    /**
+     * @brief Lee un bit
+     */
+    bool leerBit() {
+        unsigned int byte = bytes[pos >> 3];
+        bool bit = ((byte >> (7 - (pos & 7))) & 1u) != 0;
+        pos++;
+        return bit;
+    }
+
+    /**
+     * @brief Lee un entero escrito con escribirVarint
+     */
+    unsigned long long leerVarint() {
+        unsigned long long valor = 0;
+        int desplazamiento = 0;
+        while (true) {
+            unsigned long long grupo = leer(8);
+            valor |= (grupo & 0x7F) << desplazamiento;
+            if ((grupo & 0x80) == 0) break;
+            desplazamiento += 7;
+        }
+        return valor;
+    }
+};
+
+#endif // FLUJO_BITS_H
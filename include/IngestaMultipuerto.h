@@ -0,0 +1,198 @@
+/**
+ * @file IngestaMultipuerto.h
+ * @brief Ingesta de varios puertos seriales en un solo hilo con epoll
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef INGESTA_MULTIPUERTO_H
+#define INGESTA_MULTIPUERTO_H
+
+#include "ListaGeneral.h"
+#include "MotorIngesta.h"
+#include "SerialReader.h"
+
+class DiarioLecturas;
+
+/**
+ * @brief Contadores de un puerto de la ingesta multipuerto
+ */
+struct EstadisticasPuerto {
+    const char* ruta;               ///< Dispositivo, FIFO o archivo
+    bool abierto;                   ///< El puerto sigue entregando datos
+    long long eventos;              ///< Veces que el puerto estuvo listo para leer
+    long long llamadasLectura;      ///< Llamadas al sistema de lectura
+    EstadisticasIngesta ingesta;    ///< Bytes, lecturas, sensores creados, conflictos
+    EstadisticasParseo parseo;      ///< Líneas y errores del puerto
+};
+
+/**
+ * @brief Multiplexa varios puertos seriales hacia una sola ListaGeneral
+ *
+ * Cada puerto se abre en modo no bloqueante y se registra en epoll (poll
+ * en otros sistemas POSIX). Un solo hilo espera a que alguno tenga datos
+ * y lee sólo de los que están listos, así que no hace falta un hilo
+ * bloqueado por puerto y un puerto con ráfagas no retrasa a los demás:
+ * cada vez que un puerto está listo se leen a lo sumo LECTURAS_POR_EVENTO
+ * bloques y el resto queda para la siguiente vuelta (epoll por nivel).
+ *
+ * Cada puerto tiene su propio MotorIngesta, es decir, su propio búfer de
+ * reensamblado de líneas y tramas y sus propios contadores; todos
+ * registran en la misma ListaGeneral. Como todo ocurre en un hilo, la
+ * lista no necesita candados.
+ *
+ * Los archivos normales no se pueden registrar en epoll: se leen en cada
+ * vuelta hasta su fin, como si siempre estuvieran listos. Un FIFO se abre
+ * en modo bloqueante (espera a su escritor) y después se pasa a no
+ * bloqueante. En Windows la ingesta multipuerto no está disponible.
+ */
+class IngestaMultipuerto {
+private:
+    /**
+     * @brief Estado de un puerto
+     */
+    struct Puerto {
+        const char* ruta;           ///< Ruta con la que se abrió
+        SerialReader lector;        ///< Dispositivo en modo no bloqueante
+        MotorIngesta motor;         ///< Reensamblado y contadores del puerto
+        bool abierto;               ///< Aún no llega el fin de datos
+        bool siempreListo;          ///< No admite epoll/poll (archivo normal)
+        long long eventos;          ///< Veces que estuvo listo
+
+        /**
+         * @brief Constructor
+         * @param ruta Ruta del puerto
+         * @param lista Lista destino del motor
+         */
+        Puerto(const char* ruta, ListaGeneral& lista)
+            : ruta(ruta), lector(), motor(lista), abierto(false), siempreListo(false), eventos(0) {}
+    };
+
+public:
+    /// Puertos como máximo
+    static const int MAX_PUERTOS = 64;
+    /// Bytes de cada lectura del dispositivo
+    static const int TAM_BLOQUE = 64 * 1024;
+    /// Bloques que se leen como máximo de un puerto por evento
+    static const int LECTURAS_POR_EVENTO = 4;
+
+private:
+    ListaGeneral& lista;        ///< Lista destino compartida
+    Puerto* puertos[MAX_PUERTOS];   ///< Puertos agregados
+    int numPuertos;             ///< Puertos en el arreglo
+    int abiertos;               ///< Puertos que aún no terminan
+    int siempreListos;          ///< Puertos abiertos que no admiten epoll/poll
+    int fdEventos;              ///< Descriptor de epoll (-1 si no se usa)
+    char* bloque;               ///< Búfer de lectura compartido (un solo hilo)
+
+    PoliticaRetencion retencion;    ///< Retención de los sensores que se crean
+    FormatoFlujo formato;           ///< Formatos aceptados en todos los puertos
+    DiarioLecturas* diario;         ///< Diario de las lecturas aceptadas (opcional)
+
+    /**
+     * @brief Lee de un puerto listo y alimenta su motor
+     * @param puerto Puerto con datos
+     * @param colgado epoll/poll indicó que el otro extremo se cerró
+     *
+     * Una terminal colgada devuelve 0 bytes en lugar de fin de archivo: si
+     * el puerto está colgado y ya no entrega datos, se cierra.
+     */
+    void leerPuerto(Puerto* puerto, bool colgado);
+
+    /**
+     * @brief Cierra un puerto al llegar su fin de datos
+     * @param puerto Puerto terminado
+     */
+    void cerrarPuerto(Puerto* puerto);
+
+public:
+    /**
+     * @brief Constructor
+     * @param lista Lista de gestión donde se registran las lecturas de todos los puertos
+     */
+    explicit IngestaMultipuerto(ListaGeneral& lista);
+
+    /**
+     * @brief Destructor: cierra los puertos y el descriptor de epoll
+     */
+    ~IngestaMultipuerto();
+
+    IngestaMultipuerto(const IngestaMultipuerto&) = delete;             ///< No copiable
+    IngestaMultipuerto& operator=(const IngestaMultipuerto&) = delete;  ///< No asignable
+
+    /**
+     * @brief Abre un puerto y lo agrega al conjunto vigilado
+     * @param ruta Dispositivo, pty, FIFO o archivo (debe vivir mientras dure la ingesta)
+     * @param baudios Velocidad si es un puerto serial
+     * @return false si no se pudo abrir, ya hay MAX_PUERTOS o la plataforma no lo permite
+     */
+    bool agregarPuerto(const char* ruta, int baudios = 9600);
+
+    /**
+     * @brief Define la retención de los sensores que se creen (todos los puertos)
+     * @param politica Límites del historial
+     */
+    void setRetencion(const PoliticaRetencion& politica);
+
+    /**
+     * @brief Define los formatos aceptados (todos los puertos)
+     * @param formatoFlujo AUTOMATICO, TEXTO o BINARIO
+     */
+    void setFormato(FormatoFlujo formatoFlujo);
+
+    /**
+     * @brief Anota las lecturas aceptadas de todos los puertos en un diario
+     * @param diarioLecturas Diario abierto, o nullptr para dejar de anotar
+     */
+    void setDiario(DiarioLecturas* diarioLecturas);
+
+    /**
+     * @brief Envía los mismos bytes a todos los puertos abiertos
+     * @param datos Bytes a enviar (p. ej. el comando de formato del Arduino)
+     * @param longitud Número de bytes
+     * @return Puertos que aceptaron el envío
+     */
+    int enviarATodos(const char* datos, int longitud);
+
+    /**
+     * @brief Espera datos en cualquier puerto y atiende los que estén listos
+     * @param esperaMs Espera máxima (ms); 0 = sólo revisar
+     * @return Puertos que siguen abiertos
+     *
+     * Una señal interrumpe la espera y la función regresa sin leer.
+     */
+    int atender(int esperaMs);
+
+    /**
+     * @brief Procesa las líneas finales sin '\n' de los puertos que sigan abiertos
+     */
+    void finalizar();
+
+    /**
+     * @brief Puertos que aún no terminan
+     */
+    int puertosAbiertos() const;
+
+    /**
+     * @brief Número de puertos agregados
+     */
+    int getNumPuertos() const;
+
+    /**
+     * @brief Contadores de un puerto
+     * @param indice Puerto en orden de alta (0 .. getNumPuertos() - 1)
+     */
+    EstadisticasPuerto estadisticasPuerto(int indice) const;
+
+    /**
+     * @brief Suma de los contadores de ingesta de todos los puertos
+     */
+    EstadisticasIngesta estadisticas() const;
+
+    /**
+     * @brief Suma de los contadores de análisis de todos los puertos
+     */
+    EstadisticasParseo estadisticasParseo() const;
+};
+
+#endif // INGESTA_MULTIPUERTO_H
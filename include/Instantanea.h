@@ -0,0 +1,74 @@
+/**
+ * @file Instantanea.h
+ * @brief Guardado y restauración binaria del registro de sensores completo
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+#include "PoliticaRetencion.h"
+
+class ListaGeneral;
+
+/**
+ * @brief Contadores de un guardado o una carga
+ */
+struct EstadisticasInstantanea {
+    int sensores;           ///< Sensores escritos o restaurados
+    long long lecturas;     ///< Lecturas escritas o restauradas
+    long long bytes;        ///< Tamaño del archivo
+};
+
+/**
+ * @brief Instantánea binaria de todos los sensores y sus historiales
+ *
+ * Formato (orden de bytes de la máquina, todo alineado a 8 bytes):
+ * una cabecera con firma, versión, marca de orden de bytes, reloj
+ * monotónico y hora de pared del guardado, número de sensores y tamaño
+ * total; después, por sensor, su código de tipo ('T' o 'P'), su nombre y
+ * sus lecturas en dos columnas: todas las marcas (long long) y luego
+ * todos los valores (float o int). Se escriben primero las lecturas del
+ * archivo comprimido (descomprimidas) y después las del historial.
+ *
+ * guardar() escribe en RUTA.tmp, sincroniza con el disco y renombra, así
+ * que una interrupción deja la instantánea anterior intacta. cargar()
+ * mapea el archivo en memoria y entrega las columnas directamente a
+ * ListaSensor, que las copia por bloques: no hay análisis por lectura.
+ * Las marcas se trasladan al reloj del proceso nuevo conservando su
+ * antigüedad real (la hora de pared transcurrida desde el guardado).
+ */
+class Instantanea {
+public:
+    /// Versión del formato
+    static const unsigned int VERSION = 1;
+
+    /**
+     * @brief Escribe la instantánea de todos los sensores de la lista
+     * @param lista Sensores a guardar
+     * @param ruta Archivo destino (se reemplaza de forma atómica)
+     * @param stats Destino opcional de los contadores
+     * @return false si no se pudo escribir (la instantánea anterior se conserva)
+     */
+    static bool guardar(const ListaGeneral& lista, const char* ruta, EstadisticasInstantanea* stats = nullptr);
+
+    /**
+     * @brief Restaura los sensores de una instantánea en la lista
+     * @param lista Lista destino
+     * @param ruta Archivo de la instantánea
+     * @param politica Retención de los sensores creados
+     * @param stats Destino opcional de los contadores
+     * @return false si el archivo no existe o no es una instantánea válida
+     *
+     * Los sensores nuevos se crean con la política indicada; si ya existe
+     * uno con el mismo nombre y tipo, las lecturas se agregan a su
+     * historial. Un sensor con el mismo nombre y otro tipo se omite. Los
+     * agregados por segundo, minuto y hora se reconstruyen con las
+     * lecturas restauradas.
+     */
+    static bool cargar(ListaGeneral& lista, const char* ruta, const PoliticaRetencion& politica = PoliticaRetencion(),
+                       EstadisticasInstantanea* stats = nullptr);
+};
+
+#endif // INSTANTANEA_H
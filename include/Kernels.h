@@ -0,0 +1,107 @@
+/**
+ * @file Kernels.h
+ * @brief Núcleos vectorizados (SSE4.1/AVX2) de estadísticas sobre lecturas contiguas
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+
+/**
+ * @brief Conjunto de instrucciones usado por los núcleos
+ */
+enum class NivelSimd {
+    ESCALAR,    ///< C++ portable
+    SSE41,      ///< 128 bits (SSE4.1)
+    AVX2        ///< 256 bits (AVX2)
+};
+
+/**
+ * @brief Búsqueda, resumen, posición de extremos y varianza de arreglos contiguos de float o int
+ *
+ * ListaSensor los aplica a cada bloque de su historial. Cada operación
+ * tiene una versión escalar y, en x86, versiones SSE4.1 y AVX2 compiladas
+ * con atributos de destino. La primera llamada detecta las capacidades
+ * del procesador y fija el nivel más alto disponible; la variable de
+ * entorno IOT_SIMD (escalar|sse41|avx2) permite bajarlo.
+ *
+ * Las sumas se acumulan en double (float) o long long (int) y las
+ * desviaciones en double; las versiones vectoriales llevan varios
+ * acumuladores a la vez, de modo que no forman una sola cadena de
+ * dependencias. Los valores NaN no están soportados: su
+ * lugar en el orden de mínimo y máximo es arbitrario.
+ */
+class Kernels {
+public:
+    /**
+     * @brief Nivel activo (detectado la primera vez)
+     */
+    static NivelSimd nivel();
+
+    /**
+     * @brief Nombre del nivel activo: "escalar", "sse41" o "avx2"
+     */
+    static const char* nombreNivel();
+
+    /**
+     * @brief Fuerza un nivel (para pruebas y comparaciones)
+     * @param nivel Nivel deseado
+     * @return false si el procesador no lo soporta (el nivel no cambia)
+     */
+    static bool forzarNivel(NivelSimd nivel);
+
+    /**
+     * @brief Posición de la primera lectura igual a valor
+     * @return Índice en [0, n) o n si no existe
+     */
+    static size_t buscar(const float* datos, size_t n, float valor);
+    static size_t buscar(const int* datos, size_t n, int valor);    ///< @copydoc buscar(const float*, size_t, float)
+
+    /**
+     * @brief Suma, mínimo y máximo de n > 0 lecturas en una sola pasada
+     * @param datos Lecturas
+     * @param n Número de lecturas (al menos 1)
+     * @param suma Destino de la suma
+     * @param minimo Destino del mínimo
+     * @param maximo Destino del máximo
+     */
+    static void resumir(const float* datos, size_t n, double& suma, float& minimo, float& maximo);
+    static void resumir(const int* datos, size_t n, long long& suma, int& minimo, int& maximo);    ///< @copydoc resumir(const float*, size_t, double&, float&, float&)
+
+    /**
+     * @brief Posición de la primera aparición del mínimo
+     * @return Índice en [0, n) o 0 si n == 0
+     */
+    static size_t posicionMinimo(const float* datos, size_t n);
+    static size_t posicionMinimo(const int* datos, size_t n);   ///< @copydoc posicionMinimo(const float*, size_t)
+
+    /**
+     * @brief Posición de la primera aparición del máximo
+     * @return Índice en [0, n) o 0 si n == 0
+     */
+    static size_t posicionMaximo(const float* datos, size_t n);
+    static size_t posicionMaximo(const int* datos, size_t n);   ///< @copydoc posicionMaximo(const float*, size_t)
+
+    /**
+     * @brief Suma de los cuadrados de las desviaciones respecto a una media dada
+     * @param datos Lecturas
+     * @param n Número de lecturas
+     * @param media Media respecto a la que se mide (la de todo el conjunto
+     *        cuando datos es sólo un tramo, p. ej. un bloque de ListaSensor)
+     * @return Suma de (x - media)^2 o 0 si n == 0
+     */
+    static double desviacion(const float* datos, size_t n, double media);
+    static double desviacion(const int* datos, size_t n, double media);     ///< @copydoc desviacion(const float*, size_t, double)
+
+    /**
+     * @brief Varianza poblacional (dos pasadas: media y desviaciones)
+     * @return Varianza o 0 si n == 0
+     */
+    static double varianza(const float* datos, size_t n);
+    static double varianza(const int* datos, size_t n);     ///< @copydoc varianza(const float*, size_t)
+};
+
+#endif // KERNELS_H
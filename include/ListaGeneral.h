@@ -9,8 +9,14 @@
 #define LISTA_GENERAL_H
 
 #include "SensorBase.h"
+#include "PoolNodos.h"
+#include <cstring>
 #include <iostream>
 
+class PoolTrabajo;
+class SensorTemperatura;
+class SensorPresion;
+
 /**
  * @brief Nodo para la lista de gestión polimórfica
  */
@@ -25,15 +31,102 @@ struct NodoSensor {
     NodoSensor(SensorBase* s) : sensor(s), siguiente(nullptr) {}
 };
 
+/**
+ * @brief Arreglo contiguo de los sensores de un mismo tipo concreto
+ * @tparam T SensorTemperatura, SensorPresion o SensorBase (tipos de usuario)
+ *
+ * No posee los sensores: sólo agrupa punteros para recorrerlos en lotes
+ * homogéneos (una sola rama de tipo por lote, llamadas no virtuales).
+ * Junto a cada sensor guarda su posición en la lista general, para que
+ * quien procese por grupos pueda devolver los resultados en ese orden.
+ */
+template <typename T>
+struct GrupoSensores {
+    T** sensores;       ///< Punteros a los sensores del tipo
+    int* posiciones;    ///< Posición de cada sensor en la lista general
+    int cantidad;       ///< Sensores en el grupo
+    int capacidad;      ///< Casillas reservadas
+
+    /**
+     * @brief Constructor: grupo vacío
+     */
+    GrupoSensores() : sensores(nullptr), posiciones(nullptr), cantidad(0), capacidad(0) {}
+
+    /**
+     * @brief Destructor: libera sólo los arreglos de punteros y posiciones
+     */
+    ~GrupoSensores() {
+        delete[] sensores;
+        delete[] posiciones;
+    }
+
+    GrupoSensores(const GrupoSensores&) = delete;               ///< No copiable
+    GrupoSensores& operator=(const GrupoSensores&) = delete;    ///< No asignable
+
+    /**
+     * @brief Agrega un sensor al final del grupo (duplica la capacidad si hace falta)
+     * @param sensor Sensor del tipo T
+     * @param posicion Posición del sensor en la lista general
+     */
+    void agregar(T* sensor, int posicion) {
+        if (cantidad == capacidad) {
+            int nueva = capacidad > 0 ? capacidad * 2 : 16;
+            T** arreglo = new T*[nueva];
+            int* arregloPosiciones = new int[nueva];
+            if (cantidad > 0) {
+                memcpy(arreglo, sensores, sizeof(T*) * cantidad);
+                memcpy(arregloPosiciones, posiciones, sizeof(int) * cantidad);
+            }
+            delete[] sensores;
+            delete[] posiciones;
+            sensores = arreglo;
+            posiciones = arregloPosiciones;
+            capacidad = nueva;
+        }
+        sensores[cantidad] = sensor;
+        posiciones[cantidad] = posicion;
+        cantidad++;
+    }
+};
+
 /**
  * @brief Lista enlazada para gestión polimórfica de sensores
  * 
  * Esta lista almacena punteros a la clase base SensorBase*,
  * permitiendo almacenar diferentes tipos de sensores en una única estructura.
+ * Además del orden de inserción (la lista enlazada) mantiene un arreglo
+ * denso indexado por el IdNombre de cada sensor: buscarPorId es un acceso
+ * directo y buscarSensor sólo agrega la consulta a TablaNombres.
+ *
+ * Cada sensor se agrega también al grupo de su tipo concreto según su
+ * etiqueta (TipoSensor), con su posición en la lista. El procesamiento
+ * llama directamente a las clases final de temperatura y presión, sin
+ * despacho virtual; los tipos de usuario usan la llamada virtual de
+ * siempre. Ambas versiones emiten la salida en el orden de la lista.
  */
 class ListaGeneral {
 private:
-    NodoSensor* cabeza;     ///< Puntero al primer nodo
+    NodoSensor* cabeza;         ///< Puntero al primer nodo
+    NodoSensor* cola;           ///< Puntero al último nodo (inserción O(1))
+    PoolNodos<NodoSensor> poolNodos;    ///< Asignador por losas de los NodoSensor
+    SensorBase** porId;         ///< Sensor de cada IdNombre (nullptr si no hay)
+    int capacidadIndice;        ///< Casillas de porId
+    int numSensores;            ///< Sensores registrados en el índice
+    GrupoSensores<SensorTemperatura> temperaturas;  ///< Sensores con etiqueta TEMPERATURA
+    GrupoSensores<SensorPresion> presiones;         ///< Sensores con etiqueta PRESION
+    GrupoSensores<SensorBase> otros;                ///< Sensores de tipos de usuario
+
+    /**
+     * @brief Registra un sensor en el índice si su nombre no existe
+     * @param sensor Sensor a indexar
+     */
+    void indexar(SensorBase* sensor);
+
+    /**
+     * @brief Agranda porId para que quepa un id
+     * @param id IdNombre que debe caber
+     */
+    void crecerIndice(IdNombre id);
 
 public:
     /**
@@ -46,6 +139,9 @@ public:
      */
     ~ListaGeneral();
 
+    ListaGeneral(const ListaGeneral&) = delete;             ///< No copiable (posee los sensores)
+    ListaGeneral& operator=(const ListaGeneral&) = delete;  ///< No asignable
+
     /**
      * @brief Inserta un sensor al final de la lista
      * @param sensor Puntero al sensor a insertar
@@ -56,24 +152,81 @@ public:
      * @brief Busca un sensor por su nombre
      * @param nombre Nombre del sensor a buscar
      * @return Puntero al sensor encontrado o nullptr si no existe
+     *
+     * Resuelve el id en TablaNombres (O(1) promedio) y consulta el índice.
      */
     SensorBase* buscarSensor(const char* nombre);
 
     /**
-     * @brief Procesa todos los sensores de la lista polimórficamente
+     * @brief Busca un sensor por un nombre no terminado en nulo
+     * @param nombre Caracteres del nombre (p. ej. una vista del búfer serial)
+     * @param longitud Número de caracteres
+     * @return Puntero al sensor encontrado o nullptr si no existe
+     */
+    SensorBase* buscarSensor(const char* nombre, int longitud);
+
+    /**
+     * @brief Busca un sensor por el id internado de su nombre
+     * @param id IdNombre del sensor
+     * @return Puntero al sensor o nullptr si no existe
+     */
+    SensorBase* buscarPorId(IdNombre id) const {
+        return id < static_cast<IdNombre>(capacidadIndice) ? porId[id] : nullptr;
+    }
+
+    /**
+     * @brief Procesa todos los sensores en el orden de la lista
+     *
+     * La etiqueta de tipo elige la llamada: directa para temperatura y
+     * presión, virtual para los tipos de usuario.
      */
     void procesarTodosSensores();
 
+    /**
+     * @brief Procesa todos los sensores en paralelo con robo de trabajo
+     * @param pool Grupo de hilos que ejecuta el procesamiento
+     *
+     * Los hilos recorren los grupos por tipo; cada sensor se procesa en un
+     * solo hilo y su salida se captura en la casilla de su posición, así
+     * que se emite al final en el orden de la lista, igual que la versión
+     * secuencial.
+     */
+    void procesarTodosSensores(PoolTrabajo& pool);
+
     /**
      * @brief Imprime información de todos los sensores
      */
     void imprimirTodos() const;
 
+    /**
+     * @brief Aplica una función a cada sensor en el orden de la lista
+     * @tparam Funcion Invocable con un const SensorBase*
+     * @param f Función a aplicar
+     */
+    template <typename Funcion>
+    void paraCadaSensor(Funcion f) const {
+        for (const NodoSensor* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            f(static_cast<const SensorBase*>(actual->sensor));
+        }
+    }
+
     /**
      * @brief Verifica si la lista está vacía
      * @return true si está vacía, false en caso contrario
      */
     bool estaVacia() const;
+
+    /**
+     * @brief Obtiene el número de sensores registrados
+     * @return Cantidad de sensores indexados (nombres distintos)
+     */
+    int getNumSensores() const;
+
+    /**
+     * @brief Estadísticas del asignador de nodos de la lista de gestión
+     * @return Contadores de reservas, liberaciones y losas
+     */
+    EstadisticasPool getEstadisticasNodos() const;
 };
 
 #endif // LISTA_GENERAL_H
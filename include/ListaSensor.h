@@ -9,21 +9,212 @@
 #define LISTA_SENSOR_H
 
 #include <iostream>
+#include "PoolNodos.h"
+#include "PoliticaRetencion.h"
+#include "ArchivoComprimido.h"
+#include "Kernels.h"
+#include "VentanaTiempo.h"
+#include "Log.h"
 
 /**
- * @brief Estructura de Nodo genérico para la lista enlazada
+ * @brief Tamaño en bytes de la línea de caché usada para dimensionar los bloques
+ */
+constexpr int TAM_LINEA_CACHE = 64;
+
+/**
+ * @brief Posición de la primera lectura igual a valor en un tramo de bloque
+ * @param datos Lecturas contiguas
+ * @param n Número de lecturas
+ * @param valor Valor buscado
+ * @return Índice en [0, n) o n si no está
+ *
+ * float e int usan Kernels (SIMD); los demás tipos, este recorrido.
+ */
+template <typename T>
+inline int buscarEnBloque(const T* datos, int n, T valor) {
+    for (int i = 0; i < n; i++) {
+        if (datos[i] == valor) return i;
+    }
+    return n;
+}
+
+/// @copydoc buscarEnBloque
+inline int buscarEnBloque(const float* datos, int n, float valor) {
+    return static_cast<int>(Kernels::buscar(datos, static_cast<size_t>(n), valor));
+}
+
+/// @copydoc buscarEnBloque
+inline int buscarEnBloque(const int* datos, int n, int valor) {
+    return static_cast<int>(Kernels::buscar(datos, static_cast<size_t>(n), valor));
+}
+
+/**
+ * @brief Suma, mínimo y máximo de un tramo de bloque en una sola pasada
+ * @param datos Lecturas contiguas
+ * @param n Número de lecturas (al menos 1)
+ * @param suma Destino de la suma
+ * @param minimo Destino del mínimo
+ * @param maximo Destino del máximo
+ *
+ * float e int usan Kernels (SIMD); los demás tipos, este recorrido.
+ */
+template <typename T>
+inline void resumirBloque(const T* datos, int n, double& suma, T& minimo, T& maximo) {
+    double s = 0.0;
+    minimo = datos[0];
+    maximo = datos[0];
+    for (int i = 0; i < n; i++) {
+        s += datos[i];
+        if (datos[i] < minimo) minimo = datos[i];
+        if (maximo < datos[i]) maximo = datos[i];
+    }
+    suma = s;
+}
+
+/// @copydoc resumirBloque
+inline void resumirBloque(const float* datos, int n, double& suma, float& minimo, float& maximo) {
+    Kernels::resumir(datos, static_cast<size_t>(n), suma, minimo, maximo);
+}
+
+/// @copydoc resumirBloque
+inline void resumirBloque(const int* datos, int n, double& suma, int& minimo, int& maximo) {
+    long long s;
+    Kernels::resumir(datos, static_cast<size_t>(n), s, minimo, maximo);
+    suma = static_cast<double>(s);
+}
+
+/**
+ * @brief Posición de la primera aparición del mínimo en un tramo de bloque
+ * @param datos Lecturas contiguas
+ * @param n Número de lecturas (al menos 1)
+ * @return Índice en [0, n)
+ *
+ * float e int usan Kernels (SIMD); los demás tipos, este recorrido.
+ */
+template <typename T>
+inline int posicionMinimoEnBloque(const T* datos, int n) {
+    int pos = 0;
+    for (int i = 1; i < n; i++) {
+        if (datos[i] < datos[pos]) pos = i;
+    }
+    return pos;
+}
+
+/// @copydoc posicionMinimoEnBloque
+inline int posicionMinimoEnBloque(const float* datos, int n) {
+    return static_cast<int>(Kernels::posicionMinimo(datos, static_cast<size_t>(n)));
+}
+
+/// @copydoc posicionMinimoEnBloque
+inline int posicionMinimoEnBloque(const int* datos, int n) {
+    return static_cast<int>(Kernels::posicionMinimo(datos, static_cast<size_t>(n)));
+}
+
+/**
+ * @brief Posición de la primera aparición del máximo en un tramo de bloque
+ * @param datos Lecturas contiguas
+ * @param n Número de lecturas (al menos 1)
+ * @return Índice en [0, n)
+ *
+ * float e int usan Kernels (SIMD); los demás tipos, este recorrido.
+ */
+template <typename T>
+inline int posicionMaximoEnBloque(const T* datos, int n) {
+    int pos = 0;
+    for (int i = 1; i < n; i++) {
+        if (datos[pos] < datos[i]) pos = i;
+    }
+    return pos;
+}
+
+/// @copydoc posicionMaximoEnBloque
+inline int posicionMaximoEnBloque(const float* datos, int n) {
+    return static_cast<int>(Kernels::posicionMaximo(datos, static_cast<size_t>(n)));
+}
+
+/// @copydoc posicionMaximoEnBloque
+inline int posicionMaximoEnBloque(const int* datos, int n) {
+    return static_cast<int>(Kernels::posicionMaximo(datos, static_cast<size_t>(n)));
+}
+
+/**
+ * @brief Suma de (x - media)^2 sobre un tramo de bloque
+ * @param datos Lecturas contiguas
+ * @param n Número de lecturas
+ * @param media Media de toda la lista
+ *
+ * float e int usan Kernels (SIMD); los demás tipos, este recorrido.
+ */
+template <typename T>
+inline double desviacionBloque(const T* datos, int n, double media) {
+    double s = 0.0;
+    for (int i = 0; i < n; i++) {
+        double x = static_cast<double>(datos[i]) - media;
+        s += x * x;
+    }
+    return s;
+}
+
+/// @copydoc desviacionBloque
+inline double desviacionBloque(const float* datos, int n, double media) {
+    return Kernels::desviacion(datos, static_cast<size_t>(n), media);
+}
+
+/// @copydoc desviacionBloque
+inline double desviacionBloque(const int* datos, int n, double media) {
+    return Kernels::desviacion(datos, static_cast<size_t>(n), media);
+}
+
+/**
+ * @brief Posiciones en el índice de mínimos de las lecturas de un bloque
+ * @tparam N Capacidad del bloque
+ */
+template <int N>
+struct PosicionesBloque {
+    int pos[N];     ///< Posición de cada lectura del bloque en el montículo
+};
+
+/**
+ * @brief Estructura de Nodo genérico para la lista enlazada desenrollada
  * @tparam T Tipo de dato a almacenar en el nodo
+ *
+ * Cada nodo guarda un bloque de lecturas del tamaño de una línea de caché
+ * (16 float o 16 int), de modo que una sola reserva de memoria y un solo
+ * puntero sirven para varias lecturas consecutivas. Cada lectura lleva su
+ * marca de tiempo en un arreglo paralelo. Las posiciones en el índice de
+ * mínimos viven fuera del bloque y sólo existen mientras el índice está
+ * activo, para no agrandar los bloques de las listas que nunca lo usan.
  */
 template <typename T>
 struct Nodo {
-    T dato;                 ///< Dato almacenado en el nodo
-    Nodo<T>* siguiente;     ///< Puntero al siguiente nodo
-    
+    /// Número de lecturas que caben en un bloque
+    static constexpr int CAPACIDAD =
+        (TAM_LINEA_CACHE / static_cast<int>(sizeof(T))) > 0
+            ? TAM_LINEA_CACHE / static_cast<int>(sizeof(T)) : 1;
+
+    T datos[CAPACIDAD];             ///< Lecturas almacenadas en el bloque
+    long long tiempos[CAPACIDAD];   ///< Marca de tiempo (ms) de cada lectura
+    PosicionesBloque<CAPACIDAD>* posMonticulo;  ///< Posiciones en el índice de mínimos (nullptr si inactivo)
+    int inicio;                     ///< Primera posición válida (las anteriores se descartaron)
+    int cantidad;                   ///< Posiciones escritas; válidas las de [inicio, cantidad)
+    unsigned long long secuencia;   ///< Orden de creación del bloque (desempate del mínimo)
+    Nodo<T>* siguiente;             ///< Puntero al siguiente nodo
+    Nodo<T>* anterior;              ///< Puntero al nodo previo (desenlace en O(1))
+
     /**
-     * @brief Constructor del nodo
-     * @param valor Valor a almacenar en el nodo
+     * @brief Constructor del nodo (bloque vacío)
+     * @param sec Número de secuencia del bloque
      */
-    Nodo(T valor) : dato(valor), siguiente(nullptr) {}
+    explicit Nodo(unsigned long long sec = 0)
+        : posMonticulo(nullptr), inicio(0), cantidad(0), secuencia(sec), siguiente(nullptr), anterior(nullptr) {}
+
+    /**
+     * @brief Indica si el bloque ya no admite más lecturas
+     * @return true si el bloque está lleno
+     */
+    bool estaLleno() const {
+        return cantidad == CAPACIDAD;
+    }
 };
 
 /**
@@ -31,40 +222,169 @@ struct Nodo {
  * @tparam T Tipo de dato a almacenar en la lista
  * 
  * Esta clase implementa una lista enlazada simple genérica con
- * gestión manual de memoria mediante punteros.
+ * gestión manual de memoria mediante punteros. Internamente la lista
+ * está desenrollada: cada Nodo<T> contiene un bloque de lecturas y se
+ * mantiene un puntero a la cola para insertar en O(1).
+ *
+ * La suma, el mínimo y el máximo se actualizan en cada inserción, por lo
+ * que calcularPromedio es O(1). Para eliminarMasBajo se mantiene un
+ * montículo de mínimos sobre manejadores (bloque, posición) que se
+ * construye la primera vez que se necesita y desde entonces se actualiza
+ * en cada inserción y eliminación en O(log n).
+ *
+ * Los bloques se obtienen de un PoolNodos propio de cada lista: los
+ * bloques vaciados se reciclan y al destruir la lista las losas se
+ * devuelven al sistema en bloque.
+ *
+ * Con una PoliticaRetencion la lista funciona como historial circular:
+ * al superar el límite de lecturas o de antigüedad se descartan las más
+ * antiguas desde la cabeza, y sus bloques vuelven al pool para reusarse
+ * en la cola. La memoria queda acotada y la inserción sigue siendo O(1).
+ *
+ * Cada lectura guarda la marca de tiempo (ms de relojMs) con la que se
+ * insertó, y las marcas nunca decrecen a lo largo de la lista. Con ellas
+ * resumirRango responde conteo, suma, mínimo y máximo de un intervalo
+ * [t0, t1) en O(log n + k): un índice ordenado de bloques, construido la
+ * primera vez que se consulta y mantenido después al agregar o descartar
+ * bloques, permite ubicar el primer bloque por búsqueda binaria y sólo se
+ * recorren las k lecturas del intervalo.
+ *
+ * Los recorridos que sí tocan todas las lecturas (buscar, el recálculo de
+ * extremos, los bloques de resumirRango, calcularVarianza y la ubicación
+ * de extremos de buscarMinimo/buscarMaximo) procesan cada bloque con los
+ * núcleos SIMD de Kernels en una llamada: buscarEnBloque, resumirBloque,
+ * desviacionBloque y posicionMinimoEnBloque/posicionMaximoEnBloque.
  */
 template <typename T>
 class ListaSensor {
 private:
+    /**
+     * @brief Referencia estable a una lectura dentro de un bloque
+     */
+    struct Manejador {
+        Nodo<T>* bloque;    ///< Bloque que contiene la lectura
+        int pos;            ///< Posición dentro del bloque
+    };
+
     Nodo<T>* cabeza;        ///< Puntero al primer nodo de la lista
+    Nodo<T>* cola;          ///< Puntero al último nodo de la lista
     int tamanio;            ///< Número de elementos en la lista
+    int numBloques;         ///< Número de nodos (bloques) reservados
+    unsigned long long siguienteSecuencia; ///< Secuencia del próximo bloque
+    PoliticaRetencion retencion;    ///< Límites del historial
+    long long descartadas;          ///< Lecturas descartadas por retención
+
+    double suma;            ///< Suma acumulada de las lecturas
+    mutable T minimo;               ///< Mínimo actual (válido si extremosValidos)
+    mutable T maximo;               ///< Máximo actual (válido si extremosValidos)
+    mutable bool extremosValidos;   ///< false si hay que recalcular mínimo/máximo
+
+    PoolNodos<Nodo<T>> pool;    ///< Asignador de los bloques de esta lista
+
+    Manejador* monticulo;   ///< Montículo de mínimos (nullptr si inactivo)
+    PoolNodos<PosicionesBloque<Nodo<T>::CAPACIDAD>> poolPosiciones;    ///< Posiciones de cada bloque en el montículo
+    int tamMonticulo;       ///< Elementos en el montículo
+    int capMonticulo;       ///< Capacidad reservada del montículo
+
+    mutable Nodo<T>** indiceTiempo; ///< Bloques en orden de lista (nullptr si inactivo)
+    mutable int inicioIndice;       ///< Primera entrada vigente del índice
+    mutable int finIndice;          ///< Una después de la última entrada vigente
+    mutable int capIndice;          ///< Capacidad reservada del índice
+
+    ArchivoComprimido<T>* archivo;  ///< Lecturas descartadas comprimidas (nullptr si la política no lo pide)
 
 public:
+    /**
+     * @brief Iterador de solo lectura que recorre la lista bloque por bloque
+     *
+     * Permite recorrer las lecturas como arreglos contiguos sin exponer
+     * los punteros internos de la lista.
+     */
+    class IteradorBloque {
+    private:
+        const Nodo<T>* actual;  ///< Bloque actual del recorrido
+
+    public:
+        /**
+         * @brief Constructor del iterador
+         * @param inicio Bloque donde comienza el recorrido
+         */
+        explicit IteradorBloque(const Nodo<T>* inicio) : actual(inicio) {}
+
+        /**
+         * @brief Indica si el iterador apunta a un bloque válido
+         */
+        explicit operator bool() const {
+            return actual != nullptr;
+        }
+
+        /**
+         * @brief Lecturas contiguas del bloque actual
+         * @return Puntero a la primera lectura del bloque
+         */
+        const T* datos() const {
+            return actual->datos + actual->inicio;
+        }
+
+        /**
+         * @brief Marcas de tiempo de las lecturas del bloque actual
+         * @return Puntero a la marca de datos()[0]
+         */
+        const long long* tiempos() const {
+            return actual->tiempos + actual->inicio;
+        }
+
+        /**
+         * @brief Número de lecturas del bloque actual
+         * @return Cantidad de lecturas válidas en datos()
+         */
+        int cantidad() const {
+            return actual->cantidad - actual->inicio;
+        }
+
+        /**
+         * @brief Avanza al siguiente bloque
+         * @return Referencia a este iterador
+         */
+        IteradorBloque& operator++() {
+            actual = actual->siguiente;
+            return *this;
+        }
+    };
+
     /**
      * @brief Constructor por defecto
      */
-    ListaSensor() : cabeza(nullptr), tamanio(0) {
-        std::cout << "[Log] ListaSensor creada." << std::endl;
+    ListaSensor()
+        : cabeza(nullptr), cola(nullptr), tamanio(0), numBloques(0), siguienteSecuencia(0),
+          retencion(), descartadas(0), suma(0.0), minimo(T()), maximo(T()), extremosValidos(true),
+          monticulo(nullptr), tamMonticulo(0), capMonticulo(0),
+          indiceTiempo(nullptr), inicioIndice(0), finIndice(0), capIndice(0), archivo(nullptr) {
+        LOG_DEPURACION("[Log] ListaSensor creada.");
     }
 
     /**
      * @brief Destructor - Libera toda la memoria de la lista
      */
     ~ListaSensor() {
-        std::cout << "[Log] Liberando ListaSensor..." << std::endl;
+        LOG_DEPURACION("[Log] Liberando ListaSensor...");
         liberarTodo();
     }
 
     /**
      * @brief Constructor de copia (Regla de los Tres)
      * @param otra Lista a copiar
+     *
+     * Los índices de mínimos y de tiempo no se copian; se reconstruyen bajo
+     * demanda. El archivo comprimido y la cuenta de descartadas sí.
      */
-    ListaSensor(const ListaSensor& otra) : cabeza(nullptr), tamanio(0) {
-        Nodo<T>* actual = otra.cabeza;
-        while (actual != nullptr) {
-            insertarAlFinal(actual->dato);
-            actual = actual->siguiente;
-        }
+    ListaSensor(const ListaSensor& otra)
+        : cabeza(nullptr), cola(nullptr), tamanio(0), numBloques(0), siguienteSecuencia(0),
+          retencion(otra.retencion), descartadas(otra.descartadas), suma(0.0), minimo(T()), maximo(T()), extremosValidos(true),
+          monticulo(nullptr), tamMonticulo(0), capMonticulo(0),
+          indiceTiempo(nullptr), inicioIndice(0), finIndice(0), capIndice(0),
+          archivo(otra.archivo != nullptr ? new ArchivoComprimido<T>(*otra.archivo) : nullptr) {
+        copiarDesde(otra);
     }
 
     /**
@@ -75,33 +395,584 @@ public:
     ListaSensor& operator=(const ListaSensor& otra) {
         if (this != &otra) {
             liberarTodo();
-            Nodo<T>* actual = otra.cabeza;
-            while (actual != nullptr) {
-                insertarAlFinal(actual->dato);
-                actual = actual->siguiente;
+            retencion = otra.retencion;
+            descartadas = otra.descartadas;     // Viajan con el archivo
+            if (otra.archivo != nullptr) {
+                archivo = new ArchivoComprimido<T>(*otra.archivo);
             }
+            copiarDesde(otra);
         }
         return *this;
     }
 
     /**
-     * @brief Inserta un elemento al final de la lista
+     * @brief Constructor de movimiento: toma los bloques de otra lista en O(1)
+     * @param otra Lista origen (queda vacía y utilizable)
+     */
+    ListaSensor(ListaSensor&& otra) noexcept
+        : cabeza(otra.cabeza), cola(otra.cola), tamanio(otra.tamanio), numBloques(otra.numBloques),
+          siguienteSecuencia(otra.siguienteSecuencia), retencion(otra.retencion),
+          descartadas(otra.descartadas), suma(otra.suma), minimo(otra.minimo), maximo(otra.maximo),
+          extremosValidos(otra.extremosValidos), pool(std::move(otra.pool)),
+          monticulo(otra.monticulo), poolPosiciones(std::move(otra.poolPosiciones)), tamMonticulo(otra.tamMonticulo), capMonticulo(otra.capMonticulo),
+          indiceTiempo(otra.indiceTiempo), inicioIndice(otra.inicioIndice), finIndice(otra.finIndice),
+          capIndice(otra.capIndice), archivo(otra.archivo) {
+        otra.soltar();
+        otra.archivo = nullptr;
+    }
+
+    /**
+     * @brief Asignación de movimiento: libera lo propio y toma los bloques de otra
+     * @param otra Lista origen (queda vacía y utilizable)
+     * @return Referencia a esta lista
+     */
+    ListaSensor& operator=(ListaSensor&& otra) noexcept {
+        if (this != &otra) {
+            liberarTodo();
+            cabeza = otra.cabeza;
+            cola = otra.cola;
+            tamanio = otra.tamanio;
+            numBloques = otra.numBloques;
+            siguienteSecuencia = otra.siguienteSecuencia;
+            retencion = otra.retencion;
+            descartadas = otra.descartadas;
+            suma = otra.suma;
+            minimo = otra.minimo;
+            maximo = otra.maximo;
+            extremosValidos = otra.extremosValidos;
+            pool = std::move(otra.pool);
+            monticulo = otra.monticulo;
+            poolPosiciones = std::move(otra.poolPosiciones);
+            tamMonticulo = otra.tamMonticulo;
+            capMonticulo = otra.capMonticulo;
+            indiceTiempo = otra.indiceTiempo;
+            inicioIndice = otra.inicioIndice;
+            finIndice = otra.finIndice;
+            capIndice = otra.capIndice;
+            archivo = otra.archivo;
+            otra.soltar();
+            otra.archivo = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Inserta un elemento al final de la lista con la hora actual
      * @param valor Valor a insertar
      */
     void insertarAlFinal(T valor) {
-        Nodo<T>* nuevo = new Nodo<T>(valor);
-        std::cout << "[Log] Insertando Nodo<T> con valor: " << valor << std::endl;
-        
-        if (cabeza == nullptr) {
-            cabeza = nuevo;
+        insertarAlFinal(valor, relojMs());
+    }
+
+    /**
+     * @brief Inserta un elemento al final de la lista
+     * @param valor Valor a insertar
+     * @param tiempo Marca de tiempo en ms de relojMs; si es anterior a la
+     *               última de la lista se toma ésta (las marcas no decrecen)
+     *
+     * Complejidad O(1): se escribe en el bloque de la cola y sólo se
+     * reserva un nodo nuevo cuando éste está lleno. Si el índice de
+     * mínimos está activo la inserción cuesta O(log n). Si se supera la
+     * política de retención se descartan las lecturas más antiguas.
+     */
+    void insertarAlFinal(T valor, long long tiempo) {
+        LOG_TRAZA("[Log] Insertando Nodo<T> con valor: " << valor);
+
+        if (cola != nullptr && tiempo < ultimoTiempo()) {
+            tiempo = ultimoTiempo();
+        }
+        if (cola == nullptr || cola->estaLleno()) {
+            agregarBloque();
+        }
+        int pos = cola->cantidad++;
+        cola->datos[pos] = valor;
+        cola->tiempos[pos] = tiempo;
+        tamanio++;
+        acumular(valor);
+
+        if (monticulo != nullptr) {
+            insertarEnMonticulo(cola, pos);
+        }
+
+        if (retencion.maxLecturas > 0 && tamanio > retencion.maxLecturas) {
+            descartarMasAntigua();
+        }
+        if (retencion.maxEdadMs > 0) {
+            descartarAnterioresA(tiempo - retencion.maxEdadMs);
+        }
+    }
+
+    /**
+     * @brief Construye una lectura al final a partir de sus argumentos
+     * @param args Argumentos del constructor de T
+     */
+    template <typename... Args>
+    void emplazarAlFinal(Args&&... args) {
+        insertarAlFinal(T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Inserta un arreglo de lecturas al final, todas con la hora actual
+     * @param valores Lecturas en orden
+     * @param n Número de lecturas
+     */
+    void insertarVarias(const T* valores, int n) {
+        insertarVarias(valores, n, relojMs());
+    }
+
+    /**
+     * @brief Inserta un arreglo de lecturas al final con una misma marca de tiempo
+     * @param valores Lecturas en orden
+     * @param n Número de lecturas
+     * @param tiempo Marca de tiempo (ms) de todas; no menor que la última de la lista
+     *
+     * Llena cada bloque con una copia contigua y actualiza la suma y los
+     * extremos en la misma pasada; la retención se aplica una sola vez al
+     * final. O(n) sin índice de mínimos.
+     */
+    void insertarVarias(const T* valores, int n, long long tiempo) {
+        if (n <= 0) return;
+        LOG_TRAZA("[Log] Insertando " << n << " lecturas en bloque.");
+
+        if (cola != nullptr && tiempo < ultimoTiempo()) {
+            tiempo = ultimoTiempo();
+        }
+        int hecho = 0;
+        while (hecho < n) {
+            if (cola == nullptr || cola->estaLleno()) {
+                agregarBloque();
+            }
+            int inicioBloque = cola->cantidad;
+            int espacio = Nodo<T>::CAPACIDAD - inicioBloque;
+            int tramo = n - hecho < espacio ? n - hecho : espacio;
+            for (int i = 0; i < tramo; i++) {
+                T valor = valores[hecho + i];
+                cola->datos[inicioBloque + i] = valor;
+                cola->tiempos[inicioBloque + i] = tiempo;
+                tamanio++;
+                acumular(valor);
+            }
+            cola->cantidad += tramo;
+            if (monticulo != nullptr) {
+                for (int i = 0; i < tramo; i++) {
+                    insertarEnMonticulo(cola, inicioBloque + i);
+                }
+            }
+            hecho += tramo;
+        }
+
+        if (retencion.maxLecturas > 0) {
+            while (tamanio > retencion.maxLecturas) {
+                descartarMasAntigua();
+            }
+        }
+        if (retencion.maxEdadMs > 0) {
+            descartarAnterioresA(tiempo - retencion.maxEdadMs);
+        }
+    }
+
+    /**
+     * @brief Inserta un arreglo de lecturas al final, cada una con su marca
+     * @param valores Lecturas en orden
+     * @param tiempos Marca de cada lectura (ms)
+     * @param n Número de lecturas
+     * @param desplazamiento Se suma a cada marca (p. ej. para llevarlas al reloj actual)
+     *
+     * Pensada para restaurar historiales: copia tramos contiguos a cada
+     * bloque. Una marca menor que la anterior se iguala a ella. Si la
+     * retención por cantidad descartaría de inmediato parte del arreglo,
+     * esa parte no llega a los bloques (va directo al archivo comprimido,
+     * si lo hay).
+     */
+    void insertarVarias(const T* valores, const long long* tiempos, int n, long long desplazamiento = 0) {
+        if (n <= 0) return;
+        LOG_TRAZA("[Log] Restaurando " << n << " lecturas en bloque.");
+
+        long long ultimo = cola != nullptr ? ultimoTiempo() : tiempos[0] + desplazamiento;
+        int hecho = 0;
+        if (retencion.maxLecturas > 0 && n > retencion.maxLecturas) {
+            while (tamanio > 0) {
+                descartarMasAntigua();
+            }
+            hecho = n - retencion.maxLecturas;
+            for (int i = 0; i < hecho && archivo != nullptr; i++) {
+                long long tiempo = tiempos[i] + desplazamiento;
+                if (tiempo < ultimo) tiempo = ultimo;
+                ultimo = tiempo;
+                archivo->agregar(valores[i], tiempo);
+            }
+            descartadas += hecho;
+        }
+
+        while (hecho < n) {
+            if (cola == nullptr || cola->estaLleno()) {
+                agregarBloque();
+            }
+            int inicioBloque = cola->cantidad;
+            int espacio = Nodo<T>::CAPACIDAD - inicioBloque;
+            int tramo = n - hecho < espacio ? n - hecho : espacio;
+            for (int i = 0; i < tramo; i++) {
+                T valor = valores[hecho + i];
+                long long tiempo = tiempos[hecho + i] + desplazamiento;
+                if (tiempo < ultimo) tiempo = ultimo;
+                ultimo = tiempo;
+                cola->datos[inicioBloque + i] = valor;
+                cola->tiempos[inicioBloque + i] = tiempo;
+                tamanio++;
+                acumular(valor);
+            }
+            cola->cantidad += tramo;
+            if (monticulo != nullptr) {
+                for (int i = 0; i < tramo; i++) {
+                    insertarEnMonticulo(cola, inicioBloque + i);
+                }
+            }
+            hecho += tramo;
+        }
+
+        if (retencion.maxLecturas > 0) {
+            while (tamanio > retencion.maxLecturas) {
+                descartarMasAntigua();
+            }
+        }
+        if (retencion.maxEdadMs > 0) {
+            descartarAnterioresA(ultimo - retencion.maxEdadMs);
+        }
+    }
+
+    /**
+     * @brief Inserta al final las lecturas de un rango de iteradores
+     * @tparam Iterador Iterador de entrada cuyos elementos se convierten a T
+     * @param inicio Primer elemento
+     * @param fin Uno después del último
+     */
+    template <typename Iterador>
+    void insertarRango(Iterador inicio, Iterador fin) {
+        T tramo[Nodo<T>::CAPACIDAD];
+        int n = 0;
+        for (; inicio != fin; ++inicio) {
+            tramo[n++] = static_cast<T>(*inicio);
+            if (n == Nodo<T>::CAPACIDAD) {
+                insertarVarias(tramo, n);
+                n = 0;
+            }
+        }
+        insertarVarias(tramo, n);
+    }
+
+    /**
+     * @brief Mueve todas las lecturas de otra lista al final de ésta
+     * @param otra Lista origen (queda vacía)
+     *
+     * No copia lecturas: los bloques de otra se enlazan tras la cola y su
+     * pool se incorpora al de esta lista. Cuesta O(bloques de otra) por la
+     * renumeración de secuencias. Las marcas de otra anteriores a la última
+     * de esta lista se igualan a ella para conservar el orden temporal. Los
+     * índices de mínimos y de tiempo se descartan y se reconstruyen cuando
+     * haga falta; se aplica la retención de esta lista. El archivo
+     * comprimido de otra, si lo tiene, se queda en otra.
+     */
+    void empalmar(ListaSensor& otra) {
+        if (this == &otra || otra.cabeza == nullptr) return;
+
+        descartarMonticulo();
+        otra.descartarMonticulo();
+        if (cola != nullptr) {
+            long long ultimo = ultimoTiempo();
+            bool ajustando = true;
+            for (Nodo<T>* b = otra.cabeza; b != nullptr && ajustando; b = b->siguiente) {
+                for (int i = b->inicio; i < b->cantidad; i++) {
+                    if (b->tiempos[i] >= ultimo) {
+                        ajustando = false;
+                        break;
+                    }
+                    b->tiempos[i] = ultimo;
+                }
+            }
+        }
+        for (Nodo<T>* b = otra.cabeza; b != nullptr; b = b->siguiente) {
+            b->secuencia = siguienteSecuencia++;
+        }
+        if (cola == nullptr) {
+            cabeza = otra.cabeza;
+        } else {
+            cola->siguiente = otra.cabeza;
+            otra.cabeza->anterior = cola;
+        }
+        cola = otra.cola;
+
+        if (tamanio == 0) {
+            minimo = otra.minimo;
+            maximo = otra.maximo;
+            extremosValidos = otra.extremosValidos;
+        } else if (extremosValidos && otra.extremosValidos) {
+            if (otra.minimo < minimo) minimo = otra.minimo;
+            if (maximo < otra.maximo) maximo = otra.maximo;
+        } else {
+            extremosValidos = false;
+        }
+        tamanio += otra.tamanio;
+        numBloques += otra.numBloques;
+        suma += otra.suma;
+        pool.adoptar(otra.pool);
+        LOG_DEPURACION("[Log] ListaSensor: " << otra.tamanio << " lecturas empalmadas.");
+
+        delete[] otra.indiceTiempo;
+        otra.soltar();
+        descartarIndiceTiempo();
+
+        aplicarRetencion();
+    }
+
+    /**
+     * @brief Intercala por marca de tiempo las lecturas de otra lista con las de ésta
+     * @param otra Lista origen (queda vacía)
+     *
+     * El resultado queda ordenado por marca; a igual marca van primero las
+     * lecturas de esta lista (la mezcla es estable). Si otra empieza
+     * después de la última lectura de ésta equivale a empalmar, sin copiar
+     * lecturas. Si no, cuesta O(n + m): se copian por tramos contiguos a
+     * bloques nuevos y los anteriores se liberan. Se conservan la política
+     * de retención y el archivo comprimido de esta lista y se aplica la
+     * retención al final; el archivo de otra, si lo tiene, se queda en otra.
+     */
+    void mezclar(ListaSensor& otra) {
+        if (this == &otra || otra.cabeza == nullptr) return;
+        if (cola == nullptr || otra.getPrimerTiempo() >= ultimoTiempo()) {
+            empalmar(otra);
+            return;
+        }
+
+        ListaSensor mezcla;
+        const Nodo<T>* a = cabeza;
+        const Nodo<T>* b = otra.cabeza;
+        int i = a->inicio;
+        int j = b->inicio;
+        while (a != nullptr && b != nullptr) {
+            // Tramo de a con marca <= la actual de b, o de b con marca < la actual de a
+            long long limiteA = b->tiempos[j];
+            int k = i;
+            while (k < a->cantidad && a->tiempos[k] <= limiteA) k++;
+            mezcla.insertarVarias(a->datos + i, a->tiempos + i, k - i);
+            i = k;
+            if (i == a->cantidad) {
+                a = a->siguiente;
+                if (a != nullptr) i = a->inicio;
+                continue;
+            }
+            long long limiteB = a->tiempos[i];
+            k = j;
+            while (k < b->cantidad && b->tiempos[k] < limiteB) k++;
+            mezcla.insertarVarias(b->datos + j, b->tiempos + j, k - j);
+            j = k;
+            if (j == b->cantidad) {
+                b = b->siguiente;
+                if (b != nullptr) j = b->inicio;
+            }
+        }
+        for (; a != nullptr; a = a->siguiente, i = a != nullptr ? a->inicio : 0) {
+            mezcla.insertarVarias(a->datos + i, a->tiempos + i, a->cantidad - i);
+        }
+        for (; b != nullptr; b = b->siguiente, j = b != nullptr ? b->inicio : 0) {
+            mezcla.insertarVarias(b->datos + j, b->tiempos + j, b->cantidad - j);
+        }
+        LOG_DEPURACION("[Log] ListaSensor: " << otra.tamanio << " lecturas mezcladas por tiempo.");
+
+        // La mezcla toma el lugar de los bloques; la política, el archivo y
+        // las descartadas son de esta lista
+        PoliticaRetencion politica = retencion;
+        ArchivoComprimido<T>* archivoPropio = archivo;
+        long long descartadasPropias = descartadas;
+        archivo = nullptr;
+        *this = std::move(mezcla);
+        retencion = politica;
+        archivo = archivoPropio;
+        descartadas = descartadasPropias;
+
+        ArchivoComprimido<T>* archivoOtra = otra.archivo;
+        otra.archivo = nullptr;
+        otra.liberarTodo();
+        otra.archivo = archivoOtra;
+
+        aplicarRetencion();
+    }
+
+    /**
+     * @brief Cambia la política de retención y la aplica de inmediato
+     * @param politica Nuevos límites
+     */
+    void setRetencion(const PoliticaRetencion& politica) {
+        retencion = politica;
+        if (retencion.lecturasArchivo > 0) {
+            if (archivo == nullptr) {
+                archivo = new ArchivoComprimido<T>(retencion.lecturasArchivo);
+            } else {
+                archivo->setMaxLecturas(retencion.lecturasArchivo);
+            }
         } else {
-            Nodo<T>* actual = cabeza;
-            while (actual->siguiente != nullptr) {
-                actual = actual->siguiente;
+            delete archivo;
+            archivo = nullptr;
+        }
+        aplicarRetencion();
+    }
+
+    /**
+     * @brief Política de retención vigente
+     */
+    const PoliticaRetencion& getRetencion() const {
+        return retencion;
+    }
+
+    /**
+     * @brief Archivo comprimido de lecturas descartadas
+     * @return nullptr si la política no conserva lecturas descartadas
+     */
+    const ArchivoComprimido<T>* getArchivo() const {
+        return archivo;
+    }
+
+    /**
+     * @brief Descarta lo que exceda la política sin esperar a una inserción
+     *
+     * Útil para que un sensor sin lecturas nuevas también envejezca.
+     */
+    void aplicarRetencion() {
+        if (retencion.maxLecturas > 0) {
+            while (tamanio > retencion.maxLecturas) {
+                descartarMasAntigua();
             }
-            actual->siguiente = nuevo;
         }
-        tamanio++;
+        if (retencion.maxEdadMs > 0) {
+            descartarAnterioresA(relojMs() - retencion.maxEdadMs);
+        }
+    }
+
+    /**
+     * @brief Lecturas descartadas por la política de retención
+     */
+    long long getDescartadas() const {
+        return descartadas;
+    }
+
+    /**
+     * @brief Indica si ninguna lectura con marca desde t0 se perdió por la retención
+     * @param t0 Instante (ms)
+     * @return true si resumirRango() ve todas las lecturas de [t0, ...)
+     *
+     * La retención descarta por orden de marca, así que lo perdido (lo
+     * descartado que no quedó en el archivo) no es posterior a la lectura
+     * más antigua que se conserva.
+     */
+    bool conservaDesde(long long t0) const {
+        long long perdidas = descartadas - (archivo != nullptr ? archivo->getTamanio() : 0);
+        if (perdidas <= 0) return true;
+        if (archivo != nullptr && !archivo->estaVacio()) return t0 > archivo->getPrimerTiempo();
+        return cabeza != nullptr && t0 > getPrimerTiempo();
+    }
+
+    /**
+     * @brief Conteo, suma, mínimo y máximo de las lecturas con marca en [t0, t1)
+     * @param t0 Inicio del intervalo (ms, incluido)
+     * @param t1 Fin del intervalo (ms, excluido)
+     * @return Resumen de la ventana (vacío si no hay lecturas en ella)
+     *
+     * O(log n + k) con k lecturas en el intervalo. La primera consulta
+     * construye el índice de tiempo en O(n / CAPACIDAD). Con archivo
+     * comprimido también se cuentan las lecturas descartadas que conserva.
+     */
+    ResumenVentana resumirRango(long long t0, long long t1) const {
+        ResumenVentana resumen;
+        if (t1 <= t0) return resumen;
+        if (archivo != nullptr && !archivo->estaVacio() && archivo->getPrimerTiempo() < t1) {
+            resumen = archivo->resumirRango(t0, t1);
+        }
+        if (cola == nullptr) return resumen;
+        if (indiceTiempo == nullptr) {
+            construirIndiceTiempo();
+        }
+
+        // Primer bloque cuya última lectura no es anterior a t0
+        int bajo = inicioIndice;
+        int alto = finIndice;
+        while (bajo < alto) {
+            int medio = bajo + (alto - bajo) / 2;
+            const Nodo<T>* b = indiceTiempo[medio];
+            if (b->tiempos[b->cantidad - 1] < t0) {
+                bajo = medio + 1;
+            } else {
+                alto = medio;
+            }
+        }
+        if (bajo == finIndice) return resumen;
+
+        const Nodo<T>* bloque = indiceTiempo[bajo];
+        int i = bloque->inicio;
+        while (bloque->tiempos[i] < t0) {
+            i++;
+        }
+        if (bloque->tiempos[i] >= t1) return resumen;
+
+        // Los bloques que terminan antes de t1 se agregan completos, sin
+        // mirar las marcas; sólo el último se recorta
+        T minimoVentana = bloque->datos[i];
+        T maximoVentana = bloque->datos[i];
+        double sumaVentana = 0.0;
+        long long cantidadVentana = 0;
+        while (bloque != nullptr) {
+            int fin = bloque->cantidad;
+            bool ultimo = bloque->tiempos[fin - 1] >= t1;
+            while (fin > i && bloque->tiempos[fin - 1] >= t1) {
+                fin--;
+            }
+            if (fin > i) {
+                double sumaBloque;
+                T minimoBloque;
+                T maximoBloque;
+                resumirBloque(bloque->datos + i, fin - i, sumaBloque, minimoBloque, maximoBloque);
+                sumaVentana += sumaBloque;
+                if (minimoBloque < minimoVentana) minimoVentana = minimoBloque;
+                if (maximoVentana < maximoBloque) maximoVentana = maximoBloque;
+            }
+            cantidadVentana += fin - i;
+            if (ultimo) break;
+            bloque = bloque->siguiente;
+            if (bloque != nullptr) i = bloque->inicio;
+        }
+
+        if (resumen.cantidad == 0) {
+            resumen.minimo = static_cast<double>(minimoVentana);
+            resumen.maximo = static_cast<double>(maximoVentana);
+        } else {
+            if (minimoVentana < resumen.minimo) resumen.minimo = static_cast<double>(minimoVentana);
+            if (resumen.maximo < maximoVentana) resumen.maximo = static_cast<double>(maximoVentana);
+        }
+        resumen.cantidad += cantidadVentana;
+        resumen.suma += sumaVentana;
+        return resumen;
+    }
+
+    /**
+     * @brief Resumen de las lecturas de los últimos ventanaMs milisegundos
+     * @param ventanaMs Duración de la ventana (ms)
+     * @return Resumen de [ahora - ventanaMs, ahora]
+     */
+    ResumenVentana resumirUltimos(long long ventanaMs) const {
+        long long ahora = relojMs();
+        return resumirRango(ahora - ventanaMs, ahora + 1);
+    }
+
+    /**
+     * @brief Marca de tiempo de la lectura más antigua (0 si está vacía)
+     */
+    long long getPrimerTiempo() const {
+        return cabeza != nullptr ? cabeza->tiempos[cabeza->inicio] : 0;
+    }
+
+    /**
+     * @brief Marca de tiempo de la lectura más reciente (0 si está vacía)
+     */
+    long long getUltimoTiempo() const {
+        return cola != nullptr ? ultimoTiempo() : 0;
     }
 
     /**
@@ -110,12 +981,10 @@ public:
      * @return true si el valor existe, false en caso contrario
      */
     bool buscar(T valor) const {
-        Nodo<T>* actual = cabeza;
-        while (actual != nullptr) {
-            if (actual->dato == valor) {
+        for (IteradorBloque it = bloques(); it; ++it) {
+            if (buscarEnBloque(it.datos(), it.cantidad(), valor) < it.cantidad()) {
                 return true;
             }
-            actual = actual->siguiente;
         }
         return false;
     }
@@ -123,63 +992,113 @@ public:
     /**
      * @brief Calcula el promedio de los elementos (requiere tipo numérico)
      * @return Promedio de los elementos
+     *
+     * Complejidad O(1): usa la suma acumulada.
      */
     T calcularPromedio() const {
         if (tamanio == 0) return static_cast<T>(0);
-        
-        T suma = static_cast<T>(0);
-        Nodo<T>* actual = cabeza;
-        while (actual != nullptr) {
-            suma += actual->dato;
-            actual = actual->siguiente;
-        }
-        return suma / static_cast<T>(tamanio);
+        return static_cast<T>(suma / tamanio);
     }
 
     /**
      * @brief Encuentra y elimina el valor más bajo de la lista
      * @return Valor más bajo que fue eliminado
+     *
+     * Se elimina la primera aparición del mínimo. La primera llamada
+     * construye el índice de mínimos en O(n); las siguientes cuestan O(log n).
      */
     T eliminarMasBajo() {
         if (cabeza == nullptr) {
             return static_cast<T>(0);
         }
-
-        // Encontrar el valor más bajo
-        Nodo<T>* actual = cabeza;
-        T minimo = cabeza->dato;
-        while (actual != nullptr) {
-            if (actual->dato < minimo) {
-                minimo = actual->dato;
-            }
-            actual = actual->siguiente;
+        if (monticulo == nullptr) {
+            construirMonticulo();
         }
 
-        // Eliminar el primer nodo con el valor mínimo
-        if (cabeza->dato == minimo) {
-            Nodo<T>* temp = cabeza;
-            cabeza = cabeza->siguiente;
-            std::cout << "[Log] Nodo<T> " << temp->dato << " liberado." << std::endl;
-            delete temp;
-            tamanio--;
-        } else {
-            Nodo<T>* anterior = cabeza;
-            actual = cabeza->siguiente;
-            while (actual != nullptr && actual->dato != minimo) {
-                anterior = actual;
-                actual = actual->siguiente;
-            }
-            if (actual != nullptr) {
-                anterior->siguiente = actual->siguiente;
-                std::cout << "[Log] Nodo<T> " << actual->dato << " liberado." << std::endl;
-                delete actual;
-                tamanio--;
-            }
+        Manejador raiz = monticulo[0];
+        T valor = raiz.bloque->datos[raiz.pos];
+        LOG_TRAZA("[Log] Nodo<T> " << valor << " liberado.");
+
+        bool validosAntes = extremosValidos;
+        quitarDeMonticulo(0);
+        quitarLectura(raiz.bloque, raiz.pos);
+
+        // El nuevo mínimo es la raíz del montículo; quitar el mínimo no
+        // cambia el máximo de las lecturas restantes
+        if (tamMonticulo > 0 && validosAntes) {
+            minimo = monticulo[0].bloque->datos[monticulo[0].pos];
+            extremosValidos = true;
         }
+        return valor;
+    }
+
+    /**
+     * @brief Obtiene la suma acumulada de las lecturas
+     * @return Suma de todos los elementos
+     */
+    double getSuma() const {
+        return suma;
+    }
 
+    /**
+     * @brief Obtiene el valor mínimo de la lista
+     * @return Mínimo (0 si la lista está vacía)
+     */
+    T getMinimo() const {
+        if (tamanio == 0) return static_cast<T>(0);
+        recalcularExtremos();
         return minimo;
     }
 
+    /**
+     * @brief Obtiene el valor máximo de la lista
+     * @return Máximo (0 si la lista está vacía)
+     */
+    T getMaximo() const {
+        if (tamanio == 0) return static_cast<T>(0);
+        recalcularExtremos();
+        return maximo;
+    }
+
+    /**
+     * @brief Varianza poblacional de las lecturas de la lista
+     * @return Varianza (0 si la lista está vacía)
+     *
+     * Dos pasadas en una: la media sale de la suma acumulada en O(1) y las
+     * desviaciones se suman bloque a bloque con desviacionBloque. Las
+     * lecturas del archivo comprimido no cuentan, igual que en
+     * calcularPromedio.
+     */
+    double calcularVarianza() const {
+        if (tamanio == 0) return 0.0;
+        double media = suma / tamanio;
+        double acumulado = 0.0;
+        for (IteradorBloque it = bloques(); it; ++it) {
+            acumulado += desviacionBloque(it.datos(), it.cantidad(), media);
+        }
+        return acumulado / tamanio;
+    }
+
+    /**
+     * @brief Primera lectura con el valor mínimo y su marca de tiempo
+     * @param valor Destino del valor
+     * @param tiempo Destino de la marca (ms)
+     * @return false si la lista está vacía
+     */
+    bool buscarMinimo(T& valor, long long& tiempo) const {
+        return ubicarExtremo(valor, tiempo, true);
+    }
+
+    /**
+     * @brief Primera lectura con el valor máximo y su marca de tiempo
+     * @param valor Destino del valor
+     * @param tiempo Destino de la marca (ms)
+     * @return false si la lista está vacía
+     */
+    bool buscarMaximo(T& valor, long long& tiempo) const {
+        return ubicarExtremo(valor, tiempo, false);
+    }
+
     /**
      * @brief Obtiene el tamaño de la lista
      * @return Número de elementos en la lista
@@ -188,6 +1107,34 @@ public:
         return tamanio;
     }
 
+    /**
+     * @brief Obtiene el número de bloques reservados
+     * @return Número de nodos de la lista
+     */
+    int getNumeroBloques() const {
+        return numBloques;
+    }
+
+    /**
+     * @brief Memoria ocupada por los nodos de la lista
+     * @return Bytes reservados para los bloques, los índices y el archivo comprimido
+     */
+    long long memoriaUsada() const {
+        return pool.estadisticas().bytesReservados
+             + static_cast<long long>(capMonticulo) * static_cast<long long>(sizeof(Manejador))
+             + poolPosiciones.estadisticas().bytesReservados
+             + static_cast<long long>(capIndice) * static_cast<long long>(sizeof(Nodo<T>*))
+             + (archivo != nullptr ? archivo->memoriaUsada() : 0);
+    }
+
+    /**
+     * @brief Estadísticas del asignador de bloques de la lista
+     * @return Contadores de reservas, liberaciones y losas
+     */
+    EstadisticasPool getEstadisticasPool() const {
+        return pool.estadisticas();
+    }
+
     /**
      * @brief Verifica si la lista está vacía
      * @return true si está vacía, false en caso contrario
@@ -196,31 +1143,494 @@ public:
         return cabeza == nullptr;
     }
 
+    /**
+     * @brief Obtiene un iterador al primer bloque de la lista
+     * @return Iterador de bloques
+     */
+    IteradorBloque bloques() const {
+        return IteradorBloque(cabeza);
+    }
+
     /**
      * @brief Imprime todos los elementos de la lista
      */
     void imprimir() const {
-        Nodo<T>* actual = cabeza;
         std::cout << "[ ";
-        while (actual != nullptr) {
-            std::cout << actual->dato << " ";
-            actual = actual->siguiente;
+        for (IteradorBloque it = bloques(); it; ++it) {
+            const T* datos = it.datos();
+            for (int i = 0; i < it.cantidad(); i++) {
+                std::cout << datos[i] << " ";
+            }
         }
         std::cout << "]" << std::endl;
     }
 
 private:
+    /**
+     * @brief Reserva un bloque vacío y lo enlaza al final de la lista
+     */
+    void agregarBloque() {
+        Nodo<T>* nuevo = pool.crear(siguienteSecuencia++);
+        if (cola == nullptr) {
+            cabeza = nuevo;
+        } else {
+            cola->siguiente = nuevo;
+            nuevo->anterior = cola;
+        }
+        cola = nuevo;
+        numBloques++;
+        if (monticulo != nullptr) {
+            nuevo->posMonticulo = poolPosiciones.crear();
+        }
+        if (indiceTiempo != nullptr) {
+            agregarAlIndice(nuevo);
+        }
+    }
+
+    /**
+     * @brief Desenlaza y libera un bloque vacío
+     * @param bloque Bloque a liberar
+     *
+     * En los extremos el índice de tiempo se recorta en O(1); un bloque
+     * intermedio (vaciado por eliminarMasBajo) lo invalida.
+     */
+    void quitarBloque(Nodo<T>* bloque) {
+        if (indiceTiempo != nullptr) {
+            if (bloque == indiceTiempo[inicioIndice]) {
+                inicioIndice++;
+            } else if (bloque == indiceTiempo[finIndice - 1]) {
+                finIndice--;
+            } else {
+                descartarIndiceTiempo();
+            }
+        }
+        if (bloque->anterior == nullptr) {
+            cabeza = bloque->siguiente;
+        } else {
+            bloque->anterior->siguiente = bloque->siguiente;
+        }
+        if (bloque->siguiente == nullptr) {
+            cola = bloque->anterior;
+        } else {
+            bloque->siguiente->anterior = bloque->anterior;
+        }
+        poolPosiciones.destruir(bloque->posMonticulo);
+        pool.destruir(bloque);
+        numBloques--;
+    }
+
+    /**
+     * @brief Quita una lectura de su bloque y actualiza los agregados
+     * @param bloque Bloque que contiene la lectura
+     * @param pos Posición de la lectura en el bloque
+     *
+     * Las lecturas posteriores del bloque se desplazan una posición para
+     * conservar el orden; sus entradas en el montículo se corrigen.
+     */
+    void quitarLectura(Nodo<T>* bloque, int pos) {
+        T valor = bloque->datos[pos];
+        for (int i = pos + 1; i < bloque->cantidad; i++) {
+            bloque->datos[i - 1] = bloque->datos[i];
+            bloque->tiempos[i - 1] = bloque->tiempos[i];
+            if (monticulo != nullptr) {
+                int enMonticulo = bloque->posMonticulo->pos[i];
+                bloque->posMonticulo->pos[i - 1] = enMonticulo;
+                monticulo[enMonticulo].pos = i - 1;
+            }
+        }
+        bloque->cantidad--;
+        tamanio--;
+        descontar(valor);
+
+        if (bloque->cantidad == bloque->inicio) {
+            quitarBloque(bloque);
+        }
+    }
+
+    /**
+     * @brief Marca de la última lectura (requiere cola != nullptr)
+     */
+    long long ultimoTiempo() const {
+        return cola->tiempos[cola->cantidad - 1];
+    }
+
+    /**
+     * @brief Agrega un bloque al final del índice de tiempo
+     * @param bloque Bloque recién enlazado en la cola
+     *
+     * Si no queda espacio al final, las entradas vigentes se recorren al
+     * principio o, si ocupan más de la mitad, el arreglo crece al doble.
+     */
+    void agregarAlIndice(Nodo<T>* bloque) {
+        if (finIndice == capIndice) {
+            int vigentes = finIndice - inicioIndice;
+            Nodo<T>** destino = indiceTiempo;
+            if (vigentes * 2 > capIndice) {
+                capIndice *= 2;
+                destino = new Nodo<T>*[capIndice];
+            }
+            for (int i = 0; i < vigentes; i++) {
+                destino[i] = indiceTiempo[inicioIndice + i];
+            }
+            if (destino != indiceTiempo) {
+                delete[] indiceTiempo;
+                indiceTiempo = destino;
+            }
+            inicioIndice = 0;
+            finIndice = vigentes;
+        }
+        indiceTiempo[finIndice++] = bloque;
+    }
+
+    /**
+     * @brief Construye el índice de tiempo con todos los bloques (O(bloques))
+     */
+    void construirIndiceTiempo() const {
+        capIndice = numBloques > 16 ? numBloques : 16;
+        indiceTiempo = new Nodo<T>*[capIndice];
+        inicioIndice = 0;
+        finIndice = 0;
+        for (Nodo<T>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            indiceTiempo[finIndice++] = actual;
+        }
+    }
+
+    /**
+     * @brief Libera el índice de tiempo (se reconstruye en la próxima consulta)
+     */
+    void descartarIndiceTiempo() {
+        delete[] indiceTiempo;
+        indiceTiempo = nullptr;
+        inicioIndice = 0;
+        finIndice = 0;
+        capIndice = 0;
+    }
+
+    /**
+     * @brief Descarta la lectura más antigua (la primera de la cabeza)
+     *
+     * O(1) sin índice de mínimos y O(log n) con él: no hay desplazamiento,
+     * sólo avanza el inicio del bloque. Con archivo la lectura se comprime
+     * en él en lugar de perderse.
+     */
+    void descartarMasAntigua() {
+        Nodo<T>* bloque = cabeza;
+        int pos = bloque->inicio;
+        T valor = bloque->datos[pos];
+        LOG_TRAZA("[Log] Nodo<T> " << valor << " descartado por retención.");
+        if (archivo != nullptr) {
+            archivo->agregar(valor, bloque->tiempos[pos]);
+        }
+
+        bool validosAntes = extremosValidos;
+        if (monticulo != nullptr) {
+            quitarDeMonticulo(bloque->posMonticulo->pos[pos]);
+        }
+        bloque->inicio++;
+        tamanio--;
+        descartadas++;
+        descontar(valor);
+        if (bloque->inicio == bloque->cantidad) {
+            quitarBloque(bloque);
+        }
+
+        // Si se fue el mínimo (y no el máximo), el índice da el nuevo en O(1)
+        if (monticulo != nullptr && tamMonticulo > 0 && validosAntes && !extremosValidos && valor < maximo) {
+            minimo = monticulo[0].bloque->datos[monticulo[0].pos];
+            extremosValidos = true;
+        }
+    }
+
+    /**
+     * @brief Descarta las lecturas con marca anterior a un instante
+     * @param limite Instante (ms); se conserva desde él en adelante
+     *
+     * Como las marcas no decrecen, basta mirar la cabeza: O(1) si no hay
+     * nada que descartar.
+     */
+    void descartarAnterioresA(long long limite) {
+        while (cabeza != nullptr && cabeza->tiempos[cabeza->inicio] < limite) {
+            descartarMasAntigua();
+        }
+    }
+
+    /**
+     * @brief Incorpora un valor a la suma y a los extremos
+     * @param valor Valor insertado
+     */
+    void acumular(T valor) {
+        suma += valor;
+        if (tamanio == 1) {
+            minimo = valor;
+            maximo = valor;
+            extremosValidos = true;
+        } else if (extremosValidos) {
+            if (valor < minimo) minimo = valor;
+            if (maximo < valor) maximo = valor;
+        }
+    }
+
+    /**
+     * @brief Retira un valor de la suma y marca los extremos afectados
+     * @param valor Valor eliminado
+     */
+    void descontar(T valor) {
+        if (tamanio == 0) {
+            suma = 0.0;
+            extremosValidos = true;
+            return;
+        }
+        suma -= valor;
+        if (!(minimo < valor) || !(valor < maximo)) {
+            extremosValidos = false;
+        }
+    }
+
+    /**
+     * @brief Recalcula mínimo y máximo con un recorrido si están desactualizados
+     */
+    void recalcularExtremos() const {
+        if (extremosValidos) return;
+        minimo = cabeza->datos[cabeza->inicio];
+        maximo = cabeza->datos[cabeza->inicio];
+        for (IteradorBloque it = bloques(); it; ++it) {
+            double sumaBloque;
+            T minimoBloque;
+            T maximoBloque;
+            resumirBloque(it.datos(), it.cantidad(), sumaBloque, minimoBloque, maximoBloque);
+            if (minimoBloque < minimo) minimo = minimoBloque;
+            if (maximo < maximoBloque) maximo = maximoBloque;
+        }
+        extremosValidos = true;
+    }
+
+    /**
+     * @brief Primera lectura con el valor mínimo (o máximo) y su marca
+     * @param minimoBuscado true para el mínimo, false para el máximo
+     *
+     * Cada bloque aporta la posición de su extremo; sólo un extremo
+     * estrictamente mejor reemplaza al anterior, así gana la primera aparición.
+     */
+    bool ubicarExtremo(T& valor, long long& tiempo, bool minimoBuscado) const {
+        if (tamanio == 0) return false;
+        bool hay = false;
+        for (IteradorBloque it = bloques(); it; ++it) {
+            int pos = minimoBuscado ? posicionMinimoEnBloque(it.datos(), it.cantidad())
+                                    : posicionMaximoEnBloque(it.datos(), it.cantidad());
+            T candidato = it.datos()[pos];
+            if (!hay || (minimoBuscado ? candidato < valor : valor < candidato)) {
+                valor = candidato;
+                tiempo = it.tiempos()[pos];
+                hay = true;
+            }
+        }
+        return hay;
+    }
+
+    /**
+     * @brief Compara dos manejadores por valor y, en empate, por orden en la lista
+     * @return true si a debe quedar por encima de b en el montículo
+     */
+    static bool menor(const Manejador& a, const Manejador& b) {
+        T va = a.bloque->datos[a.pos];
+        T vb = b.bloque->datos[b.pos];
+        if (va < vb) return true;
+        if (vb < va) return false;
+        if (a.bloque != b.bloque) return a.bloque->secuencia < b.bloque->secuencia;
+        return a.pos < b.pos;
+    }
+
+    /**
+     * @brief Coloca un manejador en una posición del montículo
+     * @param i Posición destino
+     * @param m Manejador a colocar
+     */
+    void colocar(int i, const Manejador& m) {
+        monticulo[i] = m;
+        m.bloque->posMonticulo->pos[m.pos] = i;
+    }
+
+    /**
+     * @brief Hace subir un elemento del montículo hasta su lugar
+     * @param i Posición inicial
+     */
+    void subir(int i) {
+        Manejador m = monticulo[i];
+        while (i > 0) {
+            int padre = (i - 1) / 2;
+            if (!menor(m, monticulo[padre])) break;
+            colocar(i, monticulo[padre]);
+            i = padre;
+        }
+        colocar(i, m);
+    }
+
+    /**
+     * @brief Hace bajar un elemento del montículo hasta su lugar
+     * @param i Posición inicial
+     */
+    void bajar(int i) {
+        Manejador m = monticulo[i];
+        while (true) {
+            int hijo = 2 * i + 1;
+            if (hijo >= tamMonticulo) break;
+            if (hijo + 1 < tamMonticulo && menor(monticulo[hijo + 1], monticulo[hijo])) {
+                hijo++;
+            }
+            if (!menor(monticulo[hijo], m)) break;
+            colocar(i, monticulo[hijo]);
+            i = hijo;
+        }
+        colocar(i, m);
+    }
+
+    /**
+     * @brief Agrega la lectura (bloque, pos) al montículo
+     */
+    void insertarEnMonticulo(Nodo<T>* bloque, int pos) {
+        if (tamMonticulo == capMonticulo) {
+            int nuevaCap = capMonticulo > 0 ? capMonticulo * 2 : 16;
+            Manejador* nuevo = new Manejador[nuevaCap];
+            for (int i = 0; i < tamMonticulo; i++) {
+                nuevo[i] = monticulo[i];
+            }
+            delete[] monticulo;
+            monticulo = nuevo;
+            capMonticulo = nuevaCap;
+        }
+        Manejador m = { bloque, pos };
+        colocar(tamMonticulo++, m);
+        subir(tamMonticulo - 1);
+    }
+
+    /**
+     * @brief Retira la entrada en la posición i del montículo
+     * @param i Posición a retirar
+     */
+    void quitarDeMonticulo(int i) {
+        tamMonticulo--;
+        if (i == tamMonticulo) return;
+        colocar(i, monticulo[tamMonticulo]);
+        if (i > 0 && menor(monticulo[i], monticulo[(i - 1) / 2])) {
+            subir(i);
+        } else {
+            bajar(i);
+        }
+    }
+
+    /**
+     * @brief Construye el montículo de mínimos con todas las lecturas (O(n))
+     */
+    void construirMonticulo() {
+        capMonticulo = tamanio > 16 ? tamanio : 16;
+        monticulo = new Manejador[capMonticulo];
+        tamMonticulo = 0;
+        for (Nodo<T>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            actual->posMonticulo = poolPosiciones.crear();
+            for (int i = actual->inicio; i < actual->cantidad; i++) {
+                Manejador m = { actual, i };
+                colocar(tamMonticulo++, m);
+            }
+        }
+        for (int i = tamMonticulo / 2 - 1; i >= 0; i--) {
+            bajar(i);
+        }
+    }
+
+    /**
+     * @brief Libera el montículo y las posiciones de los bloques (O(bloques))
+     *
+     * eliminarMasBajo lo reconstruye cuando vuelva a necesitarse.
+     */
+    void descartarMonticulo() {
+        if (monticulo == nullptr) return;
+        for (Nodo<T>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            actual->posMonticulo = nullptr;
+        }
+        poolPosiciones.liberarTodo();
+        delete[] monticulo;
+        monticulo = nullptr;
+        tamMonticulo = 0;
+        capMonticulo = 0;
+    }
+
+    /**
+     * @brief Copia los bloques de otra lista en orden (O(n))
+     * @param otra Lista origen
+     */
+    void copiarDesde(const ListaSensor& otra) {
+        for (const Nodo<T>* origen = otra.cabeza; origen != nullptr; origen = origen->siguiente) {
+            agregarBloque();
+            int n = origen->cantidad - origen->inicio;
+            for (int i = 0; i < n; i++) {
+                cola->datos[i] = origen->datos[origen->inicio + i];
+                cola->tiempos[i] = origen->tiempos[origen->inicio + i];
+            }
+            cola->cantidad = n;
+            tamanio += n;
+        }
+        suma = otra.suma;
+        minimo = otra.minimo;
+        maximo = otra.maximo;
+        extremosValidos = otra.extremosValidos;
+    }
+
+    /**
+     * @brief Deja la lista vacía sin liberar nada (sus bloques ya tienen otro dueño)
+     *
+     * El archivo comprimido no se toca: quien lo transfiera debe anularlo.
+     */
+    void soltar() {
+        cabeza = nullptr;
+        cola = nullptr;
+        tamanio = 0;
+        numBloques = 0;
+        siguienteSecuencia = 0;
+        descartadas = 0;
+        suma = 0.0;
+        extremosValidos = true;
+        monticulo = nullptr;
+        tamMonticulo = 0;
+        capMonticulo = 0;
+        indiceTiempo = nullptr;
+        inicioIndice = 0;
+        finIndice = 0;
+        capIndice = 0;
+    }
+
     /**
      * @brief Libera toda la memoria de la lista
+     *
+     * Los bloques no se liberan uno por uno: el pool devuelve sus losas
+     * completas al sistema. Sólo se recorren las lecturas si el nivel
+     * TRAZA está activo.
      */
     void liberarTodo() {
-        while (cabeza != nullptr) {
-            Nodo<T>* temp = cabeza;
-            cabeza = cabeza->siguiente;
-            std::cout << "[Log] Nodo<T> " << temp->dato << " liberado." << std::endl;
-            delete temp;
+#if IOT_LOG_NIVEL_COMPILACION <= 0
+        if (Log::habilitado(NivelLog::TRAZA)) {
+            for (IteradorBloque it = bloques(); it; ++it) {
+                for (int i = 0; i < it.cantidad(); i++) {
+                    LOG_TRAZA("[Log] Nodo<T> " << it.datos()[i] << " liberado.");
+                }
+            }
         }
+#endif
+        pool.liberarTodo();
+        poolPosiciones.liberarTodo();
+        cabeza = nullptr;
+        cola = nullptr;
         tamanio = 0;
+        numBloques = 0;
+        descartadas = 0;
+        suma = 0.0;
+        extremosValidos = true;
+        delete[] monticulo;
+        monticulo = nullptr;
+        tamMonticulo = 0;
+        capMonticulo = 0;
+        descartarIndiceTiempo();
+        delete archivo;
+        archivo = nullptr;
     }
 };
 
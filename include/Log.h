@@ -0,0 +1,267 @@
+/**
+ * @file Log.h
+ * @brief Subsistema de bitácora por niveles con escritura asíncrona
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+/**
+ * @brief Niveles de severidad de la bitácora (de menor a mayor)
+ */
+enum class NivelLog {
+    TRAZA = 0,          ///< Detalle por lectura/nodo (ruta caliente)
+    DEPURACION = 1,     ///< Ciclo de vida de listas y sensores
+    INFO = 2,           ///< Eventos normales del sistema
+    AVISO = 3,          ///< Situaciones anómalas recuperables
+    ERROR = 4,          ///< Errores
+    NINGUNO = 5         ///< Desactiva la bitácora
+};
+
+/**
+ * @brief Nivel mínimo compilado: los mensajes por debajo desaparecen del binario
+ *
+ * Se define desde CMake (IOT_LOG_NIVEL_COMPILACION). 0 = TRAZA ... 5 = NINGUNO.
+ */
+#ifndef IOT_LOG_NIVEL_COMPILACION
+#define IOT_LOG_NIVEL_COMPILACION 0
+#endif
+
+/**
+ * @brief Fachada estática de la bitácora
+ *
+ * Por defecto los mensajes se escriben de forma síncrona en std::cout sin
+ * forzar el vaciado. Tras iniciarAsincrono() los registros se copian en una
+ * cola sin bloqueos y un hilo de fondo los escribe, vaciando la salida sólo
+ * cuando la cola queda vacía. Si la cola se llena, los mensajes de TRAZA y
+ * DEPURACION se descartan y se contabilizan; los de INFO en adelante
+ * esperan a que el escritor libere espacio, así que nunca se pierden.
+ */
+class CapturaLog;
+
+class Log {
+public:
+    /// Longitud máxima de un mensaje (se trunca el resto)
+    static constexpr int LONGITUD_MAXIMA = 240;
+
+    /**
+     * @brief Cambia el nivel mínimo en tiempo de ejecución
+     * @param nivel Nuevo nivel mínimo
+     */
+    static void setNivel(NivelLog nivel);
+
+    /**
+     * @brief Obtiene el nivel mínimo en tiempo de ejecución
+     * @return Nivel actual
+     */
+    static NivelLog getNivel();
+
+    /**
+     * @brief Indica si un nivel está habilitado en tiempo de ejecución
+     * @param nivel Nivel a consultar
+     * @return true si los mensajes de ese nivel se emiten
+     */
+    static bool habilitado(NivelLog nivel);
+
+    /**
+     * @brief Convierte un texto (traza, depuracion, info, aviso, error, ninguno) en nivel
+     * @param texto Nombre del nivel
+     * @param nivel Destino del nivel reconocido
+     * @return false si el texto no corresponde a ningún nivel
+     */
+    static bool nivelDesdeTexto(const char* texto, NivelLog& nivel);
+
+    /**
+     * @brief Toma el nivel de la variable de entorno IOT_LOG_NIVEL si existe
+     */
+    static void configurarDesdeEntorno();
+
+    /**
+     * @brief Arranca el hilo escritor de fondo
+     *
+     * Registra detener() con atexit para que los mensajes pendientes se
+     * escriban antes de terminar el proceso.
+     */
+    static void iniciarAsincrono();
+
+    /**
+     * @brief Escribe los mensajes pendientes y detiene el hilo de fondo
+     */
+    static void detener();
+
+    /**
+     * @brief Espera a que se escriban los mensajes pendientes y vacía la salida
+     */
+    static void vaciar();
+
+    /**
+     * @brief Número de mensajes de TRAZA o DEPURACION descartados por cola llena
+     * @return Mensajes perdidos desde el inicio
+     */
+    static long long descartados();
+
+    /**
+     * @brief Publica un mensaje ya formateado
+     * @param nivel Nivel del mensaje
+     * @param texto Texto (sin salto de línea final)
+     * @param longitud Longitud del texto
+     */
+    static void publicar(NivelLog nivel, const char* texto, int longitud);
+
+private:
+    /**
+     * @brief Publica un mensaje sin pasar por la captura del hilo
+     */
+    static void publicarDirecto(NivelLog nivel, const char* texto, int longitud);
+};
+
+/**
+ * @brief Acumulador de un mensaje que se publica al destruirse
+ *
+ * Se usa a través de las macros LOG_*: formatea con operator<< sobre un
+ * arreglo fijo, sin reservar memoria.
+ */
+class RegistroLog {
+private:
+    NivelLog nivel;                         ///< Nivel del mensaje
+    char texto[Log::LONGITUD_MAXIMA + 1];   ///< Texto acumulado
+    int longitud;                           ///< Caracteres escritos
+
+    /**
+     * @brief Agrega texto al mensaje truncando si no cabe
+     * @param s Texto a agregar
+     * @param n Longitud del texto
+     */
+    void agregar(const char* s, int n);
+
+public:
+    /**
+     * @brief Constructor
+     * @param nivel Nivel del mensaje
+     */
+    explicit RegistroLog(NivelLog nivel);
+
+    /**
+     * @brief Destructor: publica el mensaje
+     */
+    ~RegistroLog();
+
+    RegistroLog(const RegistroLog&) = delete;               ///< No copiable
+    RegistroLog& operator=(const RegistroLog&) = delete;    ///< No asignable
+
+    RegistroLog& operator<<(const char* s);         ///< Agrega una cadena
+    RegistroLog& operator<<(char c);                ///< Agrega un carácter
+    RegistroLog& operator<<(int v);                 ///< Agrega un entero
+    RegistroLog& operator<<(long v);                ///< Agrega un entero largo
+    RegistroLog& operator<<(long long v);           ///< Agrega un entero largo
+    RegistroLog& operator<<(unsigned int v);        ///< Agrega un entero sin signo
+    RegistroLog& operator<<(unsigned long v);       ///< Agrega un entero sin signo
+    RegistroLog& operator<<(unsigned long long v);  ///< Agrega un entero sin signo
+    RegistroLog& operator<<(double v);              ///< Agrega un real (formato %g)
+};
+
+/**
+ * @brief Retiene los mensajes publicados por un hilo para emitirlos después
+ *
+ * Mientras está activa en un hilo, Log::publicar guarda los mensajes de ese
+ * hilo aquí en lugar de escribirlos. Permite que trabajos paralelos emitan
+ * su salida en un orden determinista. Las capturas pueden anidarse.
+ */
+class CapturaLog {
+private:
+    char* datos;            ///< Registros: nivel (1 byte), longitud (int) y texto
+    int tamanio;            ///< Bytes usados
+    int capacidad;          ///< Bytes reservados
+    CapturaLog* anterior;   ///< Captura activa antes de iniciar() en el mismo hilo
+
+    friend class Log;
+
+    /**
+     * @brief Copia un mensaje al final del búfer
+     * @param nivel Nivel del mensaje
+     * @param texto Texto del mensaje
+     * @param longitud Longitud del texto
+     */
+    void agregar(NivelLog nivel, const char* texto, int longitud);
+
+public:
+    /**
+     * @brief Constructor: captura vacía e inactiva (no reserva memoria)
+     */
+    CapturaLog();
+
+    /**
+     * @brief Destructor: libera el búfer (los mensajes no emitidos se pierden)
+     */
+    ~CapturaLog();
+
+    CapturaLog(const CapturaLog&) = delete;             ///< No copiable
+    CapturaLog& operator=(const CapturaLog&) = delete;  ///< No asignable
+
+    /**
+     * @brief Empieza a capturar los mensajes del hilo actual
+     */
+    void iniciar();
+
+    /**
+     * @brief Deja de capturar y restaura la captura anterior del hilo
+     */
+    void terminar();
+
+    /**
+     * @brief Publica los mensajes retenidos en orden y vacía la captura
+     */
+    void emitir();
+
+    /**
+     * @brief Indica si no hay mensajes retenidos
+     */
+    bool estaVacia() const;
+};
+
+/**
+ * @brief Emite un mensaje si el nivel está habilitado en ejecución
+ *
+ * La expresión sólo se evalúa cuando el mensaje se va a emitir.
+ */
+#define IOT_LOG(nivel, expr) \
+    do { \
+        if (Log::habilitado(nivel)) { \
+            RegistroLog registroLog_(nivel); \
+            registroLog_ << expr; \
+        } \
+    } while (0)
+
+#if IOT_LOG_NIVEL_COMPILACION <= 0
+#define LOG_TRAZA(expr) IOT_LOG(NivelLog::TRAZA, expr)
+#else
+#define LOG_TRAZA(expr) do { } while (0)
+#endif
+
+#if IOT_LOG_NIVEL_COMPILACION <= 1
+#define LOG_DEPURACION(expr) IOT_LOG(NivelLog::DEPURACION, expr)
+#else
+#define LOG_DEPURACION(expr) do { } while (0)
+#endif
+
+#if IOT_LOG_NIVEL_COMPILACION <= 2
+#define LOG_INFO(expr) IOT_LOG(NivelLog::INFO, expr)
+#else
+#define LOG_INFO(expr) do { } while (0)
+#endif
+
+#if IOT_LOG_NIVEL_COMPILACION <= 3
+#define LOG_AVISO(expr) IOT_LOG(NivelLog::AVISO, expr)
+#else
+#define LOG_AVISO(expr) do { } while (0)
+#endif
+
+#if IOT_LOG_NIVEL_COMPILACION <= 4
+#define LOG_ERROR(expr) IOT_LOG(NivelLog::ERROR, expr)
+#else
+#define LOG_ERROR(expr) do { } while (0)
+#endif
+
+#endif // LOG_H
@@ -0,0 +1,185 @@
+/**
+ * @file Metricas.h
+ * @brief Contadores por hilo e histogramas de latencia del sistema en ejecución
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <atomic>
+
+/**
+ * @brief Contadores de la ingesta
+ */
+enum class Contador : int {
+    BYTES_LEIDOS = 0,       ///< Bytes recibidos de las fuentes
+    LINEAS_LEIDAS,          ///< Líneas examinadas por el analizador
+    LINEAS_VALIDAS,         ///< Líneas que resultaron lecturas
+    LINEAS_RECHAZADAS,      ///< Líneas con error de campos, tipo, ID o valor
+    LECTURAS_REGISTRADAS,   ///< Lecturas guardadas en algún sensor
+    SENSORES_CREADOS,       ///< Sensores creados al aparecer en el flujo
+    CONFLICTOS_TIPO,        ///< Lecturas cuyo tipo no coincide con el sensor
+    TRAMAS,                 ///< Tramas binarias válidas
+    TRAMAS_INVALIDAS,       ///< Tramas con CRC incorrecto o truncadas
+    TRAMAS_PERDIDAS,        ///< Tramas que faltan según su número de secuencia
+    CANTIDAD                ///< Número de contadores (no es un contador)
+};
+
+/**
+ * @brief Operaciones cuya latencia se mide
+ */
+enum class Operacion : int {
+    BUSQUEDA = 0,   ///< Encontrar (o crear) el sensor de una lectura
+    INSERCION,      ///< Guardar la lectura en el historial del sensor
+    PROCESO,        ///< procesarLectura() de un sensor
+    CANTIDAD        ///< Número de operaciones (no es una operación)
+};
+
+/// Número de contadores
+static const int NUM_CONTADORES = static_cast<int>(Contador::CANTIDAD);
+/// Número de operaciones medidas
+static const int NUM_OPERACIONES = static_cast<int>(Operacion::CANTIDAD);
+
+/**
+ * @brief Cubetas logarítmico-lineales de un histograma de latencias (estilo HDR)
+ *
+ * Los valores menores que 16 ns tienen una cubeta cada uno; a partir de
+ * ahí cada potencia de 2 se divide en 16 cubetas iguales, así que el
+ * error relativo de cualquier cuantil es menor que 1/16 (6.25 %) en todo
+ * el rango, de 1 ns a 2^40 ns (unos 18 minutos; lo mayor se acumula en
+ * la última cubeta). Los límites de las potencias de 2 coinciden con
+ * límites de cubeta, de modo que se puede reducir a cubetas le=2^k.
+ */
+class CubetasLatencia {
+public:
+    /// Bits de subdivisión de cada potencia de 2
+    static const int BITS_SUBCUBETA = 4;
+    /// Cubetas por potencia de 2
+    static const int SUBCUBETAS = 1 << BITS_SUBCUBETA;
+    /// Potencia de 2 máxima representada
+    static const int BITS_MAXIMOS = 40;
+    /// Número total de cubetas
+    static const int CANTIDAD = (BITS_MAXIMOS - BITS_SUBCUBETA + 1) * SUBCUBETAS;
+
+    /**
+     * @brief Cubeta de un valor
+     * @param ns Latencia en ns (negativos cuentan como 0)
+     */
+    static int indice(long long ns) {
+        if (ns < SUBCUBETAS) return ns < 0 ? 0 : static_cast<int>(ns);
+        if (ns >= (1LL << BITS_MAXIMOS)) return CANTIDAD - 1;
+        int bits = 63 - __builtin_clzll(static_cast<unsigned long long>(ns));
+        int sub = static_cast<int>(ns >> (bits - BITS_SUBCUBETA)) & (SUBCUBETAS - 1);
+        return (bits - BITS_SUBCUBETA + 1) * SUBCUBETAS + sub;
+    }
+
+    /**
+     * @brief Menor valor que cae en una cubeta
+     * @param cubeta Índice (0 .. CANTIDAD; CANTIDAD da el final del rango)
+     */
+    static long long limiteInferior(int cubeta) {
+        if (cubeta < SUBCUBETAS) return cubeta;
+        int bits = cubeta / SUBCUBETAS + BITS_SUBCUBETA - 1;
+        long long sub = cubeta % SUBCUBETAS;
+        return (SUBCUBETAS + sub) << (bits - BITS_SUBCUBETA);
+    }
+};
+
+/**
+ * @brief Suma de las métricas de todos los hilos en un momento dado
+ */
+struct ResumenMetricas {
+    long long contadores[NUM_CONTADORES];       ///< Valor de cada Contador
+    long long cubetas[NUM_OPERACIONES][CubetasLatencia::CANTIDAD];  ///< Histograma de cada Operacion
+    long long muestras[NUM_OPERACIONES];        ///< Latencias medidas por operación
+    long long sumaNs[NUM_OPERACIONES];          ///< Suma de las latencias medidas (ns)
+    int hilos;                                  ///< Ranuras de hilo sumadas (sin la compartida)
+
+    /**
+     * @brief Valor de un contador
+     * @param c Contador
+     */
+    long long valor(Contador c) const {
+        return contadores[static_cast<int>(c)];
+    }
+
+    /**
+     * @brief Cuantil de las latencias de una operación
+     * @param op Operación
+     * @param fraccion Cuantil entre 0 y 1
+     * @return Punto medio (ns) de la cubeta que contiene el cuantil, o 0 sin muestras
+     */
+    long long cuantilNs(Operacion op, double fraccion) const;
+};
+
+/**
+ * @brief Fachada estática de las métricas del sistema
+ *
+ * Cada hilo escribe en su propia ranura (se asigna en su primer uso y se
+ * libera al terminar el hilo para que otro la reutilice, conservando sus
+ * sumas): los incrementos son carga y almacenamiento relajados, sin
+ * instrucciones atómicas de lectura-modificación-escritura ni líneas de
+ * caché compartidas. Quien exporta suma todas las ranuras con leer().
+ *
+ * La ingesta publica sus contadores una vez por bloque leído, no por
+ * línea. Las latencias de búsqueda e inserción se miden en una de cada
+ * MUESTREO lecturas (leer el reloj cuesta tanto como la inserción) y la de
+ * proceso en cada sensor. Mientras las métricas estén desactivadas (el
+ * estado inicial), cada punto de medición cuesta una carga y un salto.
+ */
+class Metricas {
+public:
+    /// Se mide la latencia de una de cada MUESTREO operaciones de búsqueda e inserción
+    static const unsigned int MUESTREO = 64;
+    /// Ranuras propias como máximo; los hilos adicionales comparten una con sumas atómicas
+    static const int MAX_RANURAS = 64;
+
+    /**
+     * @brief Activa o desactiva la recolección
+     * @param valor true para recolectar
+     */
+    static void activar(bool valor);
+
+    /**
+     * @brief Indica si la recolección está activa
+     */
+    static bool activas() {
+        return activadas.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Suma a un contador del hilo actual
+     * @param c Contador
+     * @param n Cantidad (sin efecto si es 0 o las métricas están desactivadas)
+     */
+    static void sumar(Contador c, long long n);
+
+    /**
+     * @brief Decide si la operación actual se mide
+     * @return true en una de cada MUESTREO llamadas del hilo (si están activas)
+     */
+    static bool muestrear();
+
+    /**
+     * @brief Registra una latencia medida en el histograma del hilo actual
+     * @param op Operación medida
+     * @param ns Duración en ns
+     */
+    static void registrarLatencia(Operacion op, long long ns);
+
+    /**
+     * @brief Suma las ranuras de todos los hilos
+     * @param destino Resumen a llenar (se sobrescribe completo)
+     *
+     * Se puede llamar desde cualquier hilo mientras los demás publican: cada
+     * valor es coherente por separado, aunque el conjunto no es atómico.
+     */
+    static void leer(ResumenMetricas& destino);
+
+private:
+    static std::atomic<bool> activadas;     ///< Recolección activa
+};
+
+#endif // METRICAS_H
@@ -0,0 +1,92 @@
+/**
+ * @file ModoLote.h
+ * @brief Modo no interactivo de ingesta masiva desde archivo, stdin o puerto serial
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef MODO_LOTE_H
+#define MODO_LOTE_H
+
+#include "MotorIngesta.h"
+#include "PoliticaRetencion.h"
+
+/// Fuentes --ingesta como máximo (IngestaMultipuerto::MAX_PUERTOS)
+static const int MAX_FUENTES_LOTE = 64;
+
+/**
+ * @brief Opciones de línea de comandos del modo por lotes
+ */
+struct OpcionesLote {
+    const char* fuente;         ///< Archivo, FIFO, dispositivo serial o "-" (stdin)
+    const char* fuentes[MAX_FUENTES_LOTE];  ///< Todas las fuentes --ingesta (fuentes[0] == fuente)
+    int numFuentes;             ///< Fuentes dadas; con más de una se usa IngestaMultipuerto
+    int baudios;                ///< Velocidad si la fuente es un puerto serial
+    long long procesarCada;     ///< Ejecutar el procesamiento cada N lecturas (0 = nunca)
+    bool procesarAlFinal;       ///< Ejecutar el procesamiento al terminar la fuente
+    bool mostrarEstado;         ///< Imprimir el estado de los sensores al terminar
+    bool pipeline;              ///< Ingesta multihilo (lector, analizadores, registradores)
+    int hilosAnalisis;          ///< Analizadores de la tubería
+    int hilosRegistro;          ///< Registradores de la tubería
+    int hilosProceso;           ///< Hilos del procesamiento (1 = secuencial, 0 = núcleos)
+    PoliticaRetencion retencion;    ///< Límites del historial de cada sensor
+    const char* instantanea;    ///< Instantánea a restaurar al inicio y guardar al final (o nullptr)
+    const char* diario;         ///< Diario de lecturas a reproducir al inicio y ampliar (o nullptr)
+    int diarioMs;               ///< Intervalo de confirmación en grupo del diario (ms)
+    bool diarioSincronizar;     ///< fsync en cada grupo del diario
+    FormatoFlujo formato;       ///< Texto, tramas binarias o detección automática
+    const char* metricas;       ///< Archivo o "unix:RUTA" donde exportar las métricas (o nullptr)
+    int metricasMs;             ///< Periodo de exportación de las métricas a archivo (ms)
+
+    /**
+     * @brief Constructor con valores por defecto
+     */
+    OpcionesLote()
+        : fuente(nullptr), fuentes(), numFuentes(0), baudios(9600), procesarCada(0),
+          procesarAlFinal(true), mostrarEstado(false),
+          pipeline(false), hilosAnalisis(2), hilosRegistro(2), hilosProceso(1), retencion(),
+          instantanea(nullptr), diario(nullptr), diarioMs(10), diarioSincronizar(true),
+          formato(FormatoFlujo::AUTOMATICO), metricas(nullptr), metricasMs(1000) {}
+};
+
+/**
+ * @brief Interpreta los argumentos del modo por lotes
+ * @param argc Número de argumentos
+ * @param argv Argumentos del programa
+ * @param opciones Destino de las opciones reconocidas
+ * @return false si faltan argumentos o alguno es inválido
+ */
+bool analizarArgumentosLote(int argc, char* argv[], OpcionesLote& opciones);
+
+/**
+ * @brief Muestra la ayuda del modo por lotes
+ * @param programa Nombre del ejecutable
+ */
+void mostrarUsoLote(const char* programa);
+
+/**
+ * @brief Ingiere la fuente completa sin menú ni límite de lecturas
+ * @param opciones Opciones de la ejecución
+ * @return Código de salida del proceso (0 si la fuente se pudo abrir)
+ *
+ * Lee la fuente en bloques hasta el fin de datos (o Ctrl+C), ejecuta el
+ * procesamiento polimórfico periódicamente y/o al final, y reporta el
+ * rendimiento: líneas/s, bytes/s y errores de análisis. Con --pipeline
+ * la ingesta corre en PipelineIngesta y el procesamiento sólo al final.
+ * Con --instantanea los sensores se restauran antes de leer la fuente y
+ * se guardan al terminar. Con --diario las lecturas del diario se
+ * reproducen después de la instantánea y cada lectura aceptada se anota
+ * en él; si además la instantánea se guarda bien, el diario se vacía
+ * porque su contenido ya está en ella. Con --formato texto|binario se
+ * envía al puerto el comando 'A' o 'B' para que el Arduino cambie de
+ * formato; por defecto se acepta cualquiera de los dos y cada fuente se
+ * queda con el primero que llega válido. Si --ingesta se repite,
+ * todas las fuentes se leen a la vez en un solo hilo con
+ * IngestaMultipuerto y al final se reportan también sus contadores por
+ * puerto. Con --metricas se activan Metricas y se exportan como texto de
+ * Prometheus a un archivo cada --metricas-ms, o bajo demanda en un socket
+ * Unix; con --pipeline las métricas por sensor sólo se incluyen al final.
+ */
+int ejecutarModoLote(const OpcionesLote& opciones);
+
+#endif // MODO_LOTE_H
@@ -0,0 +1,257 @@
+/**
+ * @file MotorIngesta.h
+ * @brief Ingesta de flujos TIPO,ID,VALOR hacia la lista de gestión
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef MOTOR_INGESTA_H
+#define MOTOR_INGESTA_H
+
+#include "ListaGeneral.h"
+#include "ParserLineas.h"
+#include <cstddef>
+
+class DiarioLecturas;
+
+/**
+ * @brief Contadores de una sesión de ingesta
+ */
+struct EstadisticasIngesta {
+    long long bytes;            ///< Bytes recibidos
+    long long lecturas;         ///< Lecturas registradas en algún sensor
+    long long sensoresCreados;  ///< Sensores creados al aparecer en el flujo
+    long long conflictosTipo;   ///< Lecturas cuyo tipo no coincide con el sensor existente
+    long long lineasLargas;     ///< Líneas descartadas por exceder el búfer
+    long long tramas;           ///< Tramas binarias válidas
+    long long tramasInvalidas;  ///< Tramas con CRC incorrecto o truncadas
+    long long tramasPerdidas;   ///< Tramas que faltan según los números de secuencia
+
+    /**
+     * @brief Suma los contadores de otra sesión (p. ej. de otro hilo)
+     * @param otras Estadísticas a sumar
+     */
+    void sumar(const EstadisticasIngesta& otras) {
+        bytes += otras.bytes;
+        lecturas += otras.lecturas;
+        sensoresCreados += otras.sensoresCreados;
+        conflictosTipo += otras.conflictosTipo;
+        lineasLargas += otras.lineasLargas;
+        tramas += otras.tramas;
+        tramasInvalidas += otras.tramasInvalidas;
+        tramasPerdidas += otras.tramasPerdidas;
+    }
+};
+
+/**
+ * @brief Formatos que acepta el motor en el flujo
+ */
+enum class FormatoFlujo {
+    AUTOMATICO,     ///< Texto o tramas: el primero que llega válido fija el formato
+    TEXTO,          ///< Sólo líneas TIPO,ID,VALOR
+    BINARIO         ///< Sólo tramas; los bytes fuera de una trama se descartan
+};
+
+/**
+ * @brief Convierte bloques de bytes en lecturas registradas en ListaGeneral
+ *
+ * Recibe bloques arbitrarios (no necesariamente alineados a líneas): las
+ * líneas completas se analizan en el mismo búfer y sólo el fragmento final
+ * incompleto se copia para unirlo con el siguiente bloque. Los sensores
+ * que no existen se crean con el tipo indicado en la línea. Todas las
+ * lecturas de un bloque llevan la marca de tiempo de su llegada. El ID
+ * se interna una vez por lectura en TablaNombres; desde ahí el sensor y
+ * el diario se consultan por IdNombre.
+ *
+ * En modo AUTOMATICO (el predeterminado) el motor acepta líneas de texto y
+ * tramas de TramaBinaria hasta recibir la primera línea válida o la
+ * primera trama con CRC correcto; desde ahí se queda con ese formato.
+ * Mientras tanto el byte de sincronía, que el texto nunca contiene, basta
+ * buscarlo con memchr para separar ambos. Fijar el formato evita que un
+ * byte 0xA5 de ruido en un flujo de texto se lleve los bytes siguientes
+ * (incluido el '\n') como si fueran una trama. En modo BINARIO, una trama
+ * con CRC inválido se descarta completa (o hasta la siguiente sincronía
+ * dentro de ella), con lo que el motor vuelve a sincronizarse.
+ */
+class MotorIngesta {
+private:
+    ListaGeneral& lista;            ///< Lista de gestión destino
+    ParserLineas parser;            ///< Analizador de líneas
+    EstadisticasIngesta stats;      ///< Contadores de la sesión
+    PoliticaRetencion retencion;    ///< Retención de los sensores que se crean
+    DiarioLecturas* diario;         ///< Diario donde se anotan las lecturas aceptadas (opcional)
+
+    FormatoFlujo formato;           ///< Formatos aceptados
+    FormatoFlujo formatoActivo;     ///< Formato en uso: en AUTOMATICO, el detectado (AUTOMATICO hasta entonces)
+    unsigned char secuenciaEsperada;    ///< Secuencia de la próxima trama
+    bool haySecuencia;              ///< Ya se recibió alguna trama válida
+    IdNombre idsTrama[2][128];      ///< IdNombre de cada [tipo T/P][canal] (NINGUNO hasta la primera trama)
+
+    EstadisticasIngesta publicadas; ///< Contadores ya sumados a Metricas
+    long long lineasPublicadas;     ///< parser.lineas ya sumadas a Metricas
+    long long validasPublicadas;    ///< parser.validas ya sumadas a Metricas
+    long long erroresPublicados;    ///< parser.errores() ya sumados a Metricas
+
+    char pendiente[256];            ///< Fragmento de línea o de trama sin terminar
+    size_t tamPendiente;            ///< Bytes en pendiente
+    bool descartandoLinea;          ///< La línea actual excedió el búfer y se ignora
+
+    /**
+     * @brief Analiza una línea completa y registra la lectura
+     * @param linea Inicio de la línea
+     * @param longitud Longitud sin el '\n'
+     * @param tiempo Marca de tiempo (ms) de la lectura
+     */
+    void procesarLinea(const char* linea, size_t longitud, long long tiempo);
+
+    /**
+     * @brief Procesa un tramo de texto sin bytes de sincronía
+     * @param datos Inicio del tramo
+     * @param longitud Bytes del tramo
+     * @param tiempo Marca de tiempo (ms) de las lecturas
+     */
+    void alimentarTexto(const char* datos, size_t longitud, long long tiempo);
+
+    /**
+     * @brief Procesa un bloque que puede mezclar texto y tramas
+     * @param datos Inicio del bloque
+     * @param longitud Bytes del bloque
+     * @param tiempo Marca de tiempo (ms) de las lecturas
+     */
+    void alimentarMixto(const char* datos, size_t longitud, long long tiempo);
+
+    /**
+     * @brief Cierra la línea de texto pendiente (el flujo pasó a tramas)
+     * @param tiempo Marca de tiempo (ms) de la lectura
+     */
+    void cerrarLineaPendiente(long long tiempo);
+
+    /**
+     * @brief Decodifica una trama completa y registra la lectura
+     * @param datos TramaBinaria::LONGITUD bytes que empiezan con el byte de sincronía
+     * @param tiempo Marca de tiempo (ms) de la lectura
+     * @return false si el CRC no coincide
+     */
+    bool procesarTrama(const unsigned char* datos, long long tiempo);
+
+    /**
+     * @brief Bytes a saltar tras una trama con CRC inválido
+     * @param trama TramaBinaria::LONGITUD bytes que empiezan con el byte de sincronía
+     * @return Posición de la siguiente sincronía dentro de la trama, o LONGITUD
+     */
+    static size_t saltoTramaInvalida(const unsigned char* trama);
+
+    /**
+     * @brief Suma a Metricas lo contado desde la última publicación (una vez por bloque)
+     */
+    void publicarMetricas();
+
+public:
+    /**
+     * @brief Constructor
+     * @param lista Lista de gestión donde se registran las lecturas
+     */
+    explicit MotorIngesta(ListaGeneral& lista);
+
+    /**
+     * @brief Registra una lectura ya analizada con la hora actual
+     * @param lectura Lectura válida
+     * @return Sensor que recibió la lectura o nullptr si hubo conflicto de tipo
+     */
+    SensorBase* registrar(const LecturaParseada& lectura);
+
+    /**
+     * @brief Registra una lectura ya analizada
+     * @param lectura Lectura válida
+     * @param tiempo Marca de tiempo en ms de relojMs
+     * @return Sensor que recibió la lectura o nullptr si hubo conflicto de tipo
+     */
+    SensorBase* registrar(const LecturaParseada& lectura, long long tiempo);
+
+    /**
+     * @brief Registra una lectura cuyo ID ya está internado
+     * @param id IdNombre del sensor (lectura.id no se consulta)
+     * @param lectura Lectura válida
+     * @param tiempo Marca de tiempo en ms de relojMs
+     * @return Sensor que recibió la lectura o nullptr si hubo conflicto de tipo
+     */
+    SensorBase* registrar(IdNombre id, const LecturaParseada& lectura, long long tiempo);
+
+    /**
+     * @brief Busca un sensor por id y lo crea si no existe
+     * @param tipo 'T' o 'P' (sólo se usa al crear)
+     * @param id IdNombre del sensor
+     * @return Sensor existente (de cualquier tipo) o recién insertado
+     */
+    SensorBase* asegurarSensor(char tipo, IdNombre id);
+
+    /**
+     * @brief Crea un sensor del tipo indicado en una línea
+     * @param tipo 'T' o 'P'
+     * @param id IdNombre del sensor
+     * @param politica Retención del historial del sensor nuevo
+     * @return Sensor nuevo (aún no insertado en ninguna lista)
+     */
+    static SensorBase* crearSensor(char tipo, IdNombre id, const PoliticaRetencion& politica = PoliticaRetencion());
+
+    /**
+     * @brief Define la retención de los sensores que se creen desde el flujo
+     * @param politica Límites del historial
+     */
+    void setRetencion(const PoliticaRetencion& politica);
+
+    /**
+     * @brief Anota cada lectura aceptada en un diario de escritura anticipada
+     * @param diarioLecturas Diario abierto, o nullptr para dejar de anotar
+     */
+    void setDiario(DiarioLecturas* diarioLecturas);
+
+    /**
+     * @brief Define qué formatos se aceptan en el flujo
+     * @param formatoFlujo AUTOMATICO, TEXTO o BINARIO
+     *
+     * Con AUTOMATICO se vuelve a detectar el formato desde cero.
+     */
+    void setFormato(FormatoFlujo formatoFlujo);
+
+    /**
+     * @brief Registra el valor de una lectura en un sensor existente
+     * @param sensor Sensor destino
+     * @param lectura Lectura válida
+     * @param tiempo Marca de tiempo en ms de relojMs
+     * @return false si el tipo de la lectura no coincide con el del sensor
+     */
+    static bool aplicarLectura(SensorBase* sensor, const LecturaParseada& lectura, long long tiempo);
+
+    /**
+     * @brief Procesa un bloque de bytes del flujo
+     * @param datos Bytes recibidos
+     * @param longitud Número de bytes
+     */
+    void alimentar(const char* datos, size_t longitud);
+
+    /**
+     * @brief Procesa la última línea si el flujo terminó sin '\n'
+     */
+    void finalizar();
+
+    /**
+     * @brief Contadores de la sesión
+     * @return Referencia a las estadísticas de ingesta
+     */
+    const EstadisticasIngesta& estadisticas() const;
+
+    /**
+     * @brief Contadores del analizador (líneas y errores por causa)
+     * @return Referencia a las estadísticas de análisis
+     */
+    const EstadisticasParseo& estadisticasParseo() const;
+
+    /**
+     * @brief Acceso al analizador para procesar líneas sueltas
+     * @return Referencia al analizador
+     */
+    ParserLineas& getParser();
+};
+
+#endif // MOTOR_INGESTA_H
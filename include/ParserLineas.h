@@ -0,0 +1,244 @@
+/**
+ * @file ParserLineas.h
+ * @brief Analizador sin copias del protocolo de texto TIPO,ID,VALOR
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef PARSER_LINEAS_H
+#define PARSER_LINEAS_H
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+/**
+ * @brief Resultado del análisis de una línea
+ */
+enum class ResultadoParseo {
+    VALIDA,         ///< Lectura correcta
+    VACIA,          ///< Línea vacía (se ignora)
+    COMENTARIO,     ///< Línea que empieza con '#' (mensajes del Arduino)
+    ERROR_CAMPOS,   ///< No tiene exactamente tres campos
+    ERROR_TIPO,     ///< El tipo no es T ni P
+    ERROR_ID,       ///< Identificador vacío, demasiado largo o con caracteres inválidos
+    ERROR_VALOR     ///< El valor no es un número válido para el tipo
+};
+
+/**
+ * @brief Lectura decodificada de una línea
+ *
+ * id apunta dentro del búfer analizado: sólo es válido mientras ese
+ * búfer no se modifique.
+ */
+struct LecturaParseada {
+    char tipo;              ///< 'T' (temperatura, float) o 'P' (presión, int)
+    std::string_view id;    ///< Identificador del sensor (sin copiar)
+    float valorFloat;       ///< Valor si tipo == 'T'
+    int valorEntero;        ///< Valor si tipo == 'P'
+};
+
+/**
+ * @brief Latencias de las marcas "#LAT,<ns>" del generador de carga
+ *
+ * Cada marca lleva la hora de relojNs() en que se escribió; al analizarla
+ * se resta de la hora actual. Las latencias se acumulan en cubetas de
+ * potencias de 2 µs (la cubeta k cubre [2^(k-1), 2^k) µs), que se pueden
+ * sumar entre hilos sin guardar cada muestra.
+ */
+struct EstadisticasLatencia {
+    /// Número de cubetas del histograma (la última acumula todo lo mayor)
+    static const int CUBETAS = 32;
+
+    long long marcas;               ///< Marcas analizadas
+    long long totalUs;              ///< Suma de las latencias (µs)
+    long long maximaUs;             ///< Latencia máxima (µs)
+    long long cubetas[CUBETAS];     ///< Histograma logarítmico
+
+    /**
+     * @brief Acumula una latencia
+     * @param us Latencia en µs (las negativas cuentan como 0)
+     */
+    void registrar(long long us) {
+        if (us < 0) us = 0;
+        int k = 0;
+        while (k < CUBETAS - 1 && (us >> k) != 0) k++;
+        cubetas[k]++;
+        marcas++;
+        totalUs += us;
+        if (us > maximaUs) maximaUs = us;
+    }
+
+    /**
+     * @brief Suma las latencias de otro analizador
+     * @param otras Latencias a sumar
+     */
+    void sumar(const EstadisticasLatencia& otras) {
+        marcas += otras.marcas;
+        totalUs += otras.totalUs;
+        if (otras.maximaUs > maximaUs) maximaUs = otras.maximaUs;
+        for (int k = 0; k < CUBETAS; k++) {
+            cubetas[k] += otras.cubetas[k];
+        }
+    }
+
+    /**
+     * @brief Cota superior de un percentil
+     * @param fraccion Percentil entre 0 y 1 (p. ej. 0.99)
+     * @return Límite superior (µs) de la cubeta que lo contiene, o 0 sin marcas
+     */
+    long long percentilUs(double fraccion) const {
+        long long objetivo = static_cast<long long>(fraccion * static_cast<double>(marcas));
+        if (objetivo >= marcas) objetivo = marcas - 1;
+        long long acumuladas = 0;
+        for (int k = 0; k < CUBETAS; k++) {
+            acumuladas += cubetas[k];
+            if (acumuladas > objetivo) {
+                long long cota = 1LL << k;
+                return cota < maximaUs ? cota : maximaUs;
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * @brief Contadores acumulados por el analizador
+ */
+struct EstadisticasParseo {
+    long long lineas;           ///< Líneas examinadas
+    long long validas;          ///< Lecturas válidas
+    long long vacias;           ///< Líneas vacías
+    long long comentarios;      ///< Líneas de comentario
+    long long errorCampos;      ///< Rechazadas por número de campos
+    long long errorTipo;        ///< Rechazadas por tipo
+    long long errorId;          ///< Rechazadas por identificador
+    long long errorValor;       ///< Rechazadas por valor
+    EstadisticasLatencia latencia;  ///< Marcas de latencia (comentarios "#LAT,")
+
+    /**
+     * @brief Total de líneas rechazadas
+     * @return Suma de todos los errores
+     */
+    long long errores() const {
+        return errorCampos + errorTipo + errorId + errorValor;
+    }
+
+    /**
+     * @brief Suma los contadores de otro analizador (p. ej. de otro hilo)
+     * @param otras Estadísticas a sumar
+     */
+    void sumar(const EstadisticasParseo& otras) {
+        lineas += otras.lineas;
+        validas += otras.validas;
+        vacias += otras.vacias;
+        comentarios += otras.comentarios;
+        errorCampos += otras.errorCampos;
+        errorTipo += otras.errorTipo;
+        errorId += otras.errorId;
+        errorValor += otras.errorValor;
+        latencia.sumar(otras.latencia);
+    }
+};
+
+/**
+ * @brief Analizador reentrante del protocolo TIPO,ID,VALOR
+ *
+ * Trabaja sobre vistas del búfer de lectura (sin strtok ni copias) y
+ * convierte los valores con std::from_chars, que valida el campo completo.
+ * Las líneas inválidas se cuentan por causa en lugar de convertirse en 0.
+ */
+class ParserLineas {
+private:
+    EstadisticasParseo stats;   ///< Contadores acumulados
+
+    /**
+     * @brief Contabiliza un resultado en las estadísticas
+     * @param r Resultado de una línea
+     */
+    void contabilizar(ResultadoParseo r);
+
+    /**
+     * @brief Si el comentario es una marca de latencia, la contabiliza
+     * @param linea Línea ya clasificada como COMENTARIO
+     */
+    void medirLatencia(std::string_view linea);
+
+public:
+    /// Longitud máxima de un identificador (cabe en SensorBase::nombre)
+    static const int LONGITUD_MAXIMA_ID = 49;
+
+    /// Comentario con la hora de envío (relojNs) que intercala el generador de carga
+    static constexpr const char* PREFIJO_LATENCIA = "#LAT,";
+
+    /**
+     * @brief Constructor: contadores en cero
+     */
+    ParserLineas();
+
+    /**
+     * @brief Analiza una línea sin su salto de línea
+     * @param linea Texto de la línea ('\r' final opcional)
+     * @param salida Lectura decodificada si el resultado es VALIDA
+     * @return Resultado del análisis
+     *
+     * No modifica las estadísticas: es una función pura.
+     */
+    static ResultadoParseo analizar(std::string_view linea, LecturaParseada& salida);
+
+    /**
+     * @brief Analiza una línea y la contabiliza en las estadísticas
+     * @param linea Texto de la línea
+     * @param salida Lectura decodificada si el resultado es VALIDA
+     * @return Resultado del análisis
+     *
+     * Los comentarios "#LAT,<ns>" además se miden como latencia.
+     */
+    ResultadoParseo parsearLinea(std::string_view linea, LecturaParseada& salida);
+
+    /**
+     * @brief Analiza todas las líneas completas de un bloque
+     * @tparam Funcion Invocable con firma void(const LecturaParseada&)
+     * @param datos Inicio del bloque
+     * @param longitud Bytes del bloque
+     * @param alRecibir Se llama con cada lectura válida, en orden
+     * @return Bytes consumidos (hasta el último '\n'); el resto es una línea
+     *         incompleta que debe reenviarse junto con el siguiente bloque
+     */
+    template <typename Funcion>
+    size_t parsearBloque(const char* datos, size_t longitud, Funcion&& alRecibir) {
+        size_t inicio = 0;
+        while (inicio < longitud) {
+            const void* fin = memchr(datos + inicio, '\n', longitud - inicio);
+            if (fin == nullptr) break;
+
+            size_t finLinea = static_cast<size_t>(static_cast<const char*>(fin) - datos);
+            LecturaParseada lectura;
+            if (parsearLinea(std::string_view(datos + inicio, finLinea - inicio), lectura) == ResultadoParseo::VALIDA) {
+                alRecibir(lectura);
+            }
+            inicio = finLinea + 1;
+        }
+        return inicio;
+    }
+
+    /**
+     * @brief Obtiene los contadores acumulados
+     * @return Referencia a las estadísticas
+     */
+    const EstadisticasParseo& estadisticas() const;
+
+    /**
+     * @brief Pone los contadores en cero
+     */
+    void reiniciar();
+
+    /**
+     * @brief Descripción legible de un resultado
+     * @param r Resultado
+     * @return Texto estático
+     */
+    static const char* describir(ResultadoParseo r);
+};
+
+#endif // PARSER_LINEAS_H
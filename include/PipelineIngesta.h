@@ -0,0 +1,158 @@
+/**
+ * @file PipelineIngesta.h
+ * @brief Ingesta en etapas paralelas: lector, analizadores y registradores
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef PIPELINE_INGESTA_H
+#define PIPELINE_INGESTA_H
+
+#include "ListaGeneral.h"
+#include "MotorIngesta.h"
+#include "ParserLineas.h"
+#include "SerialReader.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class DiarioLecturas;
+template <typename T> class ColaSPSC;
+template <typename T> class ColaAcotada;
+
+/**
+ * @brief Parámetros de la tubería de ingesta
+ */
+struct ConfiguracionPipeline {
+    int hilosAnalisis;      ///< Hilos que analizan bloques de texto
+    int hilosRegistro;      ///< Hilos que registran lecturas (uno por fragmento de IDs)
+    int tamBloque;          ///< Bytes por bloque leído del dispositivo
+    int numBloques;         ///< Bloques en circulación (búfer ante ráfagas)
+    PoliticaRetencion retencion;    ///< Retención de los sensores que se crean
+    DiarioLecturas* diario;         ///< Diario de las lecturas aceptadas (opcional, no se posee)
+
+    /**
+     * @brief Constructor con valores por defecto
+     */
+    ConfiguracionPipeline()
+        : hilosAnalisis(2), hilosRegistro(2), tamBloque(64 * 1024), numBloques(64), retencion(), diario(nullptr) {}
+};
+
+/**
+ * @brief Contadores de una ejecución de la tubería
+ */
+struct EstadisticasPipeline {
+    EstadisticasIngesta ingesta;    ///< Bytes, lecturas, sensores creados, conflictos
+    EstadisticasParseo parseo;      ///< Líneas y errores (suma de todos los analizadores)
+    long long bloques;              ///< Bloques enviados a análisis
+    long long esperasLector;        ///< Veces que el lector esperó un bloque libre
+};
+
+/**
+ * @brief Tubería de ingesta multihilo
+ *
+ * - Un hilo lector llena bloques desde SerialReader, cortados en el último
+ *   '\n', y los reparte por turnos a los analizadores.
+ * - Cada analizador convierte sus bloques en lotes de lecturas, interna
+ *   cada ID en TablaNombres y envía la lectura al registrador del
+ *   fragmento que corresponde a su IdNombre.
+ * - Cada registrador es dueño exclusivo de los sensores de su fragmento,
+ *   por lo que registrarLectura no necesita candados; sólo la creación de
+ *   sensores en ListaGeneral toma un mutex.
+ *
+ * Las etapas se comunican con colas ColaSPSC acotadas (una por pareja de
+ * hilos) y los bloques y lotes libres se reciclan con ColaAcotada. Los
+ * registradores consumen los bloques en el orden en que se leyeron, así
+ * que el historial de cada sensor conserva el orden del flujo.
+ *
+ * Mientras la tubería corre la ListaGeneral no debe usarse desde otros hilos.
+ */
+class PipelineIngesta {
+private:
+    struct BloqueDatos;
+    struct LoteLecturas;
+    class CacheSensores;
+
+    ListaGeneral& lista;                ///< Lista destino
+    ConfiguracionPipeline config;       ///< Parámetros
+    std::mutex mutexLista;              ///< Protege buscar/insertar en la lista
+    SerialReader* fuente;               ///< Fuente de datos (no se posee)
+
+    BloqueDatos* bloques;               ///< Todos los bloques de datos
+    char* memoriaBloques;               ///< Memoria contigua de los bloques
+    LoteLecturas* lotes;                ///< Todos los lotes de lecturas
+    int lotesPorAnalizador;             ///< Lotes propios de cada analizador
+
+    ColaAcotada<BloqueDatos*>* bloquesLibres;       ///< Bloques disponibles para el lector
+    ColaSPSC<BloqueDatos*>** colasBloques;          ///< Lector -> analizador p
+    ColaSPSC<LoteLecturas*>** colasLotes;           ///< Analizador p -> registrador u (p*U+u)
+    ColaAcotada<LoteLecturas*>** lotesLibres;       ///< Lotes libres de cada analizador
+
+    std::thread hiloLector;             ///< Hilo lector
+    std::thread* hilosAnalisis;         ///< Hilos analizadores
+    std::thread* hilosRegistro;         ///< Hilos registradores
+    bool enMarcha;                      ///< iniciar() se llamó y falta esperar()
+    std::atomic<bool> detenerSolicitado;    ///< Pide al lector terminar
+    std::atomic<int> etapasActivas;     ///< Hilos que aún no terminan
+
+    EstadisticasPipeline stats;         ///< Contadores (completos tras esperar())
+    EstadisticasParseo* parseoPorHilo;  ///< Contadores de cada analizador
+    EstadisticasIngesta* ingestaPorHilo;    ///< Contadores de cada registrador
+
+    void bucleLector();                     ///< Cuerpo del hilo lector
+    void bucleAnalisis(int indice);         ///< Cuerpo de un analizador
+    void bucleRegistro(int indice);         ///< Cuerpo de un registrador
+
+    /**
+     * @brief Obtiene un lote libre del analizador (espera si no hay)
+     * @param analizador Índice del analizador
+     * @return Lote vacío
+     */
+    LoteLecturas* tomarLote(int analizador);
+
+public:
+    /**
+     * @brief Constructor: reserva bloques, lotes y colas
+     * @param lista Lista de gestión destino
+     * @param config Parámetros de la tubería
+     */
+    PipelineIngesta(ListaGeneral& lista, const ConfiguracionPipeline& config);
+
+    /**
+     * @brief Destructor: detiene la tubería si sigue en marcha y libera todo
+     */
+    ~PipelineIngesta();
+
+    PipelineIngesta(const PipelineIngesta&) = delete;               ///< No copiable
+    PipelineIngesta& operator=(const PipelineIngesta&) = delete;    ///< No asignable
+
+    /**
+     * @brief Arranca los hilos sobre una fuente ya conectada
+     * @param fuente Fuente de datos (debe seguir viva hasta esperar())
+     * @return false si la tubería ya estaba en marcha
+     */
+    bool iniciar(SerialReader& fuente);
+
+    /**
+     * @brief Pide al lector que deje de leer; las etapas vacían lo pendiente
+     */
+    void detener();
+
+    /**
+     * @brief Indica si todos los hilos terminaron
+     */
+    bool terminada() const;
+
+    /**
+     * @brief Espera a que la fuente termine y todas las etapas se vacíen
+     */
+    void esperar();
+
+    /**
+     * @brief Contadores de la ejecución (completos después de esperar())
+     * @return Copia de las estadísticas
+     */
+    EstadisticasPipeline estadisticas() const;
+};
+
+#endif // PIPELINE_INGESTA_H
@@ -0,0 +1,41 @@
+/**
+ * @file PoliticaRetencion.h
+ * @brief Límites de retención del historial de un sensor
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef POLITICA_RETENCION_H
+#define POLITICA_RETENCION_H
+
+/**
+ * @brief Cuántas lecturas y por cuánto tiempo conserva un historial
+ *
+ * Al superar cualquiera de los límites se descartan primero las lecturas
+ * más antiguas. Un límite en 0 significa "sin límite". Si lecturasArchivo
+ * es mayor que 0, las lecturas descartadas no se pierden: pasan a un
+ * ArchivoComprimido que conserva hasta esa cantidad.
+ */
+struct PoliticaRetencion {
+    int maxLecturas;        ///< Lecturas máximas conservadas (0 = sin límite)
+    long long maxEdadMs;    ///< Antigüedad máxima en milisegundos (0 = sin límite)
+    int lecturasArchivo;    ///< Lecturas descartadas conservadas comprimidas (0 = sin archivo)
+
+    /**
+     * @brief Constructor
+     * @param maxLecturas Lecturas máximas (0 = sin límite)
+     * @param maxEdadMs Antigüedad máxima en ms (0 = sin límite)
+     * @param lecturasArchivo Lecturas del archivo comprimido (0 = sin archivo)
+     */
+    explicit PoliticaRetencion(int maxLecturas = 0, long long maxEdadMs = 0, int lecturasArchivo = 0)
+        : maxLecturas(maxLecturas), maxEdadMs(maxEdadMs), lecturasArchivo(lecturasArchivo) {}
+
+    /**
+     * @brief Indica si hay algún límite activo
+     */
+    bool limitada() const {
+        return maxLecturas > 0 || maxEdadMs > 0;
+    }
+};
+
+#endif // POLITICA_RETENCION_H
@@ -0,0 +1,273 @@
+/**
+ * @file PoolNodos.h
+ * @brief Asignador por losas (slab) para los nodos de las listas
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef POOL_NODOS_H
+#define POOL_NODOS_H
+
+#include <new>
+#include <utility>
+
+/**
+ * @brief Estadísticas de uso de un PoolNodos
+ */
+struct EstadisticasPool {
+    long long reservas;         ///< Objetos entregados por crear()
+    long long liberaciones;     ///< Objetos devueltos con destruir()
+    long long vivos;            ///< Objetos actualmente en uso
+    long long pico;             ///< Máximo de objetos vivos simultáneos
+    long long losas;            ///< Losas reservadas actualmente
+    long long bytesReservados;  ///< Bytes reservados actualmente para las losas
+};
+
+/**
+ * @brief Asignador de objetos de tamaño fijo agrupados en losas
+ * @tparam T Tipo de objeto que se reserva
+ *
+ * Los objetos se construyen dentro de losas contiguas que crecen al doble
+ * (hasta MAX_RANURAS_LOSA ranuras) y los liberados se reciclan mediante una
+ * lista libre, de modo que insertar y eliminar nodos no pasa por el
+ * asignador global. liberarTodo() devuelve todas las losas de una vez sin
+ * recorrer los objetos: sus destructores NO se ejecutan, por lo que sólo
+ * debe usarse con tipos triviales o tras destruir los objetos vivos.
+ */
+template <typename T>
+class PoolNodos {
+private:
+    /**
+     * @brief Ranura de una losa: un objeto vivo o un enlace de la lista libre
+     */
+    union Ranura {
+        Ranura* siguienteLibre;                         ///< Enlace cuando está libre
+        alignas(T) unsigned char memoria[sizeof(T)];    ///< Almacenamiento del objeto
+    };
+
+    /**
+     * @brief Bloque contiguo de ranuras pedido al sistema
+     */
+    struct Losa {
+        Ranura* ranuras;        ///< Arreglo de ranuras
+        int capacidad;          ///< Número de ranuras de la losa
+        Losa* siguiente;        ///< Siguiente losa del pool
+    };
+
+    static constexpr int MIN_RANURAS_LOSA = 4;      ///< Ranuras de la primera losa
+    static constexpr int MAX_RANURAS_LOSA = 1024;   ///< Tope de ranuras por losa
+
+    Losa* losas;                ///< Losas reservadas
+    Ranura* libres;             ///< Lista libre de ranuras recicladas
+    int usadasUltimaLosa;       ///< Ranuras nunca entregadas de la losa más reciente
+    int ranurasSiguienteLosa;   ///< Tamaño de la próxima losa
+    EstadisticasPool stats;     ///< Contadores de uso
+
+public:
+    /**
+     * @brief Constructor: el pool no reserva memoria hasta el primer crear()
+     */
+    PoolNodos()
+        : losas(nullptr), libres(nullptr), usadasUltimaLosa(0),
+          ranurasSiguienteLosa(MIN_RANURAS_LOSA), stats() {}
+
+    /**
+     * @brief Destructor: devuelve todas las losas al sistema
+     */
+    ~PoolNodos() {
+        liberarTodo();
+    }
+
+    PoolNodos(const PoolNodos&) = delete;               ///< No copiable
+    PoolNodos& operator=(const PoolNodos&) = delete;    ///< No asignable
+
+    /**
+     * @brief Constructor de movimiento: toma las losas de otro pool
+     * @param otro Pool origen (queda vacío)
+     */
+    PoolNodos(PoolNodos&& otro) noexcept
+        : losas(otro.losas), libres(otro.libres), usadasUltimaLosa(otro.usadasUltimaLosa),
+          ranurasSiguienteLosa(otro.ranurasSiguienteLosa), stats(otro.stats) {
+        otro.soltar();
+    }
+
+    /**
+     * @brief Asignación de movimiento: libera las losas propias y toma las de otro
+     * @param otro Pool origen (queda vacío)
+     * @return Referencia a este pool
+     */
+    PoolNodos& operator=(PoolNodos&& otro) noexcept {
+        if (this != &otro) {
+            liberarTodo();
+            losas = otro.losas;
+            libres = otro.libres;
+            usadasUltimaLosa = otro.usadasUltimaLosa;
+            ranurasSiguienteLosa = otro.ranurasSiguienteLosa;
+            stats = otro.stats;
+            otro.soltar();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Incorpora las losas de otro pool sin copiar ni mover objetos
+     * @param otro Pool origen (queda vacío)
+     *
+     * Los objetos vivos de otro pasan a pertenecer a este pool, así que
+     * pueden destruirse aquí. Las ranuras nunca usadas de la losa más
+     * reciente de otro se agregan a la lista libre. O(losas de otro).
+     */
+    void adoptar(PoolNodos& otro) {
+        if (this == &otro || otro.losas == nullptr) return;
+
+        if (losas == nullptr) {
+            EstadisticasPool acumuladas = stats;
+            *this = std::move(otro);
+            stats.reservas += acumuladas.reservas;
+            stats.liberaciones += acumuladas.liberaciones;
+            return;
+        }
+
+        // Ranuras sin estrenar de la losa más reciente de otro
+        for (int i = otro.usadasUltimaLosa; i < otro.losas->capacidad; i++) {
+            Ranura* r = &otro.losas->ranuras[i];
+            r->siguienteLibre = libres;
+            libres = r;
+        }
+        // La losa propia más reciente sigue al frente (usadasUltimaLosa se refiere a ella)
+        Losa* ultima = otro.losas;
+        while (ultima->siguiente != nullptr) {
+            ultima = ultima->siguiente;
+        }
+        ultima->siguiente = losas->siguiente;
+        losas->siguiente = otro.losas;
+
+        // Lista libre de otro al final de la propia
+        if (otro.libres != nullptr) {
+            Ranura* finLibres = otro.libres;
+            while (finLibres->siguienteLibre != nullptr) {
+                finLibres = finLibres->siguienteLibre;
+            }
+            finLibres->siguienteLibre = libres;
+            libres = otro.libres;
+        }
+
+        stats.reservas += otro.stats.reservas;
+        stats.liberaciones += otro.stats.liberaciones;
+        stats.vivos += otro.stats.vivos;
+        if (stats.vivos > stats.pico) {
+            stats.pico = stats.vivos;
+        }
+        stats.losas += otro.stats.losas;
+        stats.bytesReservados += otro.stats.bytesReservados;
+        otro.soltar();
+    }
+
+    /**
+     * @brief Construye un objeto dentro del pool
+     * @param args Argumentos para el constructor de T
+     * @return Puntero al objeto construido
+     */
+    template <typename... Args>
+    T* crear(Args&&... args) {
+        Ranura* r = tomarRanura();
+        T* obj = new (r->memoria) T(std::forward<Args>(args)...);
+        stats.reservas++;
+        stats.vivos++;
+        if (stats.vivos > stats.pico) {
+            stats.pico = stats.vivos;
+        }
+        return obj;
+    }
+
+    /**
+     * @brief Destruye un objeto y recicla su ranura
+     * @param obj Objeto creado previamente por este pool
+     */
+    void destruir(T* obj) {
+        if (obj == nullptr) return;
+        obj->~T();
+        Ranura* r = reinterpret_cast<Ranura*>(obj);
+        r->siguienteLibre = libres;
+        libres = r;
+        stats.liberaciones++;
+        stats.vivos--;
+    }
+
+    /**
+     * @brief Devuelve todas las losas al sistema en bloque
+     *
+     * No ejecuta destructores. Los contadores de reservas y el pico se conservan.
+     */
+    void liberarTodo() {
+        while (losas != nullptr) {
+            Losa* temp = losas;
+            losas = losas->siguiente;
+            delete[] temp->ranuras;
+            delete temp;
+        }
+        libres = nullptr;
+        usadasUltimaLosa = 0;
+        ranurasSiguienteLosa = MIN_RANURAS_LOSA;
+        stats.liberaciones += stats.vivos;
+        stats.vivos = 0;
+        stats.losas = 0;
+        stats.bytesReservados = 0;
+    }
+
+    /**
+     * @brief Obtiene las estadísticas de asignación
+     * @return Copia de los contadores del pool
+     */
+    EstadisticasPool estadisticas() const {
+        return stats;
+    }
+
+private:
+    /**
+     * @brief Deja el pool vacío sin liberar nada (sus losas ya tienen otro dueño)
+     */
+    void soltar() {
+        losas = nullptr;
+        libres = nullptr;
+        usadasUltimaLosa = 0;
+        ranurasSiguienteLosa = MIN_RANURAS_LOSA;
+        stats = EstadisticasPool();
+    }
+
+    /**
+     * @brief Obtiene una ranura libre, reservando una losa nueva si hace falta
+     * @return Ranura sin inicializar
+     */
+    Ranura* tomarRanura() {
+        if (libres != nullptr) {
+            Ranura* r = libres;
+            libres = r->siguienteLibre;
+            return r;
+        }
+        if (losas == nullptr || usadasUltimaLosa == losas->capacidad) {
+            agregarLosa();
+        }
+        return &losas->ranuras[usadasUltimaLosa++];
+    }
+
+    /**
+     * @brief Reserva una losa nueva con el doble de ranuras que la anterior
+     */
+    void agregarLosa() {
+        Losa* nueva = new Losa;
+        nueva->capacidad = ranurasSiguienteLosa;
+        nueva->ranuras = new Ranura[nueva->capacidad];
+        nueva->siguiente = losas;
+        losas = nueva;
+        usadasUltimaLosa = 0;
+
+        stats.losas++;
+        stats.bytesReservados += static_cast<long long>(nueva->capacidad) * sizeof(Ranura);
+        if (ranurasSiguienteLosa < MAX_RANURAS_LOSA) {
+            ranurasSiguienteLosa *= 2;
+        }
+    }
+};
+
+#endif // POOL_NODOS_H
@@ -0,0 +1,138 @@
+/**
+ * @file PoolTrabajo.h
+ * @brief Grupo de hilos con robo de trabajo para recorrer rangos de índices
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef POOL_TRABAJO_H
+#define POOL_TRABAJO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Grupo fijo de hilos que ejecuta f(i) para i en [0, n)
+ *
+ * El rango se reparte en partes iguales, una por hilo. Cada hilo toma
+ * índices del inicio de su parte; cuando se le acaban, roba la mitad
+ * final de la parte de otro hilo. Así se equilibran tareas de costo muy
+ * desigual sin un reparto central. Cada parte es un par (inicio, fin)
+ * empaquetado en un entero atómico, por lo que tomar y robar son un solo
+ * compare-and-swap.
+ *
+ * El hilo que llama a paraCada() participa como hilo 0; los demás esperan
+ * en una variable de condición entre ejecuciones.
+ */
+class PoolTrabajo {
+private:
+    /**
+     * @brief Parte del rango asignada a un hilo (en su propia línea de caché)
+     */
+    struct alignas(64) Rango {
+        std::atomic<unsigned long long> limites;    ///< inicio (32 bits altos) y fin (32 bits bajos)
+    };
+
+    int numHilos;                       ///< Hilos totales, incluido el que llama
+    std::thread* hilos;                 ///< Hilos auxiliares (numHilos - 1)
+    Rango* rangos;                      ///< Parte de cada hilo
+
+    std::mutex mutexTrabajo;            ///< Protege generacion/terminar
+    std::condition_variable avisoTrabajo;   ///< Despierta a los hilos auxiliares
+    std::condition_variable avisoFin;   ///< Despierta al hilo que llamó
+    unsigned long long generacion;      ///< Número de ejecución actual
+    bool terminar;                      ///< Los hilos auxiliares deben salir
+    int auxiliaresActivos;              ///< Auxiliares que no han terminado la ejecución
+
+    void (*invocar)(void*, int);        ///< Función de la ejecución actual
+    void* contexto;                     ///< Argumento de invocar
+    std::atomic<int> pendientes;        ///< Índices aún no ejecutados
+    std::atomic<long long> robos;       ///< Robos exitosos (acumulado)
+
+    /**
+     * @brief Bucle de un hilo auxiliar
+     * @param indice Número de hilo (1..numHilos-1)
+     */
+    void bucleAuxiliar(int indice);
+
+    /**
+     * @brief Ejecuta índices de la parte propia y roba cuando se acaba
+     * @param indice Número de hilo
+     */
+    void trabajar(int indice);
+
+    /**
+     * @brief Toma el siguiente índice de la parte propia
+     * @param indice Número de hilo
+     * @param tarea Destino del índice
+     * @return false si la parte está vacía
+     */
+    bool tomar(int indice, int& tarea);
+
+    /**
+     * @brief Roba la mitad final de la parte de otro hilo
+     * @param indice Número de hilo ladrón
+     * @return true si obtuvo trabajo
+     */
+    bool robar(int indice);
+
+    /**
+     * @brief Reparte [0, n) y ejecuta hasta terminar todos los índices
+     * @param n Número de índices
+     * @param funcion Función a aplicar a cada índice
+     * @param ctx Argumento de funcion
+     */
+    void ejecutar(int n, void (*funcion)(void*, int), void* ctx);
+
+    /**
+     * @brief Adaptador de un invocable de C++ al puntero a función
+     */
+    template <typename Funcion>
+    static void llamar(void* ctx, int i) {
+        (*static_cast<Funcion*>(ctx))(i);
+    }
+
+public:
+    /**
+     * @brief Constructor: arranca los hilos auxiliares
+     * @param hilos Hilos totales (0 = núcleos disponibles)
+     */
+    explicit PoolTrabajo(int hilos = 0);
+
+    /**
+     * @brief Destructor: detiene y une los hilos auxiliares
+     */
+    ~PoolTrabajo();
+
+    PoolTrabajo(const PoolTrabajo&) = delete;               ///< No copiable
+    PoolTrabajo& operator=(const PoolTrabajo&) = delete;    ///< No asignable
+
+    /**
+     * @brief Ejecuta f(i) para cada i en [0, n) y espera a que terminen todos
+     * @tparam Funcion Invocable con un argumento int, seguro entre hilos
+     * @param n Número de índices
+     * @param f Función a aplicar
+     *
+     * No debe llamarse desde dentro de f ni desde dos hilos a la vez.
+     */
+    template <typename Funcion>
+    void paraCada(int n, Funcion&& f) {
+        typedef typename std::remove_reference<Funcion>::type TipoFuncion;
+        ejecutar(n, &PoolTrabajo::llamar<TipoFuncion>, const_cast<void*>(static_cast<const void*>(&f)));
+    }
+
+    /**
+     * @brief Número de hilos (incluido el que llama)
+     */
+    int getNumHilos() const;
+
+    /**
+     * @brief Robos exitosos desde la creación del grupo
+     */
+    long long getRobos() const;
+};
+
+#endif // POOL_TRABAJO_H
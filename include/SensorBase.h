@@ -10,6 +10,23 @@
 
 #include <cstring>
 #include <iostream>
+#include "AgregadosTiempo.h"
+#include "PoliticaRetencion.h"
+#include "TablaNombres.h"
+#include "VentanaTiempo.h"
+
+/**
+ * @brief Etiqueta del tipo concreto de un sensor
+ *
+ * Permite despachar sin RTTI: los tipos propios del sistema tienen su
+ * etiqueta y cualquier otra clase derivada de SensorBase queda como OTRO
+ * (se procesa con las llamadas virtuales de siempre).
+ */
+enum class TipoSensor : unsigned char {
+    OTRO,           ///< Tipo definido por el usuario
+    TEMPERATURA,    ///< SensorTemperatura
+    PRESION         ///< SensorPresion
+};
 
 /**
  * @brief Clase base abstracta que define la interfaz común para todos los sensores
@@ -18,8 +35,25 @@
  * de procesamiento y visualización en las clases derivadas.
  */
 class SensorBase {
+private:
+    TipoSensor tipo;    ///< Tipo concreto (fijo desde la construcción)
+
 protected:
-    char nombre[50];    ///< Identificador único del sensor
+    const char* nombre;     ///< Identificador único del sensor (texto en TablaNombres)
+    IdNombre idNombre;      ///< Id internado del nombre
+    AgregadosTiempo agregados;  ///< Resúmenes por segundo/minuto/hora de todo lo registrado
+
+    /**
+     * @brief Imprime el resumen de la última hora según los agregados
+     */
+    void imprimirAgregados() const;
+
+    /**
+     * @brief Imprime el tamaño del archivo comprimido del historial (si tiene lecturas)
+     * @param lecturas Lecturas archivadas
+     * @param bytes Memoria ocupada por el archivo
+     */
+    void imprimirArchivo(long long lecturas, long long bytes) const;
 
 public:
     /**
@@ -33,6 +67,13 @@ public:
      */
     SensorBase(const char* nombre);
 
+    /**
+     * @brief Constructor para los tipos con etiqueta propia
+     * @param nombre Identificador del sensor
+     * @param tipo Etiqueta del tipo concreto
+     */
+    SensorBase(const char* nombre, TipoSensor tipo);
+
     /**
      * @brief Destructor virtual para garantizar liberación correcta en polimorfismo
      */
@@ -52,11 +93,74 @@ public:
      */
     virtual void imprimirInfo() const = 0;
 
+    /**
+     * @brief Limita el historial del sensor
+     * @param politica Lecturas máximas y antigüedad máxima a conservar
+     *
+     * Por defecto no hace nada: un tipo de usuario sin historial acotable
+     * no necesita redefinirlo.
+     */
+    virtual void configurarRetencion(const PoliticaRetencion& politica) {
+        (void)politica;
+    }
+
+    /**
+     * @brief Resume las lecturas de un intervalo de tiempo
+     * @param t0 Inicio (ms de relojMs, incluido)
+     * @param t1 Fin (ms de relojMs, excluido)
+     * @return Conteo, suma, mínimo y máximo de las lecturas de [t0, t1)
+     *
+     * Por defecto responde con los agregados (resolución de 1 s), así que
+     * un tipo de usuario sólo necesita volcar sus lecturas en agregados.
+     */
+    virtual ResumenVentana resumirVentana(long long t0, long long t1) const;
+
+    /**
+     * @brief Agregados por segundo, minuto y hora de las lecturas registradas
+     * @return Referencia a los agregados (válidos aunque el historial se haya descartado)
+     */
+    const AgregadosTiempo& getAgregados() const;
+
     /**
      * @brief Obtiene el nombre del sensor
      * @return Puntero al nombre del sensor
      */
     const char* getNombre() const;
+
+    /**
+     * @brief Id internado del nombre (clave del camino de ingesta)
+     * @return Id en TablaNombres::global()
+     */
+    IdNombre getIdNombre() const {
+        return idNombre;
+    }
+
+    /**
+     * @brief Etiqueta del tipo concreto
+     * @return TEMPERATURA, PRESION u OTRO
+     */
+    TipoSensor getTipo() const {
+        return tipo;
+    }
 };
 
+/**
+ * @brief Conversión comprobada por etiqueta, sin dynamic_cast
+ * @tparam T Clase final con una constante TIPO (SensorTemperatura o SensorPresion)
+ * @param sensor Sensor a convertir
+ * @return El sensor como T*, o nullptr si su etiqueta es otra
+ */
+template <typename T>
+T* sensorComo(SensorBase* sensor) {
+    return sensor->getTipo() == T::TIPO ? static_cast<T*>(sensor) : nullptr;
+}
+
+/**
+ * @brief Versión constante de sensorComo
+ */
+template <typename T>
+const T* sensorComo(const SensorBase* sensor) {
+    return sensor->getTipo() == T::TIPO ? static_cast<const T*>(sensor) : nullptr;
+}
+
 #endif // SENSOR_BASE_H
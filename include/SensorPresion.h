@@ -17,11 +17,14 @@
  * Este sensor maneja lecturas de tipo int y almacena el historial
  * de mediciones en una lista enlazada genérica.
  */
-class SensorPresion : public SensorBase {
+class SensorPresion final : public SensorBase {
 private:
     ListaSensor<int> historial;     ///< Lista de lecturas de presión
 
 public:
+    /// Etiqueta del tipo (para sensorComo)
+    static const TipoSensor TIPO = TipoSensor::PRESION;
+
     /**
      * @brief Constructor con nombre del sensor
      * @param nombre Identificador del sensor de presión
@@ -34,11 +37,18 @@ public:
     ~SensorPresion() override;
 
     /**
-     * @brief Registra una nueva lectura de presión
+     * @brief Registra una nueva lectura de presión con la hora actual
      * @param valor Valor de presión
      */
     void registrarLectura(int valor);
 
+    /**
+     * @brief Registra una nueva lectura de presión
+     * @param valor Valor de presión
+     * @param tiempo Marca de tiempo en ms de relojMs (momento de la ingesta)
+     */
+    void registrarLectura(int valor, long long tiempo);
+
     /**
      * @brief Procesa las lecturas calculando el promedio
      * 
@@ -52,6 +62,42 @@ public:
      * Implementación del método virtual puro de SensorBase
      */
     void imprimirInfo() const override;
+
+    /**
+     * @brief Limita el historial de lecturas
+     * @param politica Lecturas máximas y antigüedad máxima a conservar
+     *
+     * Redefine el método de SensorBase (que no hace nada)
+     */
+    void configurarRetencion(const PoliticaRetencion& politica) override;
+
+    /**
+     * @brief Resume las lecturas con marca en [t0, t1)
+     * @param t0 Inicio (ms, incluido)
+     * @param t1 Fin (ms, excluido)
+     * @return Conteo, suma, mínimo y máximo de la ventana
+     *
+     * Las ventanas de segundos completos, y las que empiezan donde la
+     * retención ya descartó lecturas, salen de los agregados; el resto,
+     * del historial crudo con precisión de milisegundo.
+     */
+    ResumenVentana resumirVentana(long long t0, long long t1) const override;
+
+    /**
+     * @brief Agrega al historial lecturas guardadas (p. ej. de una instantánea)
+     * @param valores Lecturas en orden
+     * @param tiempos Marca de cada lectura (ms)
+     * @param n Número de lecturas
+     * @param desplazamiento Se suma a cada marca para llevarla al reloj actual
+     *
+     * Copia en bloque al historial y reconstruye los agregados con las lecturas.
+     */
+    void restaurarLecturas(const int* valores, const long long* tiempos, int n, long long desplazamiento);
+
+    /**
+     * @brief Historial de lecturas (solo lectura)
+     */
+    const ListaSensor<int>& getHistorial() const;
 };
 
 #endif // SENSOR_PRESION_H
@@ -18,16 +18,60 @@
  * @brief Clase para comunicación con dispositivo Arduino mediante puerto serial
  * 
  * Esta clase permite leer datos enviados desde un Arduino conectado
- * al puerto serial de la computadora.
+ * al puerto serial de la computadora. Hay dos implementaciones:
+ * WINDOWS_SERIAL (Win32) y POSIX_SERIAL (termios, Linux/macOS). En ambas
+ * el dispositivo se lee en bloques grandes hacia un búfer circular interno
+ * y las líneas se extraen de ese búfer, evitando una llamada al sistema
+ * por byte.
+ *
+ * En POSIX el puerto puede ser también un pseudo-terminal, un FIFO, un
+ * archivo normal o "-" (entrada estándar); en estos casos no se aplica
+ * termios y el fin de archivo termina la lectura.
  */
 class SerialReader {
 private:
 #ifdef WINDOWS_SERIAL
     HANDLE hSerial;             ///< Handle del puerto serial en Windows
-    bool conectado;             ///< Estado de conexión
+#elif defined(POSIX_SERIAL)
+    int fd;                     ///< Descriptor del dispositivo en POSIX
+    bool esTerminal;            ///< true si el descriptor es un tty (termios aplicado)
 #endif
+    bool conectado;             ///< Estado de conexión
+    bool finDeDatos;            ///< El dispositivo indicó fin de archivo o desconexión
+
+    char* anillo;               ///< Búfer circular de bytes recibidos
+    unsigned int capacidad;     ///< Tamaño del búfer (potencia de 2)
+    unsigned long long posLectura;      ///< Bytes consumidos (posición absoluta)
+    unsigned long long posEscritura;    ///< Bytes recibidos (posición absoluta)
+
+    int vmin;                   ///< VMIN de termios (bytes mínimos por lectura)
+    int vtime;                  ///< VTIME de termios (décimas de segundo)
+    long long bytesLeidos;      ///< Bytes totales recibidos del dispositivo
+    long long llamadasLectura;  ///< Llamadas al sistema de lectura realizadas
+
+    /**
+     * @brief Lee del dispositivo directamente (sin búfer)
+     * @param destino Memoria destino
+     * @param maxBytes Bytes máximos a leer
+     * @return Bytes leídos, 0 si no hubo datos, -1 en error o fin de datos
+     */
+    int leerDispositivo(char* destino, int maxBytes);
+
+    /**
+     * @brief Rellena el búfer circular con una lectura en bloque
+     * @return Bytes agregados, 0 si no hubo datos, -1 en error o fin de datos
+     */
+    int rellenar();
+
+    /**
+     * @brief Número de bytes pendientes en el búfer circular
+     */
+    unsigned int pendientes() const;
 
 public:
+    /// Tamaño por defecto del búfer circular
+    static const unsigned int CAPACIDAD_BUFFER = 64 * 1024;
+
     /**
      * @brief Constructor por defecto
      */
@@ -38,27 +82,98 @@ public:
      */
     ~SerialReader();
 
+    SerialReader(const SerialReader&) = delete;             ///< No copiable (posee el dispositivo)
+    SerialReader& operator=(const SerialReader&) = delete;  ///< No asignable
+
     /**
      * @brief Conecta con el puerto serial especificado
-     * @param puerto Nombre del puerto (ej: "COM3")
+     * @param puerto Nombre del puerto (ej: "COM3" o "/dev/ttyUSB0")
+     * @param baudios Velocidad en baudios (9600 por defecto, como el Arduino)
      * @return true si la conexión fue exitosa
      */
-    bool conectar(const char* puerto);
+    bool conectar(const char* puerto, int baudios = 9600);
+
+    /**
+     * @brief Configura los tiempos de lectura de termios (antes de conectar)
+     * @param bytesMinimos VMIN: bytes mínimos que debe devolver cada lectura
+     * @param decimasEspera VTIME: espera entre bytes en décimas de segundo
+     *
+     * Sólo tiene efecto en POSIX. Por defecto VMIN=1, VTIME=1.
+     */
+    void configurarTiempos(int bytesMinimos, int decimasEspera);
 
     /**
      * @brief Lee una línea de datos desde el puerto serial
      * @param buffer Buffer donde se almacenará la línea leída
      * @param maxSize Tamaño máximo del buffer
-     * @return true si se leyó correctamente
+     * @return true si se leyó una línea; false si venció la espera sin una
+     *         línea completa o terminaron los datos (ver hayMasDatos)
+     *
+     * Quita el '\r' final. Si la línea no cabe se devuelven los primeros
+     * maxSize-1 caracteres y el resto queda para la siguiente llamada. Si
+     * vence la espera (VTIME en un tty), lo recibido de la línea queda en el
+     * búfer y la siguiente llamada la completa.
      */
     bool leerLinea(char* buffer, int maxSize);
 
+    /**
+     * @brief Lee un bloque de bytes sin separar líneas
+     * @param destino Memoria destino
+     * @param maxBytes Bytes máximos a leer
+     * @return Bytes leídos, 0 si venció la espera sin datos, -1 al terminar los datos
+     *
+     * Entrega primero lo que quede en el búfer circular y después lee del
+     * dispositivo directamente hacia destino.
+     */
+    int leerBloque(char* destino, int maxBytes);
+
+    /**
+     * @brief Envía bytes al dispositivo (p. ej. un comando de formato al Arduino)
+     * @param datos Bytes a enviar
+     * @param longitud Número de bytes
+     * @return false si no hay conexión, la fuente no es un puerto o falló la escritura
+     */
+    bool escribir(const char* datos, int longitud);
+
+    /**
+     * @brief Pone el dispositivo ya conectado en modo no bloqueante
+     * @return false si no hay conexión o la plataforma no lo permite
+     *
+     * Sólo en POSIX. Sirve para multiplexar varios puertos con epoll/poll:
+     * leerBloque devuelve 0 en lugar de esperar cuando no hay datos.
+     */
+    bool setNoBloqueante();
+
+    /**
+     * @brief Descriptor del dispositivo (para registrarlo en epoll/poll)
+     * @return Descriptor en POSIX, -1 si no hay conexión o en otras plataformas
+     */
+    int getDescriptor() const;
+
     /**
      * @brief Verifica si hay conexión activa
      * @return true si está conectado
      */
     bool estaConectado() const;
 
+    /**
+     * @brief Indica si todavía pueden llegar datos
+     * @return false cuando el búfer está vacío y el dispositivo terminó o se cerró
+     *
+     * Distingue una espera vencida (reintentar) del fin de los datos.
+     */
+    bool hayMasDatos() const;
+
+    /**
+     * @brief Bytes totales recibidos del dispositivo
+     */
+    long long getBytesLeidos() const;
+
+    /**
+     * @brief Llamadas al sistema de lectura realizadas
+     */
+    long long getLlamadasLectura() const;
+
     /**
      * @brief Cierra la conexión con el puerto serial
      */
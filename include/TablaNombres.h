@@ -0,0 +1,145 @@
+/**
+ * @file TablaNombres.h
+ * @brief Internado de nombres de sensores en identificadores enteros densos
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef TABLA_NOMBRES_H
+#define TABLA_NOMBRES_H
+
+#include <atomic>
+#include <mutex>
+
+/// Identificador denso de un nombre internado (0, 1, 2, ...)
+typedef unsigned int IdNombre;
+
+/**
+ * @brief Tabla de nombres de sensores del proceso
+ *
+ * Cada nombre distinto recibe un IdNombre consecutivo la primera vez que
+ * se interna (al crear el sensor o al verlo por primera vez en el flujo)
+ * y lo conserva hasta el final del proceso. A partir de ahí el camino de
+ * cada lectura trabaja con el entero: índice de ListaGeneral, mensajes de
+ * la tubería y registros del diario. El texto sólo se consulta para
+ * mostrarlo.
+ *
+ * buscar() no toma candados: el índice es de direccionamiento abierto con
+ * casillas atómicas de 64 bits (hash y id) y, al crecer, la tabla nueva se
+ * publica con un puntero atómico; las anteriores se conservan hasta el
+ * final para que un lector atrasado nunca lea memoria liberada (a lo sumo
+ * no ve un nombre recién agregado). internar() vuelve a buscar bajo el
+ * mutex antes de agregar, así que cada nombre recibe un solo id.
+ *
+ * Los textos viven en segmentos de tamaño fijo que nunca se mueven: los
+ * punteros de nombre() son válidos durante todo el proceso.
+ */
+class TablaNombres {
+public:
+    /// Id inválido (nombre no internado)
+    static const IdNombre NINGUNO = 0xFFFFFFFFu;
+    /// Longitud máxima de un nombre (los más largos se truncan, como en SensorBase)
+    static const int LONGITUD_MAXIMA = 49;
+
+    /**
+     * @brief Tabla compartida por todo el proceso
+     */
+    static TablaNombres& global();
+
+    /**
+     * @brief Calcula el hash FNV-1a de un nombre
+     * @param nombre Caracteres del nombre
+     * @param longitud Número de caracteres
+     * @return Hash de 32 bits
+     */
+    static unsigned int hashNombre(const char* nombre, int longitud);
+
+    /**
+     * @brief Constructor: tabla vacía
+     */
+    TablaNombres();
+
+    /**
+     * @brief Destructor: libera índices y segmentos
+     */
+    ~TablaNombres();
+
+    TablaNombres(const TablaNombres&) = delete;             ///< No copiable
+    TablaNombres& operator=(const TablaNombres&) = delete;  ///< No asignable
+
+    /**
+     * @brief Busca un nombre sin internarlo (sin candados)
+     * @param nombre Caracteres del nombre (no necesita terminador)
+     * @param longitud Número de caracteres
+     * @return Id del nombre o NINGUNO
+     */
+    IdNombre buscar(const char* nombre, int longitud) const;
+
+    /**
+     * @brief Devuelve el id de un nombre, asignándole uno nuevo si no existe
+     * @param nombre Caracteres del nombre (no necesita terminador)
+     * @param longitud Número de caracteres (se trunca a LONGITUD_MAXIMA)
+     * @return Id del nombre, o NINGUNO si el nombre es nuevo y la tabla ya
+     *         tiene MAX_SEGMENTOS segmentos llenos (2^26 nombres)
+     */
+    IdNombre internar(const char* nombre, int longitud);
+
+    /**
+     * @brief Texto de un nombre internado
+     * @param id Id válido
+     * @return Nombre terminado en nulo (válido hasta el final del proceso)
+     */
+    const char* nombre(IdNombre id) const;
+
+    /**
+     * @brief Longitud de un nombre internado
+     * @param id Id válido
+     */
+    int longitud(IdNombre id) const;
+
+    /**
+     * @brief Número de nombres internados
+     */
+    unsigned int cantidad() const;
+
+private:
+    /// Nombres por segmento (potencia de 2)
+    static const int BITS_SEGMENTO = 12;
+    /// Segmentos como máximo (2^26 nombres en total)
+    static const int MAX_SEGMENTOS = 1 << 14;
+
+    /**
+     * @brief Texto de un nombre internado
+     */
+    struct Entrada {
+        char texto[LONGITUD_MAXIMA + 1];    ///< Nombre terminado en nulo
+        unsigned char longitud;             ///< Caracteres del nombre
+    };
+
+    /**
+     * @brief Índice hash: cada casilla empaqueta (hash << 32) | (id + 1); 0 = libre
+     */
+    struct Indice {
+        std::atomic<unsigned long long>* casillas;  ///< Casillas
+        unsigned int capacidad;                     ///< Número de casillas (potencia de 2)
+        Indice* anterior;                           ///< Índice reemplazado (se libera al final)
+    };
+
+    std::atomic<Indice*> indice;                ///< Índice vigente
+    std::atomic<Entrada*>* segmentos;           ///< Directorio fijo de segmentos de texto
+    std::atomic<unsigned int> numNombres;       ///< Nombres internados
+    std::mutex mutex;                           ///< Serializa internar()
+    bool llenaAvisada;                          ///< Ya se avisó que no caben más nombres (bajo el mutex)
+
+    /**
+     * @brief Coloca un id en un índice (sólo bajo el mutex)
+     */
+    static void colocar(Indice* destino, unsigned int hash, IdNombre id);
+
+    /**
+     * @brief Entrada de un id válido
+     */
+    const Entrada& entrada(IdNombre id) const;
+};
+
+#endif // TABLA_NOMBRES_H
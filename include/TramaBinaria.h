@@ -0,0 +1,85 @@
+/**
+ * @file TramaBinaria.h
+ * @brief Protocolo binario compacto de tramas fijas (alternativo al texto)
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef TRAMA_BINARIA_H
+#define TRAMA_BINARIA_H
+
+#include "ParserLineas.h"
+
+/**
+ * @brief Resultado de decodificar una trama
+ */
+enum class ResultadoTrama {
+    VALIDA,             ///< Trama correcta
+    ERROR_SINCRONIA,    ///< El primer byte no es SINCRONIA
+    ERROR_CRC           ///< El CRC-16 no coincide (trama dañada o falsa sincronía)
+};
+
+/**
+ * @brief Trama decodificada
+ *
+ * El ID del sensor se reconstruye como "T-NNN" o "P-NNN" con el canal
+ * en tres dígitos, que es como nombra el Arduino a sus sensores.
+ */
+struct TramaDecodificada {
+    LecturaParseada lectura;    ///< Lectura; lectura.id apunta a nombre
+    unsigned char secuencia;    ///< Número de secuencia (módulo 256)
+    char nombre[8];             ///< Almacenamiento del ID reconstruido
+};
+
+/**
+ * @brief Tramas binarias de 7 bytes con CRC-16
+ *
+ * | byte | contenido                                              |
+ * |------|--------------------------------------------------------|
+ * | 0    | SINCRONIA (0xA5, nunca aparece en el protocolo de texto) |
+ * | 1    | bit 7: tipo (0 = T, 1 = P); bits 0-6: canal (0-127)    |
+ * | 2-3  | valor int16 little-endian: décimas de °C o Pa          |
+ * | 4    | número de secuencia (se incrementa en cada trama)      |
+ * | 5-6  | CRC-16/CCITT-FALSE de los bytes 1-4, little-endian     |
+ *
+ * Una lectura que en texto ocupa 12-14 bytes ("T,T-001,25.5\r\n") ocupa
+ * 7, se decodifica sin ramas de análisis numérico y la secuencia permite
+ * contar las tramas perdidas en el enlace.
+ */
+class TramaBinaria {
+public:
+    /// Byte de sincronía al inicio de cada trama
+    static const unsigned char SINCRONIA = 0xA5;
+    /// Bytes de una trama
+    static const int LONGITUD = 7;
+    /// Canal máximo
+    static const int CANAL_MAXIMO = 127;
+
+    /**
+     * @brief CRC-16/CCITT-FALSE (polinomio 0x1021, valor inicial 0xFFFF)
+     * @param datos Bytes
+     * @param longitud Número de bytes
+     * @return CRC de los bytes
+     */
+    static unsigned short crc16(const unsigned char* datos, int longitud);
+
+    /**
+     * @brief Codifica una lectura en una trama
+     * @param tipo 'T' o 'P'
+     * @param canal Número del sensor (0-127)
+     * @param valor Décimas de °C si tipo == 'T', Pa si tipo == 'P' (se satura a int16)
+     * @param secuencia Número de secuencia
+     * @param destino LONGITUD bytes de salida
+     */
+    static void codificar(char tipo, int canal, int valor, unsigned char secuencia, unsigned char* destino);
+
+    /**
+     * @brief Decodifica una trama completa
+     * @param datos LONGITUD bytes
+     * @param salida Trama decodificada si el resultado es VALIDA
+     * @return Resultado de la decodificación
+     */
+    static ResultadoTrama decodificar(const unsigned char* datos, TramaDecodificada& salida);
+};
+
+#endif // TRAMA_BINARIA_H
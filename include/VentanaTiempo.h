@@ -0,0 +1,78 @@
+/**
+ * @file VentanaTiempo.h
+ * @brief Reloj monótono de las lecturas y resumen de una ventana de tiempo
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#ifndef VENTANA_TIEMPO_H
+#define VENTANA_TIEMPO_H
+
+#include <chrono>
+#ifdef __linux__
+#include <time.h>
+#endif
+
+/**
+ * @brief Milisegundos de un reloj monótono
+ *
+ * Es la base de tiempo de todas las marcas de lectura: no retrocede si se
+ * ajusta la hora del sistema, pero sólo tiene sentido dentro del proceso.
+ * En Linux se usa CLOCK_MONOTONIC_COARSE, que se lee en unos pocos ns (la
+ * versión precisa cuesta más que insertar una lectura) a cambio de una
+ * resolución de 1 a 4 ms; en otros sistemas, steady_clock.
+ */
+inline long long relojMs() {
+#ifdef __linux__
+    timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ahora);
+    return static_cast<long long>(ahora.tv_sec) * 1000 + ahora.tv_nsec / 1000000;
+#else
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Nanosegundos del reloj monótono preciso
+ *
+ * Sirve para medir latencias entre procesos: CLOCK_MONOTONIC (y
+ * steady_clock en macOS) es el mismo para todos los procesos de la
+ * máquina, así que una marca tomada por el generador de carga se puede
+ * restar de la hora en que el programa la analiza. Cuesta más que
+ * relojMs(); no se usa para las marcas de las lecturas.
+ */
+inline long long relojNs() {
+#ifdef __linux__
+    timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return static_cast<long long>(ahora.tv_sec) * 1000000000LL + ahora.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Agregados de las lecturas de un intervalo [t0, t1)
+ */
+struct ResumenVentana {
+    long long cantidad;     ///< Lecturas en el intervalo
+    double suma;            ///< Suma de las lecturas
+    double minimo;          ///< Mínimo (0 si cantidad == 0)
+    double maximo;          ///< Máximo (0 si cantidad == 0)
+
+    /**
+     * @brief Constructor (ventana vacía)
+     */
+    ResumenVentana() : cantidad(0), suma(0.0), minimo(0.0), maximo(0.0) {}
+
+    /**
+     * @brief Promedio de las lecturas (0 si la ventana está vacía)
+     */
+    double promedio() const {
+        return cantidad > 0 ? suma / static_cast<double>(cantidad) : 0.0;
+    }
+};
+
+#endif // VENTANA_TIEMPO_H
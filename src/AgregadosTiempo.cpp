@@ -0,0 +1,235 @@
+/**
+ * @file AgregadosTiempo.cpp
+ * @brief Implementación de los agregados por segundo, minuto y hora
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "AgregadosTiempo.h"
+#include <climits>
+
+/// Duración de las cubetas de cada nivel (ms)
+static const long long ANCHOS[] = { AgregadosTiempo::RESOLUCION_MS, 60LL * 1000, 3600LL * 1000 };
+
+/// Cubetas conservadas por nivel: 1 h de segundos, 7 días de minutos, 1 año de horas
+static const int MAX_CUBETAS[] = { 3600, 7 * 24 * 60, 366 * 24 };
+
+/// Cubetas reservadas al abrir un nivel
+static const int CUBETAS_INICIALES = 16;
+
+/**
+ * @brief Mayor múltiplo de ancho que no supera t (también para t negativo)
+ */
+static long long bajarA(long long t, long long ancho) {
+    long long r = t % ancho;
+    return r < 0 ? t - r - ancho : t - r;
+}
+
+/**
+ * @brief Menor múltiplo de ancho que no es menor que t
+ */
+static long long subirA(long long t, long long ancho) {
+    long long b = bajarA(t, ancho);
+    return b == t ? t : b + ancho;
+}
+
+/**
+ * @brief Incorpora los agregados de una cubeta a un resumen
+ */
+static void fusionar(ResumenVentana& resumen, long long cantidad, double suma, double minimo, double maximo) {
+    if (resumen.cantidad == 0) {
+        resumen.minimo = minimo;
+        resumen.maximo = maximo;
+    } else {
+        if (minimo < resumen.minimo) resumen.minimo = minimo;
+        if (resumen.maximo < maximo) resumen.maximo = maximo;
+    }
+    resumen.cantidad += cantidad;
+    resumen.suma += suma;
+}
+
+AgregadosTiempo::AgregadosTiempo() : lecturas(0) {
+    inicializarNiveles();
+}
+
+AgregadosTiempo::~AgregadosTiempo() {
+    liberar();
+}
+
+AgregadosTiempo::AgregadosTiempo(const AgregadosTiempo& otro) : lecturas(0) {
+    inicializarNiveles();
+    copiarDesde(otro);
+}
+
+AgregadosTiempo& AgregadosTiempo::operator=(const AgregadosTiempo& otro) {
+    if (this != &otro) {
+        liberar();
+        inicializarNiveles();
+        copiarDesde(otro);
+    }
+    return *this;
+}
+
+void AgregadosTiempo::inicializarNiveles() {
+    for (int i = 0; i < NUM_NIVELES; i++) {
+        niveles[i].ancho = ANCHOS[i];
+        niveles[i].enCurso.inicio = 0;
+        niveles[i].enCurso.cantidad = 0;
+        niveles[i].enCurso.suma = 0.0;
+        niveles[i].enCurso.minimo = 0.0;
+        niveles[i].enCurso.maximo = 0.0;
+        niveles[i].maxCubetas = MAX_CUBETAS[i];
+        niveles[i].cubetas = nullptr;
+        niveles[i].capacidad = 0;
+        niveles[i].primera = 0;
+        niveles[i].cantidad = 0;
+        niveles[i].horizonte = LLONG_MIN;
+    }
+}
+
+void AgregadosTiempo::copiarDesde(const AgregadosTiempo& otro) {
+    lecturas = otro.lecturas;
+    for (int i = 0; i < NUM_NIVELES; i++) {
+        const Nivel& origen = otro.niveles[i];
+        Nivel& destino = niveles[i];
+        destino.horizonte = origen.horizonte;
+        destino.enCurso = origen.enCurso;
+        if (origen.cantidad == 0) continue;
+        destino.capacidad = origen.cantidad;
+        destino.cubetas = new Cubeta[destino.capacidad];
+        for (int k = 0; k < origen.cantidad; k++) {
+            destino.cubetas[k] = cubeta(origen, k);
+        }
+        destino.cantidad = origen.cantidad;
+    }
+}
+
+void AgregadosTiempo::liberar() {
+    for (int i = 0; i < NUM_NIVELES; i++) {
+        delete[] niveles[i].cubetas;
+        niveles[i].cubetas = nullptr;
+    }
+}
+
+void AgregadosTiempo::cerrarCubeta(Nivel& nivel) {
+    if (nivel.cantidad == nivel.capacidad) {
+        if (nivel.capacidad < nivel.maxCubetas) {
+            int nuevaCap = nivel.capacidad > 0 ? nivel.capacidad * 2 : CUBETAS_INICIALES;
+            if (nuevaCap > nivel.maxCubetas) nuevaCap = nivel.maxCubetas;
+            Cubeta* nuevas = new Cubeta[nuevaCap];
+            for (int k = 0; k < nivel.cantidad; k++) {
+                nuevas[k] = cubeta(nivel, k);
+            }
+            delete[] nivel.cubetas;
+            nivel.cubetas = nuevas;
+            nivel.capacidad = nuevaCap;
+            nivel.primera = 0;
+        } else {
+            // Anillo lleno: se pisa la cubeta más antigua
+            nivel.primera = (nivel.primera + 1) % nivel.capacidad;
+            nivel.cantidad--;
+            nivel.horizonte = cubeta(nivel, 0).inicio;
+        }
+    }
+    nivel.cubetas[(nivel.primera + nivel.cantidad) % nivel.capacidad] = nivel.enCurso;
+    nivel.cantidad++;
+}
+
+void AgregadosTiempo::agregarEnNivel(Nivel& nivel, double valor, long long tiempo) {
+    Cubeta& actual = nivel.enCurso;
+    // Caso común: la lectura cae en la cubeta en curso (una marca anterior también se cuenta en ella)
+    if (actual.cantidad > 0 && tiempo < actual.inicio + nivel.ancho) {
+        sumarEnCubeta(actual, valor);
+        return;
+    }
+
+    if (actual.cantidad > 0) {
+        cerrarCubeta(nivel);
+    }
+    actual.inicio = bajarA(tiempo, nivel.ancho);
+    actual.cantidad = 1;
+    actual.suma = valor;
+    actual.minimo = valor;
+    actual.maximo = valor;
+}
+
+void AgregadosTiempo::agregarCerrando(double valor, long long tiempo) {
+    for (int i = 0; i < NUM_NIVELES; i++) {
+        agregarEnNivel(niveles[i], valor, tiempo);
+    }
+    lecturas++;
+}
+
+void AgregadosTiempo::sumarCubetas(const Nivel& nivel, long long desde, long long hasta, ResumenVentana& resumen) {
+    // Primera cubeta con inicio >= desde
+    const int total = numCubetas(nivel);
+    int bajo = 0;
+    int alto = total;
+    while (bajo < alto) {
+        int medio = bajo + (alto - bajo) / 2;
+        if (cubeta(nivel, medio).inicio < desde) {
+            bajo = medio + 1;
+        } else {
+            alto = medio;
+        }
+    }
+    for (int k = bajo; k < total; k++) {
+        const Cubeta& c = cubeta(nivel, k);
+        if (c.inicio >= hasta) break;
+        fusionar(resumen, c.cantidad, c.suma, c.minimo, c.maximo);
+    }
+}
+
+void AgregadosTiempo::acumular(int indice, long long a, long long b, ResumenVentana& resumen) const {
+    if (a >= b) return;
+    const Nivel& nivel = niveles[indice];
+
+    if (indice == 0) {
+        sumarCubetas(nivel, bajarA(a, nivel.ancho), b, resumen);
+        return;
+    }
+
+    // Cubetas completas de este nivel; los bordes van al nivel más fino,
+    // salvo que éste ya haya pisado esa zona: entonces se toma la cubeta entera
+    const long long horizonteFino = niveles[indice - 1].horizonte;
+    long long desde = subirA(a, nivel.ancho);
+    long long hasta = bajarA(b, nivel.ancho);
+    if (horizonteFino > a) desde = bajarA(a, nivel.ancho);
+    if (horizonteFino > hasta) hasta = subirA(b, nivel.ancho);
+
+    if (desde >= hasta) {
+        acumular(indice - 1, a, b, resumen);
+        return;
+    }
+    sumarCubetas(nivel, desde, hasta, resumen);
+    if (a < desde) acumular(indice - 1, a, desde, resumen);
+    if (hasta < b) acumular(indice - 1, hasta, b, resumen);
+}
+
+ResumenVentana AgregadosTiempo::resumir(long long t0, long long t1) const {
+    ResumenVentana resumen;
+    if (lecturas == 0 || t1 <= t0) return resumen;
+    acumular(NUM_NIVELES - 1, t0, t1, resumen);
+    return resumen;
+}
+
+ResumenVentana AgregadosTiempo::resumirUltimos(long long ventanaMs) const {
+    long long ahora = relojMs();
+    return resumir(ahora - ventanaMs, ahora + 1);
+}
+
+int AgregadosTiempo::getCubetas(NivelAgregado nivel) const {
+    return numCubetas(niveles[static_cast<int>(nivel)]);
+}
+
+long long AgregadosTiempo::getLecturas() const {
+    return lecturas;
+}
+
+long long AgregadosTiempo::memoriaUsada() const {
+    long long bytes = 0;
+    for (int i = 0; i < NUM_NIVELES; i++) {
+        bytes += static_cast<long long>(niveles[i].capacidad) * static_cast<long long>(sizeof(Cubeta));
+    }
+    return bytes;
+}
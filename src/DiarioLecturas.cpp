@@ -0,0 +1,483 @@
+/**
+ * @file DiarioLecturas.cpp
+ * @brief Implementación del diario de escritura anticipada con confirmación en grupo
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "DiarioLecturas.h"
+#include "MotorIngesta.h"
+#include "VentanaTiempo.h"
+#include "Log.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define fsync _commit
+#else
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+/// Bytes de la cabecera de cada grupo: longitud y CRC-32 de los registros
+static const int CABECERA_GRUPO = 8;
+
+/// Tipos de registro que no son lecturas
+static const char REGISTRO_INICIO = 'S';    ///< Reloj monotónico y hora de pared al abrir
+static const char REGISTRO_SENSOR = 'A';    ///< Alta de un sensor sin lecturas
+static const char REGISTRO_NOMBRE = 'N';    ///< Nombre de un IdNombre de la sesión
+
+/// Lecturas por id: tipo, IdNombre, valor y marca
+static const char REGISTRO_TEMPERATURA = 't';   ///< Lectura de temperatura (float)
+static const char REGISTRO_PRESION = 'p';       ///< Lectura de presión (int)
+static const int LONGITUD_LECTURA = 17;         ///< Bytes de un registro 't' o 'p'
+
+/**
+ * @brief CRC-32 (polinomio 0xEDB88320, el de zlib) de un arreglo de bytes
+ */
+static unsigned int crc32(const char* datos, size_t n) {
+    static const struct Tabla {
+        unsigned int v[256];
+        Tabla() {
+            for (unsigned int i = 0; i < 256; i++) {
+                unsigned int c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                v[i] = c;
+            }
+        }
+    } tabla;
+
+    unsigned int crc = 0xFFFFFFFFu;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(datos);
+    for (size_t i = 0; i < n; i++) {
+        crc = tabla.v[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Hora de pared en milisegundos desde 1970
+ */
+static long long paredMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Escribe n bytes completos (reintenta escrituras parciales e interrumpidas)
+ */
+static bool escribirTodo(int fd, const char* datos, size_t n) {
+    while (n > 0) {
+        long escritos = static_cast<long>(::write(fd, datos, static_cast<unsigned int>(n)));
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += escritos;
+        n -= static_cast<size_t>(escritos);
+    }
+    return true;
+}
+
+DiarioLecturas::DiarioLecturas(const ConfiguracionDiario& configuracion)
+    : config(configuracion), fd(-1), activo(nullptr), enEscritura(nullptr), usados(0),
+      gruposCerrados(0), gruposDurables(0), confirmarPedido(false), detener(false), fallo(false),
+      definidos(nullptr), capacidadDefinidos(0), stats() {
+    if (config.intervaloMs < 1) config.intervaloMs = 1;     // Con 0 el escritor no esperaría nunca
+    if (config.tamBuffer < 4096) config.tamBuffer = 4096;
+}
+
+DiarioLecturas::~DiarioLecturas() {
+    cerrar();
+}
+
+bool DiarioLecturas::abrir(const char* ruta) {
+    cerrar();
+    fd = ::open(ruta, O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0644);
+    if (fd < 0) {
+        LOG_ERROR("[Diario] No se pudo abrir " << ruta << ".");
+        return false;
+    }
+    activo = new char[config.tamBuffer];
+    enEscritura = new char[config.tamBuffer];
+    usados = CABECERA_GRUPO;    // Espacio para la cabecera del grupo
+    gruposCerrados = 0;
+    gruposDurables = 0;
+    confirmarPedido = false;
+    detener = false;
+    fallo = false;
+    capacidadDefinidos = 1024;  // Cada sesión del archivo vuelve a definir sus nombres
+    definidos = new unsigned char[capacidadDefinidos]();
+    stats = EstadisticasDiario();
+    hiloEscritor = std::thread(&DiarioLecturas::bucleEscritor, this);
+
+    char inicio[17];
+    long long reloj = relojMs();
+    long long pared = paredMs();
+    inicio[0] = REGISTRO_INICIO;
+    memcpy(inicio + 1, &reloj, 8);
+    memcpy(inicio + 9, &pared, 8);
+    agregar(inicio, sizeof(inicio), 0);
+    LOG_INFO("[Diario] Registrando lecturas en " << ruta << ".");
+    return true;
+}
+
+void DiarioLecturas::agregar(const char* registro, int longitud, int lecturas, IdNombre id) {
+    std::unique_lock<std::mutex> candado(mutex);
+    if (fd < 0) return;
+    int extra;
+    while (true) {
+        // Otro productor pudo definir el nombre mientras se esperaba
+        bool definir = id != TablaNombres::NINGUNO && (id >= capacidadDefinidos || definidos[id] == 0);
+        extra = definir ? 6 + TablaNombres::global().longitud(id) : 0;
+        if (usados + extra + longitud <= config.tamBuffer || fallo) break;
+        stats.esperas++;
+        avisoEscritor.notify_one();
+        avisoLibre.wait(candado);
+    }
+    if (fallo) return;
+    int mitad = config.tamBuffer / 2;
+    bool cruzaMitad = usados < mitad && usados + extra + longitud >= mitad;
+    if (extra > 0) {
+        char* definicion = activo + usados;
+        definicion[0] = REGISTRO_NOMBRE;
+        memcpy(definicion + 1, &id, 4);
+        definicion[5] = static_cast<char>(static_cast<unsigned char>(extra - 6));
+        memcpy(definicion + 6, TablaNombres::global().nombre(id), extra - 6);
+        usados += extra;
+        marcarDefinido(id);
+    }
+    memcpy(activo + usados, registro, longitud);
+    usados += longitud;
+    stats.lecturas += lecturas;
+    if (cruzaMitad) {
+        avisoEscritor.notify_one();
+    }
+}
+
+void DiarioLecturas::marcarDefinido(IdNombre id) {
+    if (id >= capacidadDefinidos) {
+        IdNombre nueva = capacidadDefinidos;
+        while (nueva <= id) {
+            nueva *= 2;
+        }
+        unsigned char* arreglo = new unsigned char[nueva]();
+        memcpy(arreglo, definidos, capacidadDefinidos);
+        delete[] definidos;
+        definidos = arreglo;
+        capacidadDefinidos = nueva;
+    }
+    definidos[id] = 1;
+}
+
+void DiarioLecturas::registrar(char tipo, IdNombre id, float valorFloat, int valorEntero, long long tiempo) {
+    if (id == TablaNombres::NINGUNO) return;    // Sensor sin id: no habría cómo reproducirla
+    char registro[LONGITUD_LECTURA];
+    registro[0] = tipo == 'T' ? REGISTRO_TEMPERATURA : REGISTRO_PRESION;
+    memcpy(registro + 1, &id, 4);
+    if (tipo == 'T') {
+        memcpy(registro + 5, &valorFloat, 4);
+    } else {
+        memcpy(registro + 5, &valorEntero, 4);
+    }
+    memcpy(registro + 9, &tiempo, 8);
+    agregar(registro, LONGITUD_LECTURA, 1, id);
+}
+
+void DiarioLecturas::registrarSensor(char tipo, const char* nombre) {
+    int longitud = static_cast<int>(strlen(nombre));
+    if (longitud > ParserLineas::LONGITUD_MAXIMA_ID) longitud = ParserLineas::LONGITUD_MAXIMA_ID;
+    char registro[3 + ParserLineas::LONGITUD_MAXIMA_ID];
+    registro[0] = REGISTRO_SENSOR;
+    registro[1] = tipo;
+    registro[2] = static_cast<char>(static_cast<unsigned char>(longitud));
+    memcpy(registro + 3, nombre, longitud);
+    agregar(registro, 3 + longitud, 0);
+}
+
+void DiarioLecturas::bucleEscritor() {
+    std::unique_lock<std::mutex> candado(mutex);
+    const int mitad = config.tamBuffer / 2;
+    while (true) {
+        avisoEscritor.wait_for(candado, std::chrono::milliseconds(config.intervaloMs), [this, mitad] {
+            return detener || confirmarPedido || usados >= mitad;
+        });
+        if (usados == CABECERA_GRUPO) {
+            if (confirmarPedido) {
+                confirmarPedido = false;
+                avisoLibre.notify_all();
+            }
+            if (detener) break;
+            continue;
+        }
+
+        // Cerrar el grupo: los productores siguen en el otro búfer mientras éste se escribe
+        char* grupo = activo;
+        activo = enEscritura;
+        enEscritura = grupo;
+        int n = usados;
+        usados = CABECERA_GRUPO;
+        unsigned long long numero = ++gruposCerrados;
+        confirmarPedido = false;
+        avisoLibre.notify_all();
+        candado.unlock();
+
+        unsigned int longitud = static_cast<unsigned int>(n - CABECERA_GRUPO);
+        unsigned int crc = crc32(grupo + CABECERA_GRUPO, longitud);
+        memcpy(grupo, &longitud, 4);
+        memcpy(grupo + 4, &crc, 4);
+        bool ok = escribirTodo(fd, grupo, static_cast<size_t>(n));
+        bool sincronizado = ok && config.sincronizar;
+        if (sincronizado) {
+            ok = fsync(fd) == 0;
+        }
+
+        candado.lock();
+        stats.grupos++;
+        stats.bytes += n;
+        if (sincronizado) stats.sincronizaciones++;
+        if (!ok && !fallo) {
+            fallo = true;
+            LOG_ERROR("[Diario] Falló la escritura; las lecturas siguientes no son durables.");
+        }
+        gruposDurables = numero;
+        avisoLibre.notify_all();
+    }
+}
+
+bool DiarioLecturas::confirmar() {
+    std::unique_lock<std::mutex> candado(mutex);
+    if (fd < 0) return false;
+    unsigned long long objetivo = gruposCerrados + (usados > CABECERA_GRUPO ? 1 : 0);
+    while (gruposDurables < objetivo && !fallo) {
+        confirmarPedido = true;
+        avisoEscritor.notify_one();
+        avisoLibre.wait(candado);
+    }
+    return !fallo;
+}
+
+void DiarioLecturas::cerrar() {
+    {
+        std::lock_guard<std::mutex> candado(mutex);
+        if (fd < 0) return;
+        detener = true;
+    }
+    avisoEscritor.notify_one();
+    hiloEscritor.join();
+
+    std::lock_guard<std::mutex> candado(mutex);
+    ::close(fd);
+    fd = -1;
+    delete[] activo;
+    delete[] enEscritura;
+    delete[] definidos;
+    activo = nullptr;
+    enEscritura = nullptr;
+    definidos = nullptr;
+    capacidadDefinidos = 0;
+    avisoLibre.notify_all();
+    LOG_DEPURACION("[Diario] Cerrado: " << stats.lecturas << " lecturas en " << stats.grupos << " grupos.");
+}
+
+bool DiarioLecturas::estaAbierto() const {
+    std::lock_guard<std::mutex> candado(mutex);
+    return fd >= 0;
+}
+
+EstadisticasDiario DiarioLecturas::estadisticas() const {
+    std::lock_guard<std::mutex> candado(mutex);
+    return stats;
+}
+
+/**
+ * @brief Estado que la reproducción arrastra de un grupo al siguiente
+ */
+struct EstadoReproduccion {
+    long long desplazamiento;   ///< Se suma a las marcas del tramo actual
+    long long lecturas;         ///< Lecturas reproducidas
+    IdNombre* ids;              ///< Id del archivo -> id de la tabla actual (del tramo actual)
+    IdNombre capacidad;         ///< Casillas de ids
+    bool tablaLlena;            ///< Se detuvo porque TablaNombres no admitió un nombre
+
+    EstadoReproduccion() : desplazamiento(0), lecturas(0), ids(nullptr), capacidad(0), tablaLlena(false) {}
+    ~EstadoReproduccion() {
+        delete[] ids;
+    }
+    EstadoReproduccion(const EstadoReproduccion&) = delete;
+    EstadoReproduccion& operator=(const EstadoReproduccion&) = delete;
+
+    /**
+     * @brief Olvida los ids del tramo anterior
+     */
+    void reiniciarIds() {
+        for (IdNombre i = 0; i < capacidad; i++) {
+            ids[i] = TablaNombres::NINGUNO;
+        }
+    }
+
+    /**
+     * @brief Asocia un id del archivo con uno de la tabla actual
+     */
+    void asociar(IdNombre delArchivo, IdNombre local) {
+        if (delArchivo >= capacidad) {
+            IdNombre nueva = capacidad > 0 ? capacidad : 1024;
+            while (nueva <= delArchivo) {
+                nueva *= 2;
+            }
+            IdNombre* arreglo = new IdNombre[nueva];
+            for (IdNombre i = 0; i < nueva; i++) {
+                arreglo[i] = i < capacidad ? ids[i] : TablaNombres::NINGUNO;
+            }
+            delete[] ids;
+            ids = arreglo;
+            capacidad = nueva;
+        }
+        ids[delArchivo] = local;
+    }
+
+    /**
+     * @brief Id actual de un id del archivo (NINGUNO si el tramo no lo definió)
+     */
+    IdNombre traducir(IdNombre delArchivo) const {
+        return delArchivo < capacidad ? ids[delArchivo] : TablaNombres::NINGUNO;
+    }
+};
+
+/// Mayor id de archivo aceptado (evita reservar memoria por un id dañado)
+static const IdNombre MAXIMO_ID_ARCHIVO = 1u << 26;
+
+/**
+ * @brief Reproduce los registros de un grupo válido
+ * @return false si algún registro está mal formado o un nombre no cupo en
+ *         TablaNombres (entonces estado.tablaLlena queda en true)
+ */
+static bool reproducirGrupo(const char* p, const char* fin, MotorIngesta& motor, EstadoReproduccion& estado) {
+    TablaNombres& tabla = TablaNombres::global();
+    while (p < fin) {
+        char tipo = p[0];
+        if (tipo == REGISTRO_TEMPERATURA || tipo == REGISTRO_PRESION) {
+            if (fin - p < LONGITUD_LECTURA) return false;
+            IdNombre delArchivo;
+            memcpy(&delArchivo, p + 1, 4);
+            IdNombre id = estado.traducir(delArchivo);
+            if (id == TablaNombres::NINGUNO) return false;
+            LecturaParseada lectura;
+            lectura.tipo = tipo == REGISTRO_TEMPERATURA ? 'T' : 'P';
+            lectura.valorFloat = 0.0f;
+            lectura.valorEntero = 0;
+            if (lectura.tipo == 'T') {
+                memcpy(&lectura.valorFloat, p + 5, 4);
+            } else {
+                memcpy(&lectura.valorEntero, p + 5, 4);
+            }
+            long long tiempo;
+            memcpy(&tiempo, p + 9, 8);
+            motor.registrar(id, lectura, tiempo + estado.desplazamiento);
+            estado.lecturas++;
+            p += LONGITUD_LECTURA;
+        } else if (tipo == REGISTRO_NOMBRE) {
+            if (fin - p < 6) return false;
+            IdNombre delArchivo;
+            memcpy(&delArchivo, p + 1, 4);
+            int longitud = static_cast<unsigned char>(p[5]);
+            if (fin - p < 6 + longitud || longitud > TablaNombres::LONGITUD_MAXIMA ||
+                delArchivo >= MAXIMO_ID_ARCHIVO) {
+                return false;
+            }
+            IdNombre local = tabla.internar(p + 6, longitud);
+            if (local == TablaNombres::NINGUNO) {
+                estado.tablaLlena = true;
+                return false;
+            }
+            estado.asociar(delArchivo, local);
+            p += 6 + longitud;
+        } else if (tipo == REGISTRO_INICIO) {
+            if (fin - p < 17) return false;
+            long long reloj;
+            long long pared;
+            memcpy(&reloj, p + 1, 8);
+            memcpy(&pared, p + 9, 8);
+            // El tramo siguiente pasa al reloj actual conservando la antigüedad real
+            estado.desplazamiento = (relojMs() - paredMs()) - (reloj - pared);
+            estado.reiniciarIds();
+            p += 17;
+        } else if (tipo == REGISTRO_SENSOR) {
+            if (fin - p < 3) return false;
+            int longitud = static_cast<unsigned char>(p[2]);
+            if (fin - p < 3 + longitud || longitud == 0 || longitud > ParserLineas::LONGITUD_MAXIMA_ID ||
+                (p[1] != 'T' && p[1] != 'P')) {
+                return false;
+            }
+            IdNombre id = tabla.internar(p + 3, longitud);
+            if (id == TablaNombres::NINGUNO) {
+                estado.tablaLlena = true;
+                return false;
+            }
+            motor.asegurarSensor(p[1], id);
+            p += 3 + longitud;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DiarioLecturas::reproducir(const char* ruta, MotorIngesta& motor, long long* lecturas) {
+    FILE* archivo = fopen(ruta, "rb");
+    if (archivo == nullptr) return false;
+    fseek(archivo, 0, SEEK_END);
+    long tamanio = ftell(archivo);
+    fseek(archivo, 0, SEEK_SET);
+    char* datos = new char[tamanio > 0 ? tamanio : 1];
+    bool leido = tamanio >= 0 && fread(datos, 1, static_cast<size_t>(tamanio), archivo) == static_cast<size_t>(tamanio);
+    fclose(archivo);
+    if (!leido) {
+        delete[] datos;
+        LOG_ERROR("[Diario] No se pudo leer " << ruta << ".");
+        return false;
+    }
+
+    EstadoReproduccion estado;
+    long pos = 0;
+    while (tamanio - pos >= CABECERA_GRUPO) {
+        unsigned int longitud;
+        unsigned int crc;
+        memcpy(&longitud, datos + pos, 4);
+        memcpy(&crc, datos + pos + 4, 4);
+        if (longitud > static_cast<unsigned long>(tamanio - pos - CABECERA_GRUPO)) break;
+        const char* registros = datos + pos + CABECERA_GRUPO;
+        if (crc32(registros, longitud) != crc) break;
+        if (!reproducirGrupo(registros, registros + longitud, motor, estado)) break;
+        pos += CABECERA_GRUPO + static_cast<long>(longitud);
+    }
+    delete[] datos;
+
+    if (estado.tablaLlena) {
+        // El resto del archivo está bien: se conserva para otra sesión
+        LOG_ERROR("[Diario] Reproducción de " << ruta << " detenida: la tabla de nombres está llena.");
+    } else if (pos < tamanio) {
+        // Grupo a medio escribir: se recorta para que lo que se agregue después sea legible
+        LOG_AVISO("[Diario] " << (tamanio - pos) << " bytes dañados al final de " << ruta << "; se descartan.");
+#ifndef _WIN32
+        if (truncate(ruta, pos) != 0) {
+            LOG_ERROR("[Diario] No se pudo recortar " << ruta << ".");
+        }
+#endif
+    }
+    if (lecturas != nullptr) {
+        *lecturas = estado.lecturas;
+    }
+    LOG_INFO("[Diario] " << estado.lecturas << " lecturas reproducidas de " << ruta << ".");
+    return true;
+}
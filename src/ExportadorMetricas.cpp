@@ -0,0 +1,416 @@
+/**
+ * @file ExportadorMetricas.cpp
+ * @brief Implementación de la exportación de métricas en texto de Prometheus
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "ExportadorMetricas.h"
+#include "ListaGeneral.h"
+#include "Metricas.h"
+#include "SensorPresion.h"
+#include "SensorTemperatura.h"
+#include "TablaNombres.h"
+#include "VentanaTiempo.h"
+#include "Log.h"
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0      // macOS: se usa SO_NOSIGPIPE en el socket del cliente
+#endif
+#endif
+
+/// Capacidad inicial del texto generado
+static const size_t CAPACIDAD_INICIAL_TEXTO = 16 * 1024;
+
+/// Potencias de 2 (en ns) de las cubetas le= del histograma exportado: de 64 ns a ~69 s
+static const int PRIMER_LIMITE_BITS = 6;
+static const int ULTIMO_LIMITE_BITS = 36;
+
+/// Nombre y ayuda de cada Contador, en el orden del enum
+static const char* const NOMBRES_CONTADORES[NUM_CONTADORES][2] = {
+    {"iot_bytes_leidos_total", "Bytes recibidos de las fuentes"},
+    {"iot_lineas_leidas_total", "Líneas examinadas por el analizador"},
+    {"iot_lineas_validas_total", "Líneas que resultaron lecturas"},
+    {"iot_lineas_rechazadas_total", "Líneas con error de campos, tipo, ID o valor"},
+    {"iot_lecturas_registradas_total", "Lecturas guardadas en algún sensor"},
+    {"iot_sensores_creados_total", "Sensores creados al aparecer en el flujo"},
+    {"iot_conflictos_tipo_total", "Lecturas cuyo tipo no coincide con el del sensor"},
+    {"iot_tramas_total", "Tramas binarias válidas"},
+    {"iot_tramas_invalidas_total", "Tramas con CRC incorrecto o truncadas"},
+    {"iot_tramas_perdidas_total", "Tramas que faltan según su número de secuencia"},
+};
+
+/// Etiqueta operacion de cada Operacion, en el orden del enum
+static const char* const NOMBRES_OPERACIONES[NUM_OPERACIONES] = {"busqueda", "insercion", "proceso"};
+
+/// Cuantiles exportados
+static const double CUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+/**
+ * @brief Datos por sensor que se exportan
+ */
+struct DatosSensor {
+    char tipo;                  ///< 'T', 'P' u 'O' (tipo de usuario)
+    long long lecturas;         ///< Lecturas agregadas desde la creación
+    long long retenidas;        ///< Lecturas en el historial
+    long long nodos;            ///< Bloques del historial
+    long long memoria;          ///< Bytes del historial y de los agregados
+    long long ultimoMs;         ///< relojMs() de la última lectura (0 si no hay)
+};
+
+/**
+ * @brief Reúne los datos exportados de un sensor
+ * @param sensor Sensor
+ */
+static DatosSensor leerSensor(const SensorBase* sensor) {
+    DatosSensor datos = DatosSensor();
+    datos.tipo = 'O';
+    datos.lecturas = sensor->getAgregados().getLecturas();
+    datos.memoria = sensor->getAgregados().memoriaUsada();
+    if (const SensorTemperatura* t = sensorComo<SensorTemperatura>(sensor)) {
+        const ListaSensor<float>& historial = t->getHistorial();
+        datos.tipo = 'T';
+        datos.retenidas = historial.getTamanio();
+        datos.nodos = historial.getNumeroBloques();
+        datos.memoria += historial.memoriaUsada();
+        datos.ultimoMs = historial.getUltimoTiempo();
+    } else if (const SensorPresion* p = sensorComo<SensorPresion>(sensor)) {
+        const ListaSensor<int>& historial = p->getHistorial();
+        datos.tipo = 'P';
+        datos.retenidas = historial.getTamanio();
+        datos.nodos = historial.getNumeroBloques();
+        datos.memoria += historial.memoriaUsada();
+        datos.ultimoMs = historial.getUltimoTiempo();
+    }
+    return datos;
+}
+
+ExportadorMetricas::ExportadorMetricas(const char* destino, int intervaloMs)
+    : destino(destino), esSocket(false), intervaloMs(intervaloMs), proximaMs(0), fdSocket(-1), iniciado(false),
+      texto(nullptr), tamTexto(0), capTexto(0), resumen(nullptr), exportaciones(0) {
+    size_t prefijo = strlen(PREFIJO_SOCKET);
+    if (destino != nullptr && strncmp(destino, PREFIJO_SOCKET, prefijo) == 0) {
+        esSocket = true;
+        this->destino = destino + prefijo;
+    }
+}
+
+ExportadorMetricas::~ExportadorMetricas() {
+#ifndef _WIN32
+    if (fdSocket >= 0) {
+        close(fdSocket);
+        unlink(destino);
+    }
+#endif
+    delete[] texto;
+    delete resumen;
+}
+
+bool ExportadorMetricas::iniciar() {
+    if (destino == nullptr) return false;
+
+    if (esSocket) {
+#ifndef _WIN32
+        struct sockaddr_un direccion;
+        memset(&direccion, 0, sizeof(direccion));
+        direccion.sun_family = AF_UNIX;
+        if (strlen(destino) >= sizeof(direccion.sun_path)) {
+            LOG_ERROR("[Metricas] Ruta de socket demasiado larga: " << destino);
+            return false;
+        }
+        strcpy(direccion.sun_path, destino);
+
+        fdSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fdSocket < 0) {
+            LOG_ERROR("[Metricas] No se pudo crear el socket: " << strerror(errno));
+            return false;
+        }
+        fcntl(fdSocket, F_SETFD, FD_CLOEXEC);
+        unlink(destino);    // Socket de una ejecución anterior
+        if (bind(fdSocket, reinterpret_cast<struct sockaddr*>(&direccion), sizeof(direccion)) != 0 ||
+            listen(fdSocket, 8) != 0 || fcntl(fdSocket, F_SETFL, O_NONBLOCK) != 0) {
+            LOG_ERROR("[Metricas] No se pudo escuchar en " << destino << ": " << strerror(errno));
+            close(fdSocket);
+            fdSocket = -1;
+            return false;
+        }
+#else
+        LOG_ERROR("[Metricas] Los sockets Unix no están disponibles en esta plataforma.");
+        return false;
+#endif
+    }
+
+    texto = new char[CAPACIDAD_INICIAL_TEXTO];
+    capTexto = CAPACIDAD_INICIAL_TEXTO;
+    resumen = new ResumenMetricas();
+    iniciado = true;
+    proximaMs = relojMs() + (esSocket ? SONDEO_SOCKET_MS : intervaloMs);
+    Metricas::activar(true);
+    LOG_INFO("[Metricas] Exportando a " << (esSocket ? "socket " : "archivo ") << destino << ".");
+    return true;
+}
+
+void ExportadorMetricas::revisar(const ListaGeneral* lista) {
+    if (!iniciado) return;
+    long long ahora = relojMs();
+    if (ahora < proximaMs) return;
+
+    if (esSocket) {
+        atenderClientes(lista);
+        proximaMs = ahora + SONDEO_SOCKET_MS;
+    } else {
+        exportar(lista);
+        proximaMs = ahora + intervaloMs;
+    }
+}
+
+bool ExportadorMetricas::exportar(const ListaGeneral* lista) {
+    if (!iniciado) return false;
+    if (esSocket) {
+        atenderClientes(lista);
+        return true;
+    }
+    generar(lista);
+    return escribirArchivo();
+}
+
+long long ExportadorMetricas::getExportaciones() const {
+    return exportaciones;
+}
+
+const char* ExportadorMetricas::getDestino() const {
+    return destino;
+}
+
+void ExportadorMetricas::agregar(const char* formato, ...) {
+    while (true) {
+        va_list argumentos;
+        va_start(argumentos, formato);
+        int n = vsnprintf(texto + tamTexto, capTexto - tamTexto, formato, argumentos);
+        va_end(argumentos);
+        if (n < 0) return;
+        if (tamTexto + static_cast<size_t>(n) < capTexto) {
+            tamTexto += static_cast<size_t>(n);
+            return;
+        }
+        // No cupo: duplicar y volver a formatear
+        size_t nuevaCap = capTexto * 2;
+        while (nuevaCap <= tamTexto + static_cast<size_t>(n)) nuevaCap *= 2;
+        char* nuevo = new char[nuevaCap];
+        memcpy(nuevo, texto, tamTexto);
+        delete[] texto;
+        texto = nuevo;
+        capTexto = nuevaCap;
+    }
+}
+
+void ExportadorMetricas::agregarEtiqueta(const char* nombre) {
+    char escapado[2 * TablaNombres::LONGITUD_MAXIMA + 2];
+    int n = 0;
+    for (const char* c = nombre; *c != '\0' && n < 2 * TablaNombres::LONGITUD_MAXIMA; c++) {
+        if (*c == '\\' || *c == '"') escapado[n++] = '\\';
+        escapado[n++] = *c;
+    }
+    escapado[n] = '\0';
+    agregar("%s", escapado);
+}
+
+void ExportadorMetricas::agregarFamilia(const char* nombre, const char* tipo, const char* ayuda) {
+    agregar("# HELP %s %s\n# TYPE %s %s\n", nombre, ayuda, nombre, tipo);
+}
+
+void ExportadorMetricas::generar(const ListaGeneral* lista) {
+    tamTexto = 0;
+    Metricas::leer(*resumen);
+
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        agregarFamilia(NOMBRES_CONTADORES[c][0], "counter", NOMBRES_CONTADORES[c][1]);
+        agregar("%s %lld\n", NOMBRES_CONTADORES[c][0], resumen->contadores[c]);
+    }
+    generarLatencias();
+
+    agregarFamilia("iot_metricas_hilos", "gauge", "Hilos con ranura propia de métricas");
+    agregar("iot_metricas_hilos %d\n", resumen->hilos);
+    agregarFamilia("iot_nombres_internados", "gauge", "Nombres de sensor en la tabla de nombres");
+    agregar("iot_nombres_internados %d\n", TablaNombres::global().cantidad());
+
+    if (lista != nullptr) {
+        generarSensores(*lista);
+    }
+}
+
+void ExportadorMetricas::generarLatencias() {
+    agregarFamilia("iot_latencia_segundos", "histogram",
+                   "Latencia de búsqueda e inserción (1 de cada 64 lecturas) y de proceso por sensor");
+    for (int op = 0; op < NUM_OPERACIONES; op++) {
+        const long long* cubetas = resumen->cubetas[op];
+        long long acumuladas = 0;
+        int k = 0;
+        for (int bits = PRIMER_LIMITE_BITS; bits <= ULTIMO_LIMITE_BITS; bits++) {
+            // Las cubetas finas terminan justo en cada potencia de 2
+            int hasta = CubetasLatencia::indice(1LL << bits);
+            for (; k < hasta; k++) acumuladas += cubetas[k];
+            agregar("iot_latencia_segundos_bucket{operacion=\"%s\",le=\"%.9g\"} %lld\n", NOMBRES_OPERACIONES[op],
+                    static_cast<double>(1LL << bits) / 1e9, acumuladas);
+        }
+        agregar("iot_latencia_segundos_bucket{operacion=\"%s\",le=\"+Inf\"} %lld\n", NOMBRES_OPERACIONES[op],
+                resumen->muestras[op]);
+        agregar("iot_latencia_segundos_sum{operacion=\"%s\"} %.9g\n", NOMBRES_OPERACIONES[op],
+                static_cast<double>(resumen->sumaNs[op]) / 1e9);
+        agregar("iot_latencia_segundos_count{operacion=\"%s\"} %lld\n", NOMBRES_OPERACIONES[op],
+                resumen->muestras[op]);
+    }
+
+    // Cuantiles con la resolución fina (error < 6.25 %), no con las cubetas le=
+    agregarFamilia("iot_latencia_cuantil_segundos", "gauge", "Cuantiles de la latencia por operación");
+    for (int op = 0; op < NUM_OPERACIONES; op++) {
+        if (resumen->muestras[op] == 0) continue;
+        for (double q : CUANTILES) {
+            agregar("iot_latencia_cuantil_segundos{operacion=\"%s\",cuantil=\"%g\"} %.9g\n", NOMBRES_OPERACIONES[op],
+                    q, static_cast<double>(resumen->cuantilNs(static_cast<Operacion>(op), q)) / 1e9);
+        }
+    }
+}
+
+void ExportadorMetricas::generarSensores(const ListaGeneral& lista) {
+    long long ahora = relojMs();
+
+    // Cada familia debe ir junta, así que la lista se recorre una vez por familia
+    agregarFamilia("iot_sensor_lecturas_total", "counter", "Lecturas recibidas por sensor desde su creación");
+    lista.paraCadaSensor([this](const SensorBase* s) {
+        DatosSensor d = leerSensor(s);
+        agregar("iot_sensor_lecturas_total{sensor=\"");
+        agregarEtiqueta(s->getNombre());
+        agregar("\",tipo=\"%c\"} %lld\n", d.tipo, d.lecturas);
+    });
+    agregarFamilia("iot_sensor_lecturas_retenidas", "gauge", "Lecturas en el historial del sensor");
+    lista.paraCadaSensor([this](const SensorBase* s) {
+        DatosSensor d = leerSensor(s);
+        agregar("iot_sensor_lecturas_retenidas{sensor=\"");
+        agregarEtiqueta(s->getNombre());
+        agregar("\"} %lld\n", d.retenidas);
+    });
+    agregarFamilia("iot_sensor_edad_segundos", "gauge", "Antigüedad de la última lectura del sensor");
+    lista.paraCadaSensor([this, ahora](const SensorBase* s) {
+        DatosSensor d = leerSensor(s);
+        if (d.ultimoMs == 0) return;
+        agregar("iot_sensor_edad_segundos{sensor=\"");
+        agregarEtiqueta(s->getNombre());
+        agregar("\"} %.3f\n", static_cast<double>(ahora - d.ultimoMs) / 1000.0);
+    });
+    agregarFamilia("iot_sensor_nodos", "gauge", "Bloques de la ListaSensor del sensor");
+    lista.paraCadaSensor([this](const SensorBase* s) {
+        DatosSensor d = leerSensor(s);
+        agregar("iot_sensor_nodos{sensor=\"");
+        agregarEtiqueta(s->getNombre());
+        agregar("\"} %lld\n", d.nodos);
+    });
+    agregarFamilia("iot_sensor_memoria_bytes", "gauge", "Bytes del historial, índices, archivo y agregados del sensor");
+    long long nodos = 0;
+    long long memoria = 0;
+    lista.paraCadaSensor([this, &nodos, &memoria](const SensorBase* s) {
+        DatosSensor d = leerSensor(s);
+        nodos += d.nodos;
+        memoria += d.memoria;
+        agregar("iot_sensor_memoria_bytes{sensor=\"");
+        agregarEtiqueta(s->getNombre());
+        agregar("\"} %lld\n", d.memoria);
+    });
+
+    agregarFamilia("iot_sensores", "gauge", "Sensores registrados");
+    agregar("iot_sensores %d\n", lista.getNumSensores());
+    agregarFamilia("iot_nodos", "gauge", "Bloques de todas las ListaSensor");
+    agregar("iot_nodos %lld\n", nodos);
+    agregarFamilia("iot_memoria_bytes", "gauge", "Bytes reservados por componente");
+    agregar("iot_memoria_bytes{componente=\"sensores\"} %lld\n", memoria);
+    agregar("iot_memoria_bytes{componente=\"lista_general\"} %lld\n", lista.getEstadisticasNodos().bytesReservados);
+}
+
+bool ExportadorMetricas::escribirArchivo() {
+    // Se escribe aparte y se renombra: un lector nunca ve el archivo a medias
+    size_t largo = strlen(destino);
+    char* temporal = new char[largo + 5];
+    memcpy(temporal, destino, largo);
+    memcpy(temporal + largo, ".tmp", 5);
+
+    bool ok = false;
+    FILE* archivo = fopen(temporal, "wb");
+    if (archivo != nullptr) {
+        ok = fwrite(texto, 1, tamTexto, archivo) == tamTexto;
+        ok = fclose(archivo) == 0 && ok;
+    }
+#ifdef _WIN32
+    std::remove(destino);   // rename no reemplaza en Windows
+#endif
+    ok = ok && std::rename(temporal, destino) == 0;
+    if (!ok) {
+        LOG_AVISO("[Metricas] No se pudo escribir " << destino << ": " << strerror(errno));
+        std::remove(temporal);
+    } else {
+        exportaciones++;
+    }
+    delete[] temporal;
+    return ok;
+}
+
+void ExportadorMetricas::atenderClientes(const ListaGeneral* lista) {
+#ifndef _WIN32
+    while (true) {
+        int cliente = accept(fdSocket, nullptr, nullptr);
+        if (cliente < 0) return;    // EAGAIN: no hay más conexiones pendientes
+
+        // Un cliente que no lee no debe detener la ingesta más de un segundo
+        struct timeval limite;
+        limite.tv_sec = 1;
+        limite.tv_usec = 0;
+        setsockopt(cliente, SOL_SOCKET, SO_SNDTIMEO, &limite, sizeof(limite));
+#ifdef SO_NOSIGPIPE
+        int uno = 1;
+        setsockopt(cliente, SOL_SOCKET, SO_NOSIGPIPE, &uno, sizeof(uno));
+#endif
+
+        // Consumir la petición (si la hay) sin esperar más de 100 ms
+        struct pollfd vigilado;
+        vigilado.fd = cliente;
+        vigilado.events = POLLIN;
+        vigilado.revents = 0;
+        if (poll(&vigilado, 1, 100) > 0) {
+            char peticion[1024];
+            ssize_t leidos = recv(cliente, peticion, sizeof(peticion), MSG_DONTWAIT);
+            (void)leidos;
+        }
+
+        generar(lista);
+        char cabecera[160];
+        int largoCabecera = snprintf(cabecera, sizeof(cabecera),
+                                     "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: %zu\r\n\r\n", tamTexto);
+        bool ok = send(cliente, cabecera, static_cast<size_t>(largoCabecera), MSG_NOSIGNAL) == largoCabecera;
+        size_t enviados = 0;
+        while (ok && enviados < tamTexto) {
+            ssize_t n = send(cliente, texto + enviados, tamTexto - enviados, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                ok = false;
+                break;
+            }
+            enviados += static_cast<size_t>(n);
+        }
+        if (ok) exportaciones++;
+        close(cliente);
+    }
+#else
+    (void)lista;
+#endif
+}
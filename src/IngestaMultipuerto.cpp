@@ -0,0 +1,237 @@
+/**
+ * @file IngestaMultipuerto.cpp
+ * @brief Implementación de la ingesta multipuerto con epoll/poll
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "IngestaMultipuerto.h"
+#include "Log.h"
+
+#if defined(POSIX_SERIAL) && defined(__linux__)
+#define MULTIPUERTO_EPOLL
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(POSIX_SERIAL)
+#define MULTIPUERTO_POLL
+#include <poll.h>
+#endif
+
+IngestaMultipuerto::IngestaMultipuerto(ListaGeneral& lista)
+    : lista(lista), puertos(), numPuertos(0), abiertos(0), siempreListos(0), fdEventos(-1),
+      bloque(new char[TAM_BLOQUE]), retencion(), formato(FormatoFlujo::AUTOMATICO), diario(nullptr) {
+#ifdef MULTIPUERTO_EPOLL
+    fdEventos = epoll_create1(EPOLL_CLOEXEC);
+    if (fdEventos < 0) {
+        LOG_ERROR("[Multipuerto] No se pudo crear epoll: " << strerror(errno));
+    }
+#endif
+}
+
+IngestaMultipuerto::~IngestaMultipuerto() {
+    for (int i = 0; i < numPuertos; i++) {
+        delete puertos[i];      // El destructor de SerialReader cierra el dispositivo
+    }
+#ifdef MULTIPUERTO_EPOLL
+    if (fdEventos >= 0) {
+        close(fdEventos);
+    }
+#endif
+    delete[] bloque;
+}
+
+bool IngestaMultipuerto::agregarPuerto(const char* ruta, int baudios) {
+#if defined(MULTIPUERTO_EPOLL) || defined(MULTIPUERTO_POLL)
+    if (numPuertos == MAX_PUERTOS) {
+        LOG_ERROR("[Multipuerto] Se admiten a lo sumo " << MAX_PUERTOS << " puertos.");
+        return false;
+    }
+#ifdef MULTIPUERTO_EPOLL
+    if (fdEventos < 0) return false;
+#endif
+
+    Puerto* puerto = new Puerto(ruta, lista);
+    puerto->motor.setRetencion(retencion);
+    puerto->motor.setFormato(formato);
+    puerto->motor.setDiario(diario);
+    if (!puerto->lector.conectar(ruta, baudios) || !puerto->lector.setNoBloqueante()) {
+        delete puerto;
+        return false;
+    }
+
+#ifdef MULTIPUERTO_EPOLL
+    struct epoll_event evento;
+    evento.events = EPOLLIN;    // Por nivel: lo que no se lea en un evento vuelve a avisar
+    evento.data.ptr = puerto;
+    if (epoll_ctl(fdEventos, EPOLL_CTL_ADD, puerto->lector.getDescriptor(), &evento) != 0) {
+        if (errno != EPERM) {
+            LOG_ERROR("[Multipuerto] No se pudo vigilar " << ruta << ": " << strerror(errno));
+            delete puerto;
+            return false;
+        }
+        // Archivo normal: siempre tiene datos hasta su fin
+        puerto->siempreListo = true;
+        siempreListos++;
+    }
+#endif
+
+    puerto->abierto = true;
+    puertos[numPuertos++] = puerto;
+    abiertos++;
+    return true;
+#else
+    (void)ruta;
+    (void)baudios;
+    LOG_ERROR("[Multipuerto] La ingesta multipuerto no está disponible en esta plataforma.");
+    return false;
+#endif
+}
+
+void IngestaMultipuerto::setRetencion(const PoliticaRetencion& politica) {
+    retencion = politica;
+    for (int i = 0; i < numPuertos; i++) {
+        puertos[i]->motor.setRetencion(politica);
+    }
+}
+
+void IngestaMultipuerto::setFormato(FormatoFlujo formatoFlujo) {
+    formato = formatoFlujo;
+    for (int i = 0; i < numPuertos; i++) {
+        puertos[i]->motor.setFormato(formatoFlujo);
+    }
+}
+
+void IngestaMultipuerto::setDiario(DiarioLecturas* diarioLecturas) {
+    diario = diarioLecturas;
+    for (int i = 0; i < numPuertos; i++) {
+        puertos[i]->motor.setDiario(diarioLecturas);
+    }
+}
+
+int IngestaMultipuerto::enviarATodos(const char* datos, int longitud) {
+    int aceptados = 0;
+    for (int i = 0; i < numPuertos; i++) {
+        if (puertos[i]->abierto && puertos[i]->lector.escribir(datos, longitud)) {
+            aceptados++;
+        }
+    }
+    return aceptados;
+}
+
+void IngestaMultipuerto::leerPuerto(Puerto* puerto, bool colgado) {
+    puerto->eventos++;
+    for (int i = 0; i < LECTURAS_POR_EVENTO; i++) {
+        int n = puerto->lector.leerBloque(bloque, TAM_BLOQUE);
+        if (n < 0 || (n == 0 && colgado)) {
+            cerrarPuerto(puerto);
+            return;
+        }
+        if (n == 0) return;     // EAGAIN: el puerto quedó vacío
+        puerto->motor.alimentar(bloque, static_cast<size_t>(n));
+        if (n < TAM_BLOQUE) return;     // Lectura corta: no queda más por ahora
+    }
+}
+
+void IngestaMultipuerto::cerrarPuerto(Puerto* puerto) {
+#ifdef MULTIPUERTO_EPOLL
+    if (!puerto->siempreListo) {
+        epoll_ctl(fdEventos, EPOLL_CTL_DEL, puerto->lector.getDescriptor(), nullptr);
+    }
+#endif
+    if (puerto->siempreListo) {
+        siempreListos--;
+    }
+    puerto->motor.finalizar();
+    puerto->lector.desconectar();
+    puerto->abierto = false;
+    abiertos--;
+    LOG_INFO("[Multipuerto] Fin de datos en " << puerto->ruta << "; quedan " << abiertos << " puertos.");
+}
+
+int IngestaMultipuerto::atender(int esperaMs) {
+    if (abiertos == 0) return 0;
+    // Con un archivo normal pendiente no se espera: siempre hay algo que leer
+    int espera = siempreListos > 0 ? 0 : esperaMs;
+
+#if defined(MULTIPUERTO_EPOLL)
+    struct epoll_event eventos[MAX_PUERTOS];
+    int n = epoll_wait(fdEventos, eventos, MAX_PUERTOS, espera);
+    for (int i = 0; i < n; i++) {
+        leerPuerto(static_cast<Puerto*>(eventos[i].data.ptr), (eventos[i].events & (EPOLLHUP | EPOLLERR)) != 0);
+    }
+#elif defined(MULTIPUERTO_POLL)
+    struct pollfd vigilados[MAX_PUERTOS];
+    Puerto* duenos[MAX_PUERTOS];
+    int k = 0;
+    for (int i = 0; i < numPuertos; i++) {
+        if (puertos[i]->abierto && !puertos[i]->siempreListo) {
+            vigilados[k].fd = puertos[i]->lector.getDescriptor();
+            vigilados[k].events = POLLIN;
+            vigilados[k].revents = 0;
+            duenos[k++] = puertos[i];
+        }
+    }
+    if (poll(vigilados, static_cast<nfds_t>(k), espera) > 0) {
+        for (int i = 0; i < k; i++) {
+            if (vigilados[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                leerPuerto(duenos[i], (vigilados[i].revents & (POLLHUP | POLLERR)) != 0);
+            }
+        }
+    }
+#else
+    (void)espera;
+#endif
+
+    for (int i = 0; i < numPuertos && siempreListos > 0; i++) {
+        if (puertos[i]->abierto && puertos[i]->siempreListo) {
+            leerPuerto(puertos[i], false);
+        }
+    }
+    return abiertos;
+}
+
+void IngestaMultipuerto::finalizar() {
+    for (int i = 0; i < numPuertos; i++) {
+        if (puertos[i]->abierto) {
+            puertos[i]->motor.finalizar();
+        }
+    }
+}
+
+int IngestaMultipuerto::puertosAbiertos() const {
+    return abiertos;
+}
+
+int IngestaMultipuerto::getNumPuertos() const {
+    return numPuertos;
+}
+
+EstadisticasPuerto IngestaMultipuerto::estadisticasPuerto(int indice) const {
+    const Puerto* puerto = puertos[indice];
+    EstadisticasPuerto stats;
+    stats.ruta = puerto->ruta;
+    stats.abierto = puerto->abierto;
+    stats.eventos = puerto->eventos;
+    stats.llamadasLectura = puerto->lector.getLlamadasLectura();
+    stats.ingesta = puerto->motor.estadisticas();
+    stats.parseo = puerto->motor.estadisticasParseo();
+    return stats;
+}
+
+EstadisticasIngesta IngestaMultipuerto::estadisticas() const {
+    EstadisticasIngesta total = EstadisticasIngesta();
+    for (int i = 0; i < numPuertos; i++) {
+        total.sumar(puertos[i]->motor.estadisticas());
+    }
+    return total;
+}
+
+EstadisticasParseo IngestaMultipuerto::estadisticasParseo() const {
+    EstadisticasParseo total = EstadisticasParseo();
+    for (int i = 0; i < numPuertos; i++) {
+        total.sumar(puertos[i]->motor.estadisticasParseo());
+    }
+    return total;
+}
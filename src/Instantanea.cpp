@@ -0,0 +1,405 @@
+/**
+ * @file Instantanea.cpp
+ * @brief Implementación del guardado atómico y la carga por mmap de instantáneas
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "Instantanea.h"
+#include "ListaGeneral.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "VentanaTiempo.h"
+#include "Log.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// Firma de los archivos de instantánea
+static const char FIRMA[8] = { 'I', 'O', 'T', 'S', 'N', 'A', 'P', '\0' };
+
+/// Valor con el que se detecta un archivo escrito con otro orden de bytes
+static const unsigned int MARCA_ORDEN = 0x01020304u;
+
+/// Lecturas que se descomprimen del archivo antes de escribirlas
+static const int TRAMO_ARCHIVO = 4096;
+
+/// Búfer de escritura del archivo
+static const size_t TAM_BUFFER_SALIDA = 1 << 20;
+
+/**
+ * @brief Cabecera del archivo
+ */
+struct CabeceraInstantanea {
+    char firma[8];              ///< FIRMA
+    unsigned int version;       ///< Instantanea::VERSION
+    unsigned int orden;         ///< MARCA_ORDEN
+    long long relojGuardado;    ///< relojMs() al guardar
+    long long paredGuardada;    ///< Hora de pared (ms desde 1970) al guardar
+    long long numSensores;      ///< Secciones de sensor que siguen
+    long long bytesTotales;     ///< Tamaño del archivo (detecta un archivo truncado)
+};
+
+/**
+ * @brief Cabecera de la sección de un sensor
+ *
+ * Le siguen el nombre (relleno hasta múltiplo de 8), numLecturas marcas
+ * y numLecturas valores de 4 bytes (relleno hasta múltiplo de 8).
+ */
+struct CabeceraSensor {
+    char tipo;                  ///< 'T' (float) o 'P' (int)
+    char reservado[3];          ///< Relleno (cero)
+    unsigned int longitudNombre;    ///< Bytes del nombre, sin terminador
+    long long numLecturas;      ///< Lecturas de la sección
+};
+
+/**
+ * @brief Redondea hacia arriba a múltiplo de 8
+ */
+static long long alinear8(long long n) {
+    return (n + 7) & ~7LL;
+}
+
+/**
+ * @brief Hora de pared en milisegundos desde 1970
+ */
+static long long paredMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Archivo de salida con conteo de bytes y error pegajoso
+ */
+struct Salida {
+    FILE* archivo;      ///< Archivo abierto
+    long long bytes;    ///< Bytes escritos
+    bool error;         ///< Falló alguna escritura
+
+    void escribir(const void* datos, size_t n) {
+        if (error || n == 0) return;
+        if (fwrite(datos, 1, n, archivo) != n) {
+            error = true;
+            return;
+        }
+        bytes += static_cast<long long>(n);
+    }
+
+    void rellenarHasta8() {
+        static const char ceros[8] = { 0 };
+        escribir(ceros, static_cast<size_t>(alinear8(bytes) - bytes));
+    }
+};
+
+/**
+ * @brief Escribe la sección de un sensor: cabecera, nombre, marcas y valores
+ * @tparam T float o int
+ */
+template <typename T>
+static long long escribirSensor(Salida& salida, char tipo, const char* nombre, const ListaSensor<T>& historial) {
+    const ArchivoComprimido<T>* archivo = historial.getArchivo();
+    long long archivadas = archivo != nullptr ? archivo->getTamanio() : 0;
+
+    CabeceraSensor cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    cabecera.tipo = tipo;
+    cabecera.longitudNombre = static_cast<unsigned int>(strlen(nombre));
+    cabecera.numLecturas = archivadas + historial.getTamanio();
+    salida.escribir(&cabecera, sizeof(cabecera));
+    salida.escribir(nombre, cabecera.longitudNombre);
+    salida.rellenarHasta8();
+
+    // Las dos columnas se escriben por separado: primero todas las marcas
+    T valores[TRAMO_ARCHIVO];
+    long long tiempos[TRAMO_ARCHIVO];
+    for (int columna = 0; columna < 2; columna++) {
+        if (archivo != nullptr) {
+            typename ArchivoComprimido<T>::Iterador it = archivo->lecturas();
+            int n = 0;
+            while (true) {
+                bool hay = it.siguiente(valores[n], tiempos[n]);
+                if (hay) n++;
+                if (n == TRAMO_ARCHIVO || (!hay && n > 0)) {
+                    if (columna == 0) {
+                        salida.escribir(tiempos, n * sizeof(long long));
+                    } else {
+                        salida.escribir(valores, n * sizeof(T));
+                    }
+                    n = 0;
+                }
+                if (!hay) break;
+            }
+        }
+        for (typename ListaSensor<T>::IteradorBloque it = historial.bloques(); it; ++it) {
+            if (columna == 0) {
+                salida.escribir(it.tiempos(), it.cantidad() * sizeof(long long));
+            } else {
+                salida.escribir(it.datos(), it.cantidad() * sizeof(T));
+            }
+        }
+    }
+    salida.rellenarHasta8();
+    return cabecera.numLecturas;
+}
+
+bool Instantanea::guardar(const ListaGeneral& lista, const char* ruta, EstadisticasInstantanea* stats) {
+    size_t longitudRuta = strlen(ruta);
+    char* temporal = new char[longitudRuta + 5];
+    memcpy(temporal, ruta, longitudRuta);
+    memcpy(temporal + longitudRuta, ".tmp", 5);
+
+    Salida salida;
+    salida.archivo = fopen(temporal, "wb");
+    salida.bytes = 0;
+    salida.error = salida.archivo == nullptr;
+    if (salida.error) {
+        LOG_ERROR("[Instantanea] No se pudo crear " << temporal << ".");
+        delete[] temporal;
+        return false;
+    }
+    char* buffer = new char[TAM_BUFFER_SALIDA];
+    setvbuf(salida.archivo, buffer, _IOFBF, TAM_BUFFER_SALIDA);
+
+    // La cabecera se reescribe al final con los totales
+    CabeceraInstantanea cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.firma, FIRMA, sizeof(FIRMA));
+    cabecera.version = VERSION;
+    cabecera.orden = MARCA_ORDEN;
+    cabecera.relojGuardado = relojMs();
+    cabecera.paredGuardada = paredMs();
+    salida.escribir(&cabecera, sizeof(cabecera));
+
+    long long lecturas = 0;
+    lista.paraCadaSensor([&](const SensorBase* sensor) {
+        if (const SensorTemperatura* temp = sensorComo<SensorTemperatura>(sensor)) {
+            lecturas += escribirSensor(salida, 'T', temp->getNombre(), temp->getHistorial());
+        } else if (const SensorPresion* pres = sensorComo<SensorPresion>(sensor)) {
+            lecturas += escribirSensor(salida, 'P', pres->getNombre(), pres->getHistorial());
+        } else {
+            return;
+        }
+        cabecera.numSensores++;
+    });
+
+    cabecera.bytesTotales = salida.bytes;
+    if (!salida.error && (fseek(salida.archivo, 0, SEEK_SET) != 0
+                          || fwrite(&cabecera, sizeof(cabecera), 1, salida.archivo) != 1
+                          || fflush(salida.archivo) != 0)) {
+        salida.error = true;
+    }
+#ifndef _WIN32
+    if (!salida.error && fsync(fileno(salida.archivo)) != 0) {
+        salida.error = true;
+    }
+#endif
+    if (fclose(salida.archivo) != 0) {
+        salida.error = true;
+    }
+    delete[] buffer;
+
+#ifdef _WIN32
+    if (!salida.error) {
+        std::remove(ruta);  // rename no reemplaza en Windows
+    }
+#endif
+    if (salida.error || std::rename(temporal, ruta) != 0) {
+        LOG_ERROR("[Instantanea] No se pudo escribir " << ruta << ".");
+        std::remove(temporal);
+        delete[] temporal;
+        return false;
+    }
+    delete[] temporal;
+
+    if (stats != nullptr) {
+        stats->sensores = static_cast<int>(cabecera.numSensores);
+        stats->lecturas = lecturas;
+        stats->bytes = cabecera.bytesTotales;
+    }
+    LOG_INFO("[Instantanea] " << cabecera.numSensores << " sensores y " << lecturas
+             << " lecturas guardados en " << ruta << ".");
+    return true;
+}
+
+/**
+ * @brief Contenido de un archivo accesible en memoria
+ */
+struct Mapeo {
+    const unsigned char* datos;     ///< Primer byte (alineado a 8)
+    long long tamanio;              ///< Bytes
+};
+
+/**
+ * @brief Mapea un archivo completo en memoria de solo lectura
+ * @return false si no existe o no se pudo mapear
+ *
+ * Sin mmap (Windows) se lee completo a un arreglo alineado.
+ */
+static bool mapear(const char* ruta, Mapeo& mapeo) {
+#ifndef _WIN32
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // El mapeo sigue vigente
+    if (p == MAP_FAILED) return false;
+    madvise(p, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+    mapeo.datos = static_cast<const unsigned char*>(p);
+    mapeo.tamanio = static_cast<long long>(info.st_size);
+    return true;
+#else
+    FILE* f = fopen(ruta, "rb");
+    if (f == nullptr) return false;
+    fseek(f, 0, SEEK_END);
+    long tamanio = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (tamanio <= 0) {
+        fclose(f);
+        return false;
+    }
+    long long* memoria = new long long[(tamanio + 7) / 8];
+    bool completo = fread(memoria, 1, static_cast<size_t>(tamanio), f) == static_cast<size_t>(tamanio);
+    fclose(f);
+    if (!completo) {
+        delete[] memoria;
+        return false;
+    }
+    mapeo.datos = reinterpret_cast<const unsigned char*>(memoria);
+    mapeo.tamanio = tamanio;
+    return true;
+#endif
+}
+
+/**
+ * @brief Libera lo reservado por mapear()
+ */
+static void desmapear(Mapeo& mapeo) {
+#ifndef _WIN32
+    munmap(const_cast<unsigned char*>(mapeo.datos), static_cast<size_t>(mapeo.tamanio));
+#else
+    delete[] reinterpret_cast<const long long*>(mapeo.datos);
+#endif
+    mapeo.datos = nullptr;
+    mapeo.tamanio = 0;
+}
+
+/**
+ * @brief Busca o crea el sensor de una sección
+ * @return nullptr si existe con otro tipo
+ */
+static SensorBase* sensorDestino(ListaGeneral& lista, char tipo, const char* nombre, int longitud,
+                                 const PoliticaRetencion& politica) {
+    SensorBase* sensor = lista.buscarSensor(nombre, longitud);
+    if (sensor == nullptr) {
+        char copia[64];
+        memcpy(copia, nombre, longitud);
+        copia[longitud] = '\0';
+        if (tipo == 'T') {
+            sensor = new SensorTemperatura(copia);
+        } else {
+            sensor = new SensorPresion(copia);
+        }
+        if (politica.limitada()) {
+            sensor->configurarRetencion(politica);
+        }
+        lista.insertarSensor(sensor);
+    }
+    return sensor;
+}
+
+bool Instantanea::cargar(ListaGeneral& lista, const char* ruta, const PoliticaRetencion& politica,
+                         EstadisticasInstantanea* stats) {
+    Mapeo mapeo;
+    if (!mapear(ruta, mapeo)) {
+        LOG_AVISO("[Instantanea] No se pudo abrir " << ruta << ".");
+        return false;
+    }
+
+    CabeceraInstantanea cabecera;
+    if (mapeo.tamanio < static_cast<long long>(sizeof(cabecera))) {
+        LOG_ERROR("[Instantanea] " << ruta << " no es una instantánea.");
+        desmapear(mapeo);
+        return false;
+    }
+    memcpy(&cabecera, mapeo.datos, sizeof(cabecera));
+    if (memcmp(cabecera.firma, FIRMA, sizeof(FIRMA)) != 0 || cabecera.version != VERSION
+        || cabecera.orden != MARCA_ORDEN || cabecera.bytesTotales != mapeo.tamanio) {
+        LOG_ERROR("[Instantanea] " << ruta << " no es una instantánea válida (firma, versión o tamaño).");
+        desmapear(mapeo);
+        return false;
+    }
+
+    // Las marcas pasan al reloj actual conservando la antigüedad real
+    long long desplazamiento = (relojMs() - paredMs()) - (cabecera.relojGuardado - cabecera.paredGuardada);
+
+    long long pos = sizeof(cabecera);
+    int sensores = 0;
+    long long lecturas = 0;
+    bool valida = true;
+    for (long long s = 0; s < cabecera.numSensores; s++) {
+        CabeceraSensor seccion;
+        if (pos + static_cast<long long>(sizeof(seccion)) > mapeo.tamanio) {
+            valida = false;
+            break;
+        }
+        memcpy(&seccion, mapeo.datos + pos, sizeof(seccion));
+        pos += sizeof(seccion);
+
+        long long n = seccion.numLecturas;
+        long long bytesNombre = alinear8(seccion.longitudNombre);
+        if ((seccion.tipo != 'T' && seccion.tipo != 'P') || seccion.longitudNombre == 0
+            || seccion.longitudNombre > 49 || n < 0 || n > INT_MAX
+            || pos + bytesNombre + n * 8 + alinear8(n * 4) > mapeo.tamanio) {
+            valida = false;
+            break;
+        }
+        const char* nombre = reinterpret_cast<const char*>(mapeo.datos + pos);
+        const long long* tiempos = reinterpret_cast<const long long*>(mapeo.datos + pos + bytesNombre);
+        const void* valores = mapeo.datos + pos + bytesNombre + n * 8;
+        pos += bytesNombre + n * 8 + alinear8(n * 4);
+
+        int longitud = static_cast<int>(seccion.longitudNombre);
+        SensorBase* sensor = sensorDestino(lista, seccion.tipo, nombre, longitud, politica);
+        if (seccion.tipo == 'T') {
+            SensorTemperatura* temp = sensorComo<SensorTemperatura>(sensor);
+            if (temp == nullptr) {
+                LOG_AVISO("[Instantanea] El sensor " << sensor->getNombre() << " no es de tipo T; se omite.");
+                continue;
+            }
+            temp->restaurarLecturas(static_cast<const float*>(valores), tiempos, static_cast<int>(n), desplazamiento);
+        } else {
+            SensorPresion* pres = sensorComo<SensorPresion>(sensor);
+            if (pres == nullptr) {
+                LOG_AVISO("[Instantanea] El sensor " << sensor->getNombre() << " no es de tipo P; se omite.");
+                continue;
+            }
+            pres->restaurarLecturas(static_cast<const int*>(valores), tiempos, static_cast<int>(n), desplazamiento);
+        }
+        sensores++;
+        lecturas += n;
+    }
+    desmapear(mapeo);
+
+    if (!valida) {
+        LOG_ERROR("[Instantanea] " << ruta << " está dañada; se restauraron " << sensores << " sensores.");
+    }
+    if (stats != nullptr) {
+        stats->sensores = sensores;
+        stats->lecturas = lecturas;
+        stats->bytes = cabecera.bytesTotales;
+    }
+    LOG_INFO("[Instantanea] " << sensores << " sensores y " << lecturas << " lecturas restaurados de " << ruta << ".");
+    return valida;
+}
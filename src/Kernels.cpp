@@ -0,0 +1,604 @@
+/**
+ * @file Kernels.cpp
+ * @brief Implementación de los núcleos escalares, SSE4.1 y AVX2 con selección en ejecución
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "Kernels.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#else
+#define KERNELS_X86 0
+#endif
+
+namespace {
+
+/**
+ * @brief Punteros a la implementación de cada operación para un nivel
+ */
+struct TablaKernels {
+    NivelSimd nivel;
+    size_t (*buscarF)(const float*, size_t, float);
+    size_t (*buscarI)(const int*, size_t, int);
+    void (*resumirF)(const float*, size_t, double&, float&, float&);
+    void (*resumirI)(const int*, size_t, long long&, int&, int&);
+    size_t (*minimoF)(const float*, size_t);
+    size_t (*minimoI)(const int*, size_t);
+    size_t (*maximoF)(const float*, size_t);
+    size_t (*maximoI)(const int*, size_t);
+    double (*desviacionF)(const float*, size_t, double);
+    double (*desviacionI)(const int*, size_t, double);
+};
+
+// ---------------------------------------------------------------------------
+// Escalar (referencia y resto de los vectoriales)
+// ---------------------------------------------------------------------------
+
+template <typename T>
+size_t buscarEscalar(const T* d, size_t n, T valor) {
+    for (size_t i = 0; i < n; i++) {
+        if (d[i] == valor) return i;
+    }
+    return n;
+}
+
+template <typename T, typename Acumulador>
+void resumirEscalar(const T* d, size_t n, Acumulador& suma, T& minimo, T& maximo) {
+    Acumulador s = 0;
+    T mn = d[0];
+    T mx = d[0];
+    for (size_t i = 0; i < n; i++) {
+        s += d[i];
+        if (d[i] < mn) mn = d[i];
+        if (mx < d[i]) mx = d[i];
+    }
+    suma = s;
+    minimo = mn;
+    maximo = mx;
+}
+
+template <typename T>
+size_t minimoEscalar(const T* d, size_t n) {
+    size_t pos = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (d[i] < d[pos]) pos = i;
+    }
+    return pos;
+}
+
+template <typename T>
+size_t maximoEscalar(const T* d, size_t n) {
+    size_t pos = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (d[pos] < d[i]) pos = i;
+    }
+    return pos;
+}
+
+template <typename T>
+double desviacionEscalar(const T* d, size_t n, double media) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double x = static_cast<double>(d[i]) - media;
+        s += x * x;
+    }
+    return s;
+}
+
+size_t buscarFEscalar(const float* d, size_t n, float v) { return buscarEscalar(d, n, v); }
+size_t buscarIEscalar(const int* d, size_t n, int v) { return buscarEscalar(d, n, v); }
+void resumirFEscalar(const float* d, size_t n, double& s, float& mn, float& mx) { resumirEscalar(d, n, s, mn, mx); }
+void resumirIEscalar(const int* d, size_t n, long long& s, int& mn, int& mx) { resumirEscalar(d, n, s, mn, mx); }
+size_t minimoFEscalar(const float* d, size_t n) { return minimoEscalar(d, n); }
+size_t minimoIEscalar(const int* d, size_t n) { return minimoEscalar(d, n); }
+size_t maximoFEscalar(const float* d, size_t n) { return maximoEscalar(d, n); }
+size_t maximoIEscalar(const int* d, size_t n) { return maximoEscalar(d, n); }
+double desviacionFEscalar(const float* d, size_t n, double m) { return desviacionEscalar(d, n, m); }
+double desviacionIEscalar(const int* d, size_t n, double m) { return desviacionEscalar(d, n, m); }
+
+const TablaKernels TABLA_ESCALAR = {
+    NivelSimd::ESCALAR,
+    buscarFEscalar, buscarIEscalar, resumirFEscalar, resumirIEscalar,
+    minimoFEscalar, minimoIEscalar, maximoFEscalar, maximoIEscalar,
+    desviacionFEscalar, desviacionIEscalar
+};
+
+#if KERNELS_X86
+
+/**
+ * @brief Posición del primer bit activo de una máscara no nula
+ */
+inline int primerBit(unsigned int mascara) {
+    return __builtin_ctz(mascara);
+}
+
+/**
+ * @brief Agrega el resto escalar (posiciones [i, n)) a un resumen parcial
+ */
+template <typename T, typename Acumulador>
+void resumirResto(const T* d, size_t i, size_t n, Acumulador& suma, T& minimo, T& maximo) {
+    for (; i < n; i++) {
+        suma += d[i];
+        if (d[i] < minimo) minimo = d[i];
+        if (maximo < d[i]) maximo = d[i];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SSE4.1: 4 lecturas por instrucción
+// ---------------------------------------------------------------------------
+
+#define DESTINO_SSE41 __attribute__((target("sse4.1")))
+
+DESTINO_SSE41 double sumarPd128(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+DESTINO_SSE41 size_t buscarFSse41(const float* d, size_t n, float valor) {
+    __m128 objetivo = _mm_set1_ps(valor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int mascara = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(d + i), objetivo));
+        if (mascara != 0) return i + primerBit(mascara);
+    }
+    return i + buscarEscalar(d + i, n - i, valor);
+}
+
+DESTINO_SSE41 size_t buscarISse41(const int* d, size_t n, int valor) {
+    __m128i objetivo = _mm_set1_epi32(valor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i));
+        int mascara = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, objetivo)));
+        if (mascara != 0) return i + primerBit(mascara);
+    }
+    return i + buscarEscalar(d + i, n - i, valor);
+}
+
+DESTINO_SSE41 float reducirMinPs(__m128 v) {
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+DESTINO_SSE41 float reducirMaxPs(__m128 v) {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+DESTINO_SSE41 int reducirMinEpi32(__m128i v) {
+    v = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+DESTINO_SSE41 int reducirMaxEpi32(__m128i v) {
+    v = _mm_max_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+DESTINO_SSE41 long long sumarEpi64(__m128i v) {
+    long long partes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(partes), v);
+    return partes[0] + partes[1];
+}
+
+DESTINO_SSE41 void resumirFSse41(const float* d, size_t n, double& suma, float& minimo, float& maximo) {
+    if (n < 4) {
+        resumirEscalar(d, n, suma, minimo, maximo);
+        return;
+    }
+    __m128 mn = _mm_loadu_ps(d);
+    __m128 mx = mn;
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(d + i);
+        mn = _mm_min_ps(mn, v);
+        mx = _mm_max_ps(mx, v);
+        a0 = _mm_add_pd(a0, _mm_cvtps_pd(v));
+        a1 = _mm_add_pd(a1, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    suma = sumarPd128(_mm_add_pd(a0, a1));
+    minimo = reducirMinPs(mn);
+    maximo = reducirMaxPs(mx);
+    resumirResto(d, i, n, suma, minimo, maximo);
+}
+
+DESTINO_SSE41 void resumirISse41(const int* d, size_t n, long long& suma, int& minimo, int& maximo) {
+    if (n < 4) {
+        resumirEscalar(d, n, suma, minimo, maximo);
+        return;
+    }
+    __m128i mn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d));
+    __m128i mx = mn;
+    __m128i a0 = _mm_setzero_si128(), a1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i));
+        mn = _mm_min_epi32(mn, v);
+        mx = _mm_max_epi32(mx, v);
+        a0 = _mm_add_epi64(a0, _mm_cvtepi32_epi64(v));
+        a1 = _mm_add_epi64(a1, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+    }
+    suma = sumarEpi64(_mm_add_epi64(a0, a1));
+    minimo = reducirMinEpi32(mn);
+    maximo = reducirMaxEpi32(mx);
+    resumirResto(d, i, n, suma, minimo, maximo);
+}
+
+// Posición del mínimo/máximo: una pasada para el valor y otra (que suele
+// terminar antes) para su primera aparición; si hay NaN se recurre al escalar
+DESTINO_SSE41 size_t minimoFSse41(const float* d, size_t n) {
+    if (n < 4) return minimoEscalar(d, n);
+    __m128 m = _mm_loadu_ps(d);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm_min_ps(m, _mm_loadu_ps(d + i));
+    float valor = reducirMinPs(m);
+    for (; i < n; i++) if (d[i] < valor) valor = d[i];
+    size_t pos = buscarFSse41(d, n, valor);
+    return pos < n ? pos : minimoEscalar(d, n);
+}
+
+DESTINO_SSE41 size_t maximoFSse41(const float* d, size_t n) {
+    if (n < 4) return maximoEscalar(d, n);
+    __m128 m = _mm_loadu_ps(d);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm_max_ps(m, _mm_loadu_ps(d + i));
+    float valor = reducirMaxPs(m);
+    for (; i < n; i++) if (valor < d[i]) valor = d[i];
+    size_t pos = buscarFSse41(d, n, valor);
+    return pos < n ? pos : maximoEscalar(d, n);
+}
+
+DESTINO_SSE41 size_t minimoISse41(const int* d, size_t n) {
+    if (n < 4) return minimoEscalar(d, n);
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d));
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm_min_epi32(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i)));
+    int valor = reducirMinEpi32(m);
+    for (; i < n; i++) if (d[i] < valor) valor = d[i];
+    return buscarISse41(d, n, valor);
+}
+
+DESTINO_SSE41 size_t maximoISse41(const int* d, size_t n) {
+    if (n < 4) return maximoEscalar(d, n);
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d));
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm_max_epi32(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i)));
+    int valor = reducirMaxEpi32(m);
+    for (; i < n; i++) if (valor < d[i]) valor = d[i];
+    return buscarISse41(d, n, valor);
+}
+
+DESTINO_SSE41 double desviacionFSse41(const float* d, size_t n, double media) {
+    __m128d m = _mm_set1_pd(media);
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(d + i);
+        __m128d x0 = _mm_sub_pd(_mm_cvtps_pd(v), m);
+        __m128d x1 = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), m);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(x0, x0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(x1, x1));
+    }
+    return sumarPd128(_mm_add_pd(a0, a1)) + desviacionEscalar(d + i, n - i, media);
+}
+
+DESTINO_SSE41 double desviacionISse41(const int* d, size_t n, double media) {
+    __m128d m = _mm_set1_pd(media);
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i));
+        __m128d x0 = _mm_sub_pd(_mm_cvtepi32_pd(v), m);
+        __m128d x1 = _mm_sub_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), m);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(x0, x0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(x1, x1));
+    }
+    return sumarPd128(_mm_add_pd(a0, a1)) + desviacionEscalar(d + i, n - i, media);
+}
+
+const TablaKernels TABLA_SSE41 = {
+    NivelSimd::SSE41,
+    buscarFSse41, buscarISse41, resumirFSse41, resumirISse41,
+    minimoFSse41, minimoISse41, maximoFSse41, maximoISse41,
+    desviacionFSse41, desviacionISse41
+};
+
+// ---------------------------------------------------------------------------
+// AVX2: 8 lecturas por instrucción
+// ---------------------------------------------------------------------------
+
+#define DESTINO_AVX2 __attribute__((target("avx2")))
+
+DESTINO_AVX2 size_t buscarFAvx2(const float* d, size_t n, float valor) {
+    __m256 objetivo = _mm256_set1_ps(valor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int mascara = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(d + i), objetivo, _CMP_EQ_OQ));
+        if (mascara != 0) return i + primerBit(mascara);
+    }
+    return i + buscarEscalar(d + i, n - i, valor);
+}
+
+DESTINO_AVX2 size_t buscarIAvx2(const int* d, size_t n, int valor) {
+    __m256i objetivo = _mm256_set1_epi32(valor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        int mascara = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, objetivo)));
+        if (mascara != 0) return i + primerBit(mascara);
+    }
+    return i + buscarEscalar(d + i, n - i, valor);
+}
+
+// Los tramos de menos de 8 lecturas (bloques recortados) usan la versión SSE4.1
+DESTINO_AVX2 void resumirFAvx2(const float* d, size_t n, double& suma, float& minimo, float& maximo) {
+    if (n < 8) {
+        resumirFSse41(d, n, suma, minimo, maximo);
+        return;
+    }
+    __m256 mn = _mm256_loadu_ps(d);
+    __m256 mx = mn;
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(d + i);
+        mn = _mm256_min_ps(mn, v);
+        mx = _mm256_max_ps(mx, v);
+        a0 = _mm256_add_pd(a0, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        a1 = _mm256_add_pd(a1, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+    __m256d a = _mm256_add_pd(a0, a1);
+    suma = sumarPd128(_mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    minimo = reducirMinPs(_mm_min_ps(_mm256_castps256_ps128(mn), _mm256_extractf128_ps(mn, 1)));
+    maximo = reducirMaxPs(_mm_max_ps(_mm256_castps256_ps128(mx), _mm256_extractf128_ps(mx, 1)));
+    resumirResto(d, i, n, suma, minimo, maximo);
+}
+
+DESTINO_AVX2 void resumirIAvx2(const int* d, size_t n, long long& suma, int& minimo, int& maximo) {
+    if (n < 8) {
+        resumirISse41(d, n, suma, minimo, maximo);
+        return;
+    }
+    __m256i mn = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d));
+    __m256i mx = mn;
+    __m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        mn = _mm256_min_epi32(mn, v);
+        mx = _mm256_max_epi32(mx, v);
+        a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    __m256i a = _mm256_add_epi64(a0, a1);
+    suma = sumarEpi64(_mm_add_epi64(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1)));
+    minimo = reducirMinEpi32(_mm_min_epi32(_mm256_castsi256_si128(mn), _mm256_extracti128_si256(mn, 1)));
+    maximo = reducirMaxEpi32(_mm_max_epi32(_mm256_castsi256_si128(mx), _mm256_extracti128_si256(mx, 1)));
+    resumirResto(d, i, n, suma, minimo, maximo);
+}
+
+DESTINO_AVX2 double sumarPd256(__m256d v) {
+    return sumarPd128(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+}
+
+// Como en resumir, los tramos de menos de 8 lecturas usan la versión SSE4.1
+DESTINO_AVX2 size_t minimoFAvx2(const float* d, size_t n) {
+    if (n < 8) return minimoFSse41(d, n);
+    __m256 m = _mm256_loadu_ps(d);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm256_min_ps(m, _mm256_loadu_ps(d + i));
+    float valor = reducirMinPs(_mm_min_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1)));
+    for (; i < n; i++) if (d[i] < valor) valor = d[i];
+    size_t pos = buscarFAvx2(d, n, valor);
+    return pos < n ? pos : minimoEscalar(d, n);
+}
+
+DESTINO_AVX2 size_t maximoFAvx2(const float* d, size_t n) {
+    if (n < 8) return maximoFSse41(d, n);
+    __m256 m = _mm256_loadu_ps(d);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm256_max_ps(m, _mm256_loadu_ps(d + i));
+    float valor = reducirMaxPs(_mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1)));
+    for (; i < n; i++) if (valor < d[i]) valor = d[i];
+    size_t pos = buscarFAvx2(d, n, valor);
+    return pos < n ? pos : maximoEscalar(d, n);
+}
+
+DESTINO_AVX2 size_t minimoIAvx2(const int* d, size_t n) {
+    if (n < 8) return minimoISse41(d, n);
+    __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d));
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm256_min_epi32(m, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i)));
+    int valor = reducirMinEpi32(_mm_min_epi32(_mm256_castsi256_si128(m), _mm256_extracti128_si256(m, 1)));
+    for (; i < n; i++) if (d[i] < valor) valor = d[i];
+    return buscarIAvx2(d, n, valor);
+}
+
+DESTINO_AVX2 size_t maximoIAvx2(const int* d, size_t n) {
+    if (n < 8) return maximoISse41(d, n);
+    __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d));
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm256_max_epi32(m, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i)));
+    int valor = reducirMaxEpi32(_mm_max_epi32(_mm256_castsi256_si128(m), _mm256_extracti128_si256(m, 1)));
+    for (; i < n; i++) if (valor < d[i]) valor = d[i];
+    return buscarIAvx2(d, n, valor);
+}
+
+DESTINO_AVX2 double desviacionFAvx2(const float* d, size_t n, double media) {
+    __m256d m = _mm256_set1_pd(media);
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(d + i);
+        __m256d x0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), m);
+        __m256d x1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), m);
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(x0, x0));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(x1, x1));
+    }
+    return sumarPd256(_mm256_add_pd(a0, a1)) + desviacionEscalar(d + i, n - i, media);
+}
+
+DESTINO_AVX2 double desviacionIAvx2(const int* d, size_t n, double media) {
+    __m256d m = _mm256_set1_pd(media);
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d x0 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i))), m);
+        __m256d x1 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(d + i + 4))), m);
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(x0, x0));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(x1, x1));
+    }
+    return sumarPd256(_mm256_add_pd(a0, a1)) + desviacionEscalar(d + i, n - i, media);
+}
+
+const TablaKernels TABLA_AVX2 = {
+    NivelSimd::AVX2,
+    buscarFAvx2, buscarIAvx2, resumirFAvx2, resumirIAvx2,
+    minimoFAvx2, minimoIAvx2, maximoFAvx2, maximoIAvx2,
+    desviacionFAvx2, desviacionIAvx2
+};
+
+#endif // KERNELS_X86
+
+/**
+ * @brief Indica si el procesador soporta un nivel
+ */
+bool soportado(NivelSimd nivel) {
+#if KERNELS_X86
+    __builtin_cpu_init();
+    switch (nivel) {
+        case NivelSimd::AVX2: return __builtin_cpu_supports("avx2");
+        case NivelSimd::SSE41: return __builtin_cpu_supports("sse4.1");
+        default: return true;
+    }
+#else
+    return nivel == NivelSimd::ESCALAR;
+#endif
+}
+
+const TablaKernels* tablaDe(NivelSimd nivel) {
+#if KERNELS_X86
+    if (nivel == NivelSimd::AVX2) return &TABLA_AVX2;
+    if (nivel == NivelSimd::SSE41) return &TABLA_SSE41;
+#endif
+    (void)nivel;
+    return &TABLA_ESCALAR;
+}
+
+/**
+ * @brief Elige el nivel más alto soportado, acotado por IOT_SIMD si existe
+ */
+const TablaKernels* detectar() {
+    NivelSimd tope = NivelSimd::AVX2;
+    const char* entorno = std::getenv("IOT_SIMD");
+    if (entorno != nullptr) {
+        if (strcmp(entorno, "escalar") == 0) tope = NivelSimd::ESCALAR;
+        else if (strcmp(entorno, "sse41") == 0) tope = NivelSimd::SSE41;
+    }
+    if (tope == NivelSimd::AVX2 && soportado(NivelSimd::AVX2)) return tablaDe(NivelSimd::AVX2);
+    if (tope != NivelSimd::ESCALAR && soportado(NivelSimd::SSE41)) return tablaDe(NivelSimd::SSE41);
+    return tablaDe(NivelSimd::ESCALAR);
+}
+
+std::atomic<const TablaKernels*> tablaActiva(nullptr);
+
+/**
+ * @brief Tabla del nivel activo (la detecta en la primera llamada)
+ */
+inline const TablaKernels& tabla() {
+    const TablaKernels* t = tablaActiva.load(std::memory_order_acquire);
+    if (t == nullptr) {
+        t = detectar();
+        tablaActiva.store(t, std::memory_order_release);
+    }
+    return *t;
+}
+
+} // namespace
+
+NivelSimd Kernels::nivel() {
+    return tabla().nivel;
+}
+
+const char* Kernels::nombreNivel() {
+    switch (nivel()) {
+        case NivelSimd::AVX2: return "avx2";
+        case NivelSimd::SSE41: return "sse41";
+        default: return "escalar";
+    }
+}
+
+bool Kernels::forzarNivel(NivelSimd nivel) {
+    if (!soportado(nivel)) return false;
+    tablaActiva.store(tablaDe(nivel), std::memory_order_release);
+    return true;
+}
+
+size_t Kernels::buscar(const float* datos, size_t n, float valor) {
+    return tabla().buscarF(datos, n, valor);
+}
+
+size_t Kernels::buscar(const int* datos, size_t n, int valor) {
+    return tabla().buscarI(datos, n, valor);
+}
+
+void Kernels::resumir(const float* datos, size_t n, double& suma, float& minimo, float& maximo) {
+    tabla().resumirF(datos, n, suma, minimo, maximo);
+}
+
+void Kernels::resumir(const int* datos, size_t n, long long& suma, int& minimo, int& maximo) {
+    tabla().resumirI(datos, n, suma, minimo, maximo);
+}
+
+size_t Kernels::posicionMinimo(const float* datos, size_t n) {
+    return n == 0 ? 0 : tabla().minimoF(datos, n);
+}
+
+size_t Kernels::posicionMinimo(const int* datos, size_t n) {
+    return n == 0 ? 0 : tabla().minimoI(datos, n);
+}
+
+size_t Kernels::posicionMaximo(const float* datos, size_t n) {
+    return n == 0 ? 0 : tabla().maximoF(datos, n);
+}
+
+size_t Kernels::posicionMaximo(const int* datos, size_t n) {
+    return n == 0 ? 0 : tabla().maximoI(datos, n);
+}
+
+double Kernels::desviacion(const float* datos, size_t n, double media) {
+    return tabla().desviacionF(datos, n, media);
+}
+
+double Kernels::desviacion(const int* datos, size_t n, double media) {
+    return tabla().desviacionI(datos, n, media);
+}
+
+double Kernels::varianza(const float* datos, size_t n) {
+    if (n == 0) return 0.0;
+    const TablaKernels& t = tabla();
+    double suma;
+    float minimo, maximo;
+    t.resumirF(datos, n, suma, minimo, maximo);
+    return t.desviacionF(datos, n, suma / static_cast<double>(n)) / static_cast<double>(n);
+}
+
+double Kernels::varianza(const int* datos, size_t n) {
+    if (n == 0) return 0.0;
+    const TablaKernels& t = tabla();
+    long long suma;
+    int minimo, maximo;
+    t.resumirI(datos, n, suma, minimo, maximo);
+    return t.desviacionI(datos, n, static_cast<double>(suma) / static_cast<double>(n)) / static_cast<double>(n);
+}
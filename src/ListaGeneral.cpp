@@ -6,62 +6,180 @@
  */
 
 #include "ListaGeneral.h"
+#include "Log.h"
+#include "Metricas.h"
+#include "PoolTrabajo.h"
+#include "SensorPresion.h"
+#include "SensorTemperatura.h"
+#include "VentanaTiempo.h"
 #include <cstring>
 
-ListaGeneral::ListaGeneral() : cabeza(nullptr) {
-    std::cout << "[ListaGeneral] Sistema de gestión inicializado." << std::endl;
+/// Capacidad inicial del índice por id
+static const int CAPACIDAD_INICIAL_INDICE = 16;
+
+/**
+ * @brief Procesa un sensor y, si hay métricas, mide cuánto tardó
+ * @tparam S Clase del sensor (con una clase final la llamada no es virtual)
+ * @param sensor Sensor a procesar
+ */
+template <typename S>
+static void procesarMedido(S* sensor) {
+    if (!Metricas::activas()) {
+        sensor->procesarLectura();
+        return;
+    }
+    long long t0 = relojNs();
+    sensor->procesarLectura();
+    Metricas::registrarLatencia(Operacion::PROCESO, relojNs() - t0);
+}
+
+ListaGeneral::ListaGeneral()
+    : cabeza(nullptr), cola(nullptr), porId(nullptr),
+      capacidadIndice(CAPACIDAD_INICIAL_INDICE), numSensores(0) {
+    porId = new SensorBase*[capacidadIndice];
+    for (int i = 0; i < capacidadIndice; i++) {
+        porId[i] = nullptr;
+    }
+    LOG_INFO("[ListaGeneral] Sistema de gestión inicializado.");
 }
 
 ListaGeneral::~ListaGeneral() {
-    std::cout << "\n--- Liberación de Memoria en Cascada ---" << std::endl;
+    LOG_INFO("\n--- Liberación de Memoria en Cascada ---");
     
     while (cabeza != nullptr) {
         NodoSensor* temp = cabeza;
         cabeza = cabeza->siguiente;
         
-        std::cout << "[Destructor General] Liberando Nodo: " << temp->sensor->getNombre() << std::endl;
+        LOG_DEPURACION("[Destructor General] Liberando Nodo: " << temp->sensor->getNombre());
         delete temp->sensor;  // Llama al destructor virtual de la clase derivada
-        delete temp;
     }
+    cola = nullptr;
+    poolNodos.liberarTodo();  // Los NodoSensor se devuelven en bloque
+    delete[] porId;
     
-    std::cout << "Sistema cerrado. Memoria limpia." << std::endl;
+    LOG_INFO("Sistema cerrado. Memoria limpia.");
 }
 
 void ListaGeneral::insertarSensor(SensorBase* sensor) {
-    NodoSensor* nuevo = new NodoSensor(sensor);
+    NodoSensor* nuevo = poolNodos.crear(sensor);
     
     if (cabeza == nullptr) {
         cabeza = nuevo;
     } else {
-        NodoSensor* actual = cabeza;
-        while (actual->siguiente != nullptr) {
-            actual = actual->siguiente;
-        }
-        actual->siguiente = nuevo;
+        cola->siguiente = nuevo;
+    }
+    cola = nuevo;
+    indexar(sensor);
+
+    // Todos los sensores están en algún grupo: la suma es su posición en la lista
+    int posicion = temperaturas.cantidad + presiones.cantidad + otros.cantidad;
+    switch (sensor->getTipo()) {
+        case TipoSensor::TEMPERATURA:
+            temperaturas.agregar(static_cast<SensorTemperatura*>(sensor), posicion);
+            break;
+        case TipoSensor::PRESION:
+            presiones.agregar(static_cast<SensorPresion*>(sensor), posicion);
+            break;
+        default:
+            otros.agregar(sensor, posicion);
+            break;
     }
     
-    std::cout << "[ListaGeneral] Sensor '" << sensor->getNombre() << "' insertado en lista de gestión." << std::endl;
+    LOG_INFO("[ListaGeneral] Sensor '" << sensor->getNombre() << "' insertado en lista de gestión.");
 }
 
 SensorBase* ListaGeneral::buscarSensor(const char* nombre) {
-    NodoSensor* actual = cabeza;
-    while (actual != nullptr) {
-        if (strcmp(actual->sensor->getNombre(), nombre) == 0) {
-            return actual->sensor;
-        }
-        actual = actual->siguiente;
+    return buscarSensor(nombre, static_cast<int>(strlen(nombre)));
+}
+
+SensorBase* ListaGeneral::buscarSensor(const char* nombre, int longitud) {
+    IdNombre id = TablaNombres::global().buscar(nombre, longitud);
+    return id == TablaNombres::NINGUNO ? nullptr : buscarPorId(id);
+}
+
+void ListaGeneral::indexar(SensorBase* sensor) {
+    IdNombre id = sensor->getIdNombre();
+    if (id == TablaNombres::NINGUNO) return;    // Sin id (tabla de nombres llena): sólo está en la lista
+    if (id >= static_cast<IdNombre>(capacidadIndice)) {
+        crecerIndice(id);
+    }
+    // Con nombres repetidos se conserva el primero, igual que la búsqueda lineal
+    if (porId[id] == nullptr) {
+        porId[id] = sensor;
+        numSensores++;
+    }
+}
+
+void ListaGeneral::crecerIndice(IdNombre id) {
+    int nueva = capacidadIndice;
+    while (static_cast<IdNombre>(nueva) <= id) {
+        nueva *= 2;
+    }
+    SensorBase** arreglo = new SensorBase*[nueva];
+    memcpy(arreglo, porId, sizeof(SensorBase*) * capacidadIndice);
+    for (int i = capacidadIndice; i < nueva; i++) {
+        arreglo[i] = nullptr;
     }
-    return nullptr;
+    delete[] porId;
+    porId = arreglo;
+    capacidadIndice = nueva;
 }
 
 void ListaGeneral::procesarTodosSensores() {
-    std::cout << "\n--- Ejecutando Polimorfismo ---" << std::endl;
-    
-    NodoSensor* actual = cabeza;
-    while (actual != nullptr) {
-        actual->sensor->procesarLectura();  // Polimorfismo en acción
-        actual = actual->siguiente;
+    LOG_INFO("\n--- Ejecutando Polimorfismo ---");
+
+    // Las clases son final: con la etiqueta, sus llamadas no son virtuales
+    for (NodoSensor* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+        SensorBase* sensor = actual->sensor;
+        switch (sensor->getTipo()) {
+            case TipoSensor::TEMPERATURA:
+                procesarMedido(static_cast<SensorTemperatura*>(sensor));
+                break;
+            case TipoSensor::PRESION:
+                procesarMedido(static_cast<SensorPresion*>(sensor));
+                break;
+            default:
+                procesarMedido(sensor);  // Polimorfismo en acción
+                break;
+        }
+    }
+}
+
+void ListaGeneral::procesarTodosSensores(PoolTrabajo& pool) {
+    LOG_INFO("\n--- Ejecutando Polimorfismo ---");
+
+    // Índices [0, nT) temperaturas, [nT, nT + nP) presiones y después tipos de usuario
+    const int nT = temperaturas.cantidad;
+    const int nP = presiones.cantidad;
+    const int total = nT + nP + otros.cantidad;
+    if (total == 0) return;
+
+    // Una captura por sensor, en la casilla de su posición en la lista:
+    // la salida no se intercala entre hilos y sale en el orden de la lista
+    CapturaLog* salidas = new CapturaLog[total];
+    pool.paraCada(total, [this, salidas, nT, nP](int k) {
+        if (k < nT) {
+            CapturaLog& salida = salidas[temperaturas.posiciones[k]];
+            salida.iniciar();
+            procesarMedido(temperaturas.sensores[k]);
+            salida.terminar();
+        } else if (k < nT + nP) {
+            CapturaLog& salida = salidas[presiones.posiciones[k - nT]];
+            salida.iniciar();
+            procesarMedido(presiones.sensores[k - nT]);
+            salida.terminar();
+        } else {
+            CapturaLog& salida = salidas[otros.posiciones[k - nT - nP]];
+            salida.iniciar();
+            procesarMedido(otros.sensores[k - nT - nP]);  // Polimorfismo en acción
+            salida.terminar();
+        }
+    });
+
+    for (int k = 0; k < total; k++) {
+        salidas[k].emitir();
     }
+    delete[] salidas;
 }
 
 void ListaGeneral::imprimirTodos() const {
@@ -80,3 +198,11 @@ void ListaGeneral::imprimirTodos() const {
 bool ListaGeneral::estaVacia() const {
     return cabeza == nullptr;
 }
+
+int ListaGeneral::getNumSensores() const {
+    return numSensores;
+}
+
+EstadisticasPool ListaGeneral::getEstadisticasNodos() const {
+    return poolNodos.estadisticas();
+}
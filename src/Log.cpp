@@ -0,0 +1,340 @@
+/**
+ * @file Log.cpp
+ * @brief Implementación de la bitácora por niveles con hilo escritor
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "Log.h"
+#include "ColaAcotada.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/// Capacidad de la cola de registros pendientes
+const size_t CAPACIDAD_COLA_LOG = 8192;
+
+/**
+ * @brief Registro copiado en la cola del hilo escritor
+ */
+struct RegistroPendiente {
+    NivelLog nivel;                     ///< Nivel del mensaje
+    int longitud;                       ///< Longitud del texto
+    char texto[Log::LONGITUD_MAXIMA];   ///< Texto sin terminador
+};
+
+std::atomic<int> nivelActual(static_cast<int>(NivelLog::INFO));
+std::atomic<bool> asincrono(false);
+std::atomic<bool> detenerSolicitado(false);
+std::atomic<bool> escritorDurmiendo(false);
+std::atomic<long long> encolados(0);
+std::atomic<long long> escritos(0);
+std::atomic<long long> numDescartados(0);
+
+ColaAcotada<RegistroPendiente>* cola = nullptr;
+std::thread hiloEscritor;
+std::mutex mutexEscritor;
+std::condition_variable avisoEscritor;
+bool atexitRegistrado = false;
+
+/// Captura activa en el hilo actual (nullptr = publicar directamente)
+thread_local CapturaLog* capturaHilo = nullptr;
+
+/**
+ * @brief Escribe un mensaje en la salida correspondiente a su nivel
+ */
+void escribir(NivelLog nivel, const char* texto, int longitud) {
+    std::ostream& salida = (nivel >= NivelLog::AVISO) ? std::cerr : std::cout;
+    salida.write(texto, longitud);
+    salida.put('\n');
+}
+
+/**
+ * @brief Escribe todos los registros pendientes de la cola
+ * @return true si se escribió al menos uno
+ */
+bool drenarCola() {
+    bool alguno = false;
+    RegistroPendiente r;
+    while (cola->desencolar(r)) {
+        escribir(r.nivel, r.texto, r.longitud);
+        escritos.fetch_add(1, std::memory_order_release);
+        alguno = true;
+    }
+    return alguno;
+}
+
+/**
+ * @brief Bucle del hilo escritor
+ */
+void bucleEscritor() {
+    while (true) {
+        if (drenarCola()) {
+            std::cout.flush();
+        }
+        if (detenerSolicitado.load(std::memory_order_acquire)) {
+            drenarCola();
+            std::cout.flush();
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutexEscritor);
+        escritorDurmiendo.store(true, std::memory_order_release);
+        avisoEscritor.wait_for(lock, std::chrono::milliseconds(5), [] {
+            return cola->tamanioAproximado() > 0 || detenerSolicitado.load(std::memory_order_acquire);
+        });
+        escritorDurmiendo.store(false, std::memory_order_release);
+    }
+}
+
+} // namespace
+
+void Log::setNivel(NivelLog nivel) {
+    nivelActual.store(static_cast<int>(nivel), std::memory_order_relaxed);
+}
+
+NivelLog Log::getNivel() {
+    return static_cast<NivelLog>(nivelActual.load(std::memory_order_relaxed));
+}
+
+bool Log::habilitado(NivelLog nivel) {
+    return static_cast<int>(nivel) >= nivelActual.load(std::memory_order_relaxed);
+}
+
+bool Log::nivelDesdeTexto(const char* texto, NivelLog& nivel) {
+    static const char* const nombres[] = { "traza", "depuracion", "info", "aviso", "error", "ninguno" };
+    for (int i = 0; i < 6; i++) {
+        if (strcmp(texto, nombres[i]) == 0) {
+            nivel = static_cast<NivelLog>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Log::configurarDesdeEntorno() {
+    const char* valor = std::getenv("IOT_LOG_NIVEL");
+    NivelLog nivel;
+    if (valor != nullptr && nivelDesdeTexto(valor, nivel)) {
+        setNivel(nivel);
+    }
+}
+
+void Log::iniciarAsincrono() {
+    if (asincrono.load()) return;
+
+    if (cola == nullptr) {
+        cola = new ColaAcotada<RegistroPendiente>(CAPACIDAD_COLA_LOG);
+    }
+    detenerSolicitado.store(false);
+    hiloEscritor = std::thread(bucleEscritor);
+    asincrono.store(true, std::memory_order_release);
+
+    if (!atexitRegistrado) {
+        std::atexit(Log::detener);
+        atexitRegistrado = true;
+    }
+}
+
+void Log::detener() {
+    if (!asincrono.exchange(false)) return;
+
+    detenerSolicitado.store(true, std::memory_order_release);
+    avisoEscritor.notify_one();
+    hiloEscritor.join();
+
+    // Registros que alcanzaron a encolarse mientras se detenía el hilo
+    drenarCola();
+    std::cout.flush();
+
+    long long perdidos = numDescartados.load();
+    if (perdidos > 0) {
+        std::cerr << "[Log] " << perdidos << " mensajes de traza o depuración descartados por cola llena." << std::endl;
+    }
+}
+
+void Log::vaciar() {
+    if (asincrono.load(std::memory_order_acquire)) {
+        while (escritos.load(std::memory_order_acquire) < encolados.load(std::memory_order_acquire)) {
+            avisoEscritor.notify_one();
+            std::this_thread::yield();
+        }
+    }
+    std::cout.flush();
+}
+
+long long Log::descartados() {
+    return numDescartados.load(std::memory_order_relaxed);
+}
+
+void Log::publicar(NivelLog nivel, const char* texto, int longitud) {
+    if (capturaHilo != nullptr) {
+        capturaHilo->agregar(nivel, texto, longitud);
+        return;
+    }
+    publicarDirecto(nivel, texto, longitud);
+}
+
+void Log::publicarDirecto(NivelLog nivel, const char* texto, int longitud) {
+    if (!asincrono.load(std::memory_order_acquire)) {
+        escribir(nivel, texto, longitud);
+        return;
+    }
+
+    RegistroPendiente r;
+    r.nivel = nivel;
+    r.longitud = longitud < LONGITUD_MAXIMA ? longitud : LONGITUD_MAXIMA;
+    memcpy(r.texto, texto, r.longitud);
+
+    // Con la cola llena sólo se pierde el detalle; lo demás espera al
+    // escritor para no saltarse mensajes ni alterar su orden
+    while (!cola->encolar(r)) {
+        if (nivel < NivelLog::INFO) {
+            numDescartados.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!asincrono.load(std::memory_order_acquire)) {
+            // detener() ya retiró al escritor: se escribe aquí mismo
+            escribir(nivel, r.texto, r.longitud);
+            return;
+        }
+        avisoEscritor.notify_one();
+        std::this_thread::yield();
+    }
+    encolados.fetch_add(1, std::memory_order_release);
+    if (escritorDurmiendo.load(std::memory_order_acquire)) {
+        avisoEscritor.notify_one();
+    }
+}
+
+CapturaLog::CapturaLog() : datos(nullptr), tamanio(0), capacidad(0), anterior(nullptr) {}
+
+CapturaLog::~CapturaLog() {
+    if (capturaHilo == this) {
+        terminar();
+    }
+    delete[] datos;
+}
+
+void CapturaLog::agregar(NivelLog nivel, const char* texto, int longitud) {
+    if (longitud > Log::LONGITUD_MAXIMA) longitud = Log::LONGITUD_MAXIMA;
+    int necesario = 1 + static_cast<int>(sizeof(int)) + longitud;
+    if (tamanio + necesario > capacidad) {
+        int nuevaCapacidad = capacidad > 0 ? capacidad * 2 : 512;
+        while (nuevaCapacidad < tamanio + necesario) {
+            nuevaCapacidad *= 2;
+        }
+        char* nuevos = new char[nuevaCapacidad];
+        if (tamanio > 0) {
+            memcpy(nuevos, datos, tamanio);
+        }
+        delete[] datos;
+        datos = nuevos;
+        capacidad = nuevaCapacidad;
+    }
+    datos[tamanio] = static_cast<char>(nivel);
+    memcpy(datos + tamanio + 1, &longitud, sizeof(int));
+    memcpy(datos + tamanio + 1 + sizeof(int), texto, longitud);
+    tamanio += necesario;
+}
+
+void CapturaLog::iniciar() {
+    anterior = capturaHilo;
+    capturaHilo = this;
+}
+
+void CapturaLog::terminar() {
+    capturaHilo = anterior;
+    anterior = nullptr;
+}
+
+void CapturaLog::emitir() {
+    int pos = 0;
+    while (pos < tamanio) {
+        NivelLog nivel = static_cast<NivelLog>(datos[pos]);
+        int longitud;
+        memcpy(&longitud, datos + pos + 1, sizeof(int));
+        const char* texto = datos + pos + 1 + sizeof(int);
+        // Si este hilo también captura, los mensajes pasan a esa captura
+        Log::publicar(nivel, texto, longitud);
+        pos += 1 + static_cast<int>(sizeof(int)) + longitud;
+    }
+    tamanio = 0;
+}
+
+bool CapturaLog::estaVacia() const {
+    return tamanio == 0;
+}
+
+RegistroLog::RegistroLog(NivelLog nivel) : nivel(nivel), longitud(0) {
+    texto[0] = '\0';
+}
+
+RegistroLog::~RegistroLog() {
+    Log::publicar(nivel, texto, longitud);
+}
+
+void RegistroLog::agregar(const char* s, int n) {
+    int disponible = Log::LONGITUD_MAXIMA - longitud;
+    if (n > disponible) n = disponible;
+    if (n <= 0) return;
+    memcpy(texto + longitud, s, n);
+    longitud += n;
+    texto[longitud] = '\0';
+}
+
+RegistroLog& RegistroLog::operator<<(const char* s) {
+    if (s == nullptr) s = "(null)";
+    agregar(s, static_cast<int>(strlen(s)));
+    return *this;
+}
+
+RegistroLog& RegistroLog::operator<<(char c) {
+    agregar(&c, 1);
+    return *this;
+}
+
+RegistroLog& RegistroLog::operator<<(int v) {
+    return *this << static_cast<long long>(v);
+}
+
+RegistroLog& RegistroLog::operator<<(long v) {
+    return *this << static_cast<long long>(v);
+}
+
+RegistroLog& RegistroLog::operator<<(long long v) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%lld", v);
+    agregar(buf, n);
+    return *this;
+}
+
+RegistroLog& RegistroLog::operator<<(unsigned int v) {
+    return *this << static_cast<unsigned long long>(v);
+}
+
+RegistroLog& RegistroLog::operator<<(unsigned long v) {
+    return *this << static_cast<unsigned long long>(v);
+}
+
+RegistroLog& RegistroLog::operator<<(unsigned long long v) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%llu", v);
+    agregar(buf, n);
+    return *this;
+}
+
+RegistroLog& RegistroLog::operator<<(double v) {
+    // %g reproduce el formato por defecto de std::cout (6 cifras significativas)
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "%g", v);
+    agregar(buf, n);
+    return *this;
+}
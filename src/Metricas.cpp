@@ -0,0 +1,185 @@
+/**
+ * @file Metricas.cpp
+ * @brief Implementación de las ranuras de métricas por hilo
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "Metricas.h"
+#include <cstring>
+
+/**
+ * @brief Métricas de un hilo
+ *
+ * Sólo el hilo dueño escribe (salvo en la ranura compartida), así que
+ * cada incremento es una carga y un almacenamiento relajados.
+ */
+struct RanuraMetricas {
+    std::atomic<bool> ocupada;      ///< Algún hilo vivo la usa
+    bool compartida;                ///< La usan varios hilos: incrementos con fetch_add
+    std::atomic<long long> contadores[NUM_CONTADORES];                          ///< Contadores del hilo
+    std::atomic<long long> cubetas[NUM_OPERACIONES][CubetasLatencia::CANTIDAD]; ///< Histogramas del hilo
+    std::atomic<long long> muestras[NUM_OPERACIONES];                           ///< Latencias medidas
+    std::atomic<long long> sumaNs[NUM_OPERACIONES];                             ///< Suma de las latencias
+
+    /**
+     * @brief Constructor: todo en cero
+     * @param esCompartida Ranura para los hilos que no alcanzaron una propia
+     */
+    explicit RanuraMetricas(bool esCompartida) : ocupada(true), compartida(esCompartida) {
+        for (int c = 0; c < NUM_CONTADORES; c++) contadores[c].store(0, std::memory_order_relaxed);
+        for (int op = 0; op < NUM_OPERACIONES; op++) {
+            for (int k = 0; k < CubetasLatencia::CANTIDAD; k++) cubetas[op][k].store(0, std::memory_order_relaxed);
+            muestras[op].store(0, std::memory_order_relaxed);
+            sumaNs[op].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Suma a un valor de la ranura
+     * @param valor Contador destino
+     * @param n Cantidad
+     */
+    void incrementar(std::atomic<long long>& valor, long long n) {
+        if (compartida) {
+            valor.fetch_add(n, std::memory_order_relaxed);
+        } else {
+            valor.store(valor.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    }
+};
+
+std::atomic<bool> Metricas::activadas(false);
+
+/// Ranuras creadas (nunca se liberan: sus sumas siguen contando)
+static std::atomic<RanuraMetricas*> ranuras[Metricas::MAX_RANURAS];
+/// Ranuras en uso del arreglo
+static std::atomic<int> numRanuras(0);
+/// Ranura de los hilos que llegan cuando ya no quedan propias
+static RanuraMetricas ranuraCompartida(true);
+
+/**
+ * @brief Devuelve la ranura al terminar el hilo
+ */
+struct DuenoRanura {
+    RanuraMetricas* ranura;     ///< Ranura del hilo (nullptr hasta el primer uso)
+    unsigned int turno;         ///< Contador del muestreo
+
+    ~DuenoRanura() {
+        if (ranura != nullptr && !ranura->compartida) {
+            ranura->ocupada.store(false, std::memory_order_release);
+        }
+    }
+};
+
+/// Ranura y turno de muestreo del hilo actual
+static thread_local DuenoRanura duenoHilo = {nullptr, 0};
+
+/**
+ * @brief Toma una ranura libre, crea una nueva o usa la compartida
+ */
+static RanuraMetricas* tomarRanura() {
+    int n = numRanuras.load(std::memory_order_acquire);
+    if (n > Metricas::MAX_RANURAS) n = Metricas::MAX_RANURAS;
+    for (int i = 0; i < n; i++) {
+        RanuraMetricas* r = ranuras[i].load(std::memory_order_acquire);
+        bool libre = false;
+        if (r != nullptr && r->ocupada.compare_exchange_strong(libre, true, std::memory_order_acquire)) {
+            return r;
+        }
+    }
+    int i = numRanuras.fetch_add(1, std::memory_order_acq_rel);
+    if (i >= Metricas::MAX_RANURAS) {
+        return &ranuraCompartida;
+    }
+    RanuraMetricas* r = new RanuraMetricas(false);
+    ranuras[i].store(r, std::memory_order_release);
+    return r;
+}
+
+/**
+ * @brief Ranura del hilo actual
+ */
+static RanuraMetricas& ranuraHilo() {
+    if (duenoHilo.ranura == nullptr) {
+        duenoHilo.ranura = tomarRanura();
+    }
+    return *duenoHilo.ranura;
+}
+
+void Metricas::activar(bool valor) {
+    activadas.store(valor, std::memory_order_relaxed);
+}
+
+void Metricas::sumar(Contador c, long long n) {
+    if (n == 0 || !activas()) return;
+    RanuraMetricas& r = ranuraHilo();
+    r.incrementar(r.contadores[static_cast<int>(c)], n);
+}
+
+bool Metricas::muestrear() {
+    if (!activas()) return false;
+    return (++duenoHilo.turno & (MUESTREO - 1)) == 0;
+}
+
+void Metricas::registrarLatencia(Operacion op, long long ns) {
+    if (!activas()) return;
+    RanuraMetricas& r = ranuraHilo();
+    int o = static_cast<int>(op);
+    r.incrementar(r.cubetas[o][CubetasLatencia::indice(ns)], 1);
+    r.incrementar(r.muestras[o], 1);
+    r.incrementar(r.sumaNs[o], ns > 0 ? ns : 0);
+}
+
+/**
+ * @brief Suma una ranura en un resumen
+ * @param r Ranura
+ * @param destino Resumen acumulado
+ */
+static void sumarRanura(const RanuraMetricas& r, ResumenMetricas& destino) {
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        destino.contadores[c] += r.contadores[c].load(std::memory_order_relaxed);
+    }
+    for (int op = 0; op < NUM_OPERACIONES; op++) {
+        for (int k = 0; k < CubetasLatencia::CANTIDAD; k++) {
+            destino.cubetas[op][k] += r.cubetas[op][k].load(std::memory_order_relaxed);
+        }
+        destino.muestras[op] += r.muestras[op].load(std::memory_order_relaxed);
+        destino.sumaNs[op] += r.sumaNs[op].load(std::memory_order_relaxed);
+    }
+}
+
+void Metricas::leer(ResumenMetricas& destino) {
+    memset(&destino, 0, sizeof(destino));
+    int n = numRanuras.load(std::memory_order_acquire);
+    if (n > MAX_RANURAS) n = MAX_RANURAS;
+    for (int i = 0; i < n; i++) {
+        // Una ranura recién reservada puede no estar publicada todavía
+        RanuraMetricas* r = ranuras[i].load(std::memory_order_acquire);
+        if (r != nullptr) {
+            sumarRanura(*r, destino);
+            destino.hilos++;
+        }
+    }
+    sumarRanura(ranuraCompartida, destino);
+}
+
+long long ResumenMetricas::cuantilNs(Operacion op, double fraccion) const {
+    int o = static_cast<int>(op);
+    long long total = 0;
+    for (int k = 0; k < CubetasLatencia::CANTIDAD; k++) {
+        total += cubetas[o][k];
+    }
+    if (total == 0) return 0;
+
+    long long objetivo = static_cast<long long>(fraccion * static_cast<double>(total));
+    if (objetivo >= total) objetivo = total - 1;
+    long long acumuladas = 0;
+    for (int k = 0; k < CubetasLatencia::CANTIDAD; k++) {
+        acumuladas += cubetas[o][k];
+        if (acumuladas > objetivo) {
+            return (CubetasLatencia::limiteInferior(k) + CubetasLatencia::limiteInferior(k + 1)) / 2;
+        }
+    }
+    return CubetasLatencia::limiteInferior(CubetasLatencia::CANTIDAD);
+}
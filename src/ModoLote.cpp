@@ -0,0 +1,500 @@
+/**
+ * @file ModoLote.cpp
+ * @brief Implementación del modo de ingesta por lotes
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "ModoLote.h"
+#include "Instantanea.h"
+#include "DiarioLecturas.h"
+#include "ExportadorMetricas.h"
+#include "IngestaMultipuerto.h"
+#include "ListaGeneral.h"
+#include "MotorIngesta.h"
+#include "PipelineIngesta.h"
+#include "PoolTrabajo.h"
+#include "SerialReader.h"
+#include "Log.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <signal.h>
+#endif
+
+/// Tamaño del bloque de lectura del modo por lotes
+static const int TAM_BLOQUE_LOTE = 256 * 1024;
+
+/// Se activa con Ctrl+C para terminar la ingesta de forma ordenada
+static volatile std::sig_atomic_t detenerLote = 0;
+
+/**
+ * @brief Manejador de SIGINT: solicita terminar la ingesta
+ */
+static void alInterrumpir(int) {
+    detenerLote = 1;
+}
+
+/**
+ * @brief Instala el manejador de Ctrl+C sin reiniciar lecturas bloqueadas
+ */
+static void instalarManejadorInterrupcion() {
+#ifndef _WIN32
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = alInterrumpir;
+    sigemptyset(&accion.sa_mask);
+    accion.sa_flags = 0;    // Sin SA_RESTART: read() regresa con EINTR
+    sigaction(SIGINT, &accion, nullptr);
+#else
+    std::signal(SIGINT, alInterrumpir);
+#endif
+}
+
+/**
+ * @brief Lee un entero no negativo de un argumento
+ * @param texto Argumento
+ * @param valor Destino
+ * @return false si el texto no es un entero válido
+ */
+static bool leerEntero(const char* texto, long long& valor) {
+    char* fin = nullptr;
+    long long v = strtoll(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || v < 0) return false;
+    valor = v;
+    return true;
+}
+
+bool analizarArgumentosLote(int argc, char* argv[], OpcionesLote& opciones) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool tieneValor = i + 1 < argc;
+
+        if (strcmp(arg, "--ingesta") == 0 && tieneValor) {
+            if (opciones.numFuentes == MAX_FUENTES_LOTE) return false;
+            opciones.fuentes[opciones.numFuentes++] = argv[++i];
+            opciones.fuente = opciones.fuentes[0];
+        } else if (strcmp(arg, "--baudios") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v)) return false;
+            opciones.baudios = static_cast<int>(v);
+        } else if (strcmp(arg, "--procesar-cada") == 0 && tieneValor) {
+            if (!leerEntero(argv[++i], opciones.procesarCada)) return false;
+        } else if (strcmp(arg, "--sin-procesar") == 0) {
+            opciones.procesarAlFinal = false;
+        } else if (strcmp(arg, "--pipeline") == 0) {
+            opciones.pipeline = true;
+        } else if (strcmp(arg, "--hilos-analisis") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v < 1 || v > 64) return false;
+            opciones.hilosAnalisis = static_cast<int>(v);
+        } else if (strcmp(arg, "--hilos-registro") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v < 1 || v > 64) return false;
+            opciones.hilosRegistro = static_cast<int>(v);
+        } else if (strcmp(arg, "--retener") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v > 1000000000) return false;
+            opciones.retencion.maxLecturas = static_cast<int>(v);
+        } else if (strcmp(arg, "--retener-ms") == 0 && tieneValor) {
+            if (!leerEntero(argv[++i], opciones.retencion.maxEdadMs)) return false;
+        } else if (strcmp(arg, "--archivar") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v > 1000000000) return false;
+            opciones.retencion.lecturasArchivo = static_cast<int>(v);
+        } else if (strcmp(arg, "--instantanea") == 0 && tieneValor) {
+            opciones.instantanea = argv[++i];
+        } else if (strcmp(arg, "--diario") == 0 && tieneValor) {
+            opciones.diario = argv[++i];
+        } else if (strcmp(arg, "--diario-ms") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v < 1 || v > 60000) return false;
+            opciones.diarioMs = static_cast<int>(v);
+        } else if (strcmp(arg, "--diario-sin-fsync") == 0) {
+            opciones.diarioSincronizar = false;
+        } else if (strcmp(arg, "--formato") == 0 && tieneValor) {
+            const char* formato = argv[++i];
+            if (strcmp(formato, "auto") == 0) {
+                opciones.formato = FormatoFlujo::AUTOMATICO;
+            } else if (strcmp(formato, "texto") == 0) {
+                opciones.formato = FormatoFlujo::TEXTO;
+            } else if (strcmp(formato, "binario") == 0) {
+                opciones.formato = FormatoFlujo::BINARIO;
+            } else {
+                return false;
+            }
+        } else if (strcmp(arg, "--metricas") == 0 && tieneValor) {
+            opciones.metricas = argv[++i];
+        } else if (strcmp(arg, "--metricas-ms") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v < 1 || v > 3600000) return false;
+            opciones.metricasMs = static_cast<int>(v);
+        } else if (strcmp(arg, "--hilos-proceso") == 0 && tieneValor) {
+            long long v;
+            if (!leerEntero(argv[++i], v) || v > 256) return false;
+            opciones.hilosProceso = static_cast<int>(v);
+        } else if (strcmp(arg, "--mostrar") == 0) {
+            opciones.mostrarEstado = true;
+        } else if (strcmp(arg, "--log") == 0 && tieneValor) {
+            NivelLog nivel;
+            if (!Log::nivelDesdeTexto(argv[++i], nivel)) return false;
+            Log::setNivel(nivel);
+        } else {
+            return false;
+        }
+    }
+    return opciones.fuente != nullptr;
+}
+
+void mostrarUsoLote(const char* programa) {
+    std::cout << "Uso: " << programa << " --ingesta <archivo|dispositivo|-> [--ingesta ...] [opciones]\n"
+              << "  --ingesta F          Fuente; si se repite, todas se leen a la vez con epoll\n"
+              << "  --baudios N          Velocidad del puerto serial (9600)\n"
+              << "  --procesar-cada N    Procesar todos los sensores cada N lecturas\n"
+              << "  --sin-procesar       No procesar al terminar la fuente\n"
+              << "  --mostrar            Mostrar el estado de los sensores al terminar\n"
+              << "  --formato F          auto|texto|binario (auto se fija en el primero que llega\n"
+              << "                       válido; texto y binario envían el comando A o B\n"
+              << "                       al Arduino)\n"
+              << "  --pipeline           Ingesta multihilo (lector, analizadores, registradores)\n"
+              << "  --hilos-analisis N   Hilos analizadores de la tubería (2)\n"
+              << "  --hilos-registro N   Hilos registradores de la tubería (2)\n"
+              << "  --retener N          Conservar sólo las N lecturas más recientes por sensor\n"
+              << "  --retener-ms N       Descartar lecturas con más de N ms de antigüedad\n"
+              << "  --archivar N         Conservar comprimidas hasta N lecturas descartadas\n"
+              << "  --hilos-proceso N    Hilos del procesamiento (1 = secuencial, 0 = núcleos)\n"
+              << "  --instantanea RUTA   Restaurar los sensores de RUTA al inicio y guardarlos al final\n"
+              << "  --diario RUTA        Reproducir el diario RUTA al inicio y anotar en él cada lectura\n"
+              << "  --diario-ms N        Confirmar el diario en grupos cada N ms (10)\n"
+              << "  --diario-sin-fsync   No sincronizar el diario con el disco en cada grupo\n"
+              << "  --metricas DESTINO   Exportar métricas de Prometheus a un archivo o a unix:RUTA\n"
+              << "  --metricas-ms N      Reescribir el archivo de métricas cada N ms (1000)\n"
+              << "  --log NIVEL          traza|depuracion|info|aviso|error|ninguno\n"
+              << "Sin argumentos se inicia el menú interactivo." << std::endl;
+}
+
+/**
+ * @brief Imprime el resumen de rendimiento de la ingesta
+ */
+static void imprimirResumen(const EstadisticasIngesta& ingesta, const EstadisticasParseo& parseo,
+                            const ListaGeneral& sistema, double segundos, double segundosProceso) {
+    double base = segundos > 0.0 ? segundos : 1e-9;
+
+    std::cout << "\n=== Resumen de Ingesta ===" << std::endl;
+    std::cout << "Tiempo de ingesta:     " << segundos << " s" << std::endl;
+    std::cout << "Bytes leídos:          " << ingesta.bytes << std::endl;
+    std::cout << "Líneas:                " << parseo.lineas << std::endl;
+    std::cout << "Lecturas registradas:  " << ingesta.lecturas << std::endl;
+    std::cout << "Sensores:              " << sistema.getNumSensores()
+              << " (" << ingesta.sensoresCreados << " creados)" << std::endl;
+    std::cout << "Errores de análisis:   " << parseo.errores()
+              << " (campos " << parseo.errorCampos << ", tipo " << parseo.errorTipo
+              << ", id " << parseo.errorId << ", valor " << parseo.errorValor << ")" << std::endl;
+    std::cout << "Conflictos de tipo:    " << ingesta.conflictosTipo << std::endl;
+    std::cout << "Líneas demasiado largas: " << ingesta.lineasLargas << std::endl;
+    if (ingesta.tramas > 0 || ingesta.tramasInvalidas > 0) {
+        std::cout << "Tramas binarias:       " << ingesta.tramas << " (" << ingesta.tramasInvalidas
+                  << " inválidas, " << ingesta.tramasPerdidas << " perdidas)" << std::endl;
+    }
+    std::cout << std::fixed << std::setprecision(1)
+              << "Rendimiento:           " << parseo.lineas / base << " líneas/s, "
+              << ingesta.bytes / base / (1024.0 * 1024.0) << " MiB/s" << std::endl;
+    const EstadisticasLatencia& latencia = parseo.latencia;
+    if (latencia.marcas > 0) {
+        // Desde que el generador escribió la marca hasta que se analizó su línea
+        std::cout << "Latencia (" << latencia.marcas << " marcas): media "
+                  << static_cast<double>(latencia.totalUs) / static_cast<double>(latencia.marcas)
+                  << " µs, p50 <= " << latencia.percentilUs(0.50) << " µs, p99 <= " << latencia.percentilUs(0.99)
+                  << " µs, máx " << latencia.maximaUs << " µs" << std::endl;
+    }
+    std::cout << std::setprecision(3)
+              << "Tiempo de procesamiento: " << segundosProceso << " s" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+/**
+ * @brief Imprime el resultado de una carga o un guardado de instantánea
+ */
+static void imprimirInstantanea(const char* accion, const EstadisticasInstantanea& stats, double segundos) {
+    std::cout << std::fixed << std::setprecision(1)
+              << "Instantánea " << accion << ": " << stats.sensores << " sensores, " << stats.lecturas
+              << " lecturas, " << stats.bytes / (1024.0 * 1024.0) << " MiB en " << segundos * 1000.0 << " ms"
+              << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+/**
+ * @brief Imprime los contadores del diario de lecturas
+ */
+static void imprimirDiario(const EstadisticasDiario& stats) {
+    std::cout << std::fixed << std::setprecision(1)
+              << "Diario: " << stats.lecturas << " lecturas en " << stats.grupos << " grupos ("
+              << stats.sincronizaciones << " fsync, " << stats.esperas << " esperas), "
+              << stats.bytes / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+/**
+ * @brief Imprime los contadores de cada puerto de la ingesta multipuerto
+ */
+static void imprimirPuertos(const IngestaMultipuerto& puertos) {
+    std::cout << "\n=== Puertos ===" << std::endl;
+    for (int i = 0; i < puertos.getNumPuertos(); i++) {
+        EstadisticasPuerto stats = puertos.estadisticasPuerto(i);
+        std::cout << stats.ruta << ": " << stats.ingesta.bytes << " bytes, " << stats.parseo.lineas
+                  << " líneas, " << stats.ingesta.lecturas << " lecturas, " << stats.parseo.errores()
+                  << " errores, " << stats.eventos << " eventos, " << stats.llamadasLectura << " lecturas al sistema"
+                  << (stats.abierto ? " (interrumpido)" : "") << std::endl;
+    }
+}
+
+/**
+ * @brief Ingiere la fuente con la tubería multihilo
+ * @param opciones Opciones de la ejecución
+ * @param sistema Lista destino
+ * @param fuente Fuente ya conectada
+ * @param diario Diario de las lecturas aceptadas o nullptr
+ * @param exportador Exportador de métricas (sin la lista: la modifican los registradores)
+ * @param ingesta Destino de los contadores de ingesta
+ * @param parseo Destino de los contadores de análisis
+ */
+static void ingerirConPipeline(const OpcionesLote& opciones, ListaGeneral& sistema, SerialReader& fuente,
+                               DiarioLecturas* diario, ExportadorMetricas& exportador,
+                               EstadisticasIngesta& ingesta, EstadisticasParseo& parseo) {
+    if (opciones.procesarCada > 0) {
+        LOG_AVISO("[Lote] --procesar-cada se ignora con --pipeline; se procesa al terminar.");
+    }
+    if (opciones.formato == FormatoFlujo::BINARIO) {
+        LOG_AVISO("[Lote] --pipeline sólo analiza texto; las tramas binarias se contarán como errores.");
+    }
+
+    ConfiguracionPipeline config;
+    config.hilosAnalisis = opciones.hilosAnalisis;
+    config.hilosRegistro = opciones.hilosRegistro;
+    config.retencion = opciones.retencion;
+    config.diario = diario;
+    PipelineIngesta pipeline(sistema, config);
+    pipeline.iniciar(fuente);
+
+    // El hilo principal sólo vigila Ctrl+C y exporta las métricas
+    while (!pipeline.terminada()) {
+        if (detenerLote) {
+            pipeline.detener();
+        }
+        exportador.revisar(nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    pipeline.esperar();
+
+    EstadisticasPipeline stats = pipeline.estadisticas();
+    ingesta = stats.ingesta;
+    parseo = stats.parseo;
+    LOG_DEPURACION("[Lote] Bloques: " << stats.bloques << ", esperas del lector: " << stats.esperasLector);
+}
+
+/**
+ * @brief Ejecuta el procesamiento polimórfico, en paralelo si hay grupo de hilos
+ * @param sistema Lista de sensores
+ * @param pool Grupo de hilos o nullptr para procesar secuencialmente
+ */
+static void procesar(ListaGeneral& sistema, PoolTrabajo* pool) {
+    if (pool != nullptr) {
+        sistema.procesarTodosSensores(*pool);
+    } else {
+        sistema.procesarTodosSensores();
+    }
+}
+
+int ejecutarModoLote(const OpcionesLote& opciones) {
+    ListaGeneral sistema;
+    SerialReader fuente;
+    IngestaMultipuerto puertos(sistema);
+    const bool multipuerto = opciones.numFuentes > 1;
+    if (multipuerto) {
+        for (int i = 0; i < opciones.numFuentes; i++) {
+            if (!puertos.agregarPuerto(opciones.fuentes[i], opciones.baudios)) {
+                Log::vaciar();
+                std::cerr << "No se pudo abrir la fuente " << opciones.fuentes[i] << std::endl;
+                return 2;
+            }
+        }
+    } else if (!fuente.conectar(opciones.fuente, opciones.baudios)) {
+        Log::vaciar();
+        std::cerr << "No se pudo abrir la fuente " << opciones.fuente << std::endl;
+        return 2;
+    }
+
+    instalarManejadorInterrupcion();
+    PoolTrabajo* pool = opciones.hilosProceso != 1 ? new PoolTrabajo(opciones.hilosProceso) : nullptr;
+    MotorIngesta motor(sistema);
+    motor.setRetencion(opciones.retencion);
+    motor.setFormato(opciones.formato);
+    puertos.setRetencion(opciones.retencion);
+    puertos.setFormato(opciones.formato);
+    if (opciones.formato != FormatoFlujo::AUTOMATICO) {
+        // Sólo un puerto real recibe el comando; un archivo ya trae su formato
+        const char* comando = opciones.formato == FormatoFlujo::BINARIO ? "B" : "A";
+        if (multipuerto) {
+            int aceptados = puertos.enviarATodos(comando, 1);
+            LOG_DEPURACION("[Lote] Comando de formato " << comando << " enviado a " << aceptados << " puertos.");
+        } else if (!fuente.escribir(comando, 1)) {
+            LOG_DEPURACION("[Lote] La fuente no admite el comando de formato " << comando << ".");
+        }
+    }
+    EstadisticasIngesta ingesta = EstadisticasIngesta();
+    EstadisticasParseo parseo = EstadisticasParseo();
+
+    typedef std::chrono::steady_clock Reloj;
+    if (opciones.instantanea != nullptr) {
+        EstadisticasInstantanea cargada = EstadisticasInstantanea();
+        Reloj::time_point t0 = Reloj::now();
+        if (Instantanea::cargar(sistema, opciones.instantanea, opciones.retencion, &cargada)) {
+            Log::vaciar();
+            imprimirInstantanea("restaurada", cargada, std::chrono::duration<double>(Reloj::now() - t0).count());
+        }
+    }
+
+    // El diario contiene lo aceptado desde la última instantánea guardada
+    ConfiguracionDiario configDiario;
+    configDiario.intervaloMs = opciones.diarioMs;
+    configDiario.sincronizar = opciones.diarioSincronizar;
+    DiarioLecturas diario(configDiario);
+    if (opciones.diario != nullptr) {
+        MotorIngesta recuperacion(sistema);
+        recuperacion.setRetencion(opciones.retencion);
+        long long reproducidas = 0;
+        Reloj::time_point t0 = Reloj::now();
+        if (DiarioLecturas::reproducir(opciones.diario, recuperacion, &reproducidas)) {
+            Log::vaciar();
+            std::cout << std::fixed << std::setprecision(1) << "Diario reproducido: " << reproducidas
+                      << " lecturas en " << std::chrono::duration<double>(Reloj::now() - t0).count() * 1000.0
+                      << " ms" << std::endl;
+            std::cout.unsetf(std::ios::floatfield);
+            std::cout << std::setprecision(6);
+        }
+        if (!diario.abrir(opciones.diario)) {
+            Log::vaciar();
+            std::cerr << "No se pudo abrir el diario " << opciones.diario << std::endl;
+            delete pool;
+            return 2;
+        }
+        motor.setDiario(&diario);
+        puertos.setDiario(&diario);
+    }
+
+    // Se activa después de reproducir el diario: sólo cuenta la ingesta nueva
+    ExportadorMetricas exportador(opciones.metricas, opciones.metricasMs);
+    if (opciones.metricas != nullptr && !exportador.iniciar()) {
+        Log::vaciar();
+        std::cerr << "No se pudo exportar las métricas a " << opciones.metricas << std::endl;
+        delete pool;
+        return 2;
+    }
+
+    Reloj::time_point inicio = Reloj::now();
+    double segundosProceso = 0.0;
+    long long lecturasUltimoProceso = 0;
+
+    if (multipuerto) {
+        if (opciones.pipeline) {
+            LOG_AVISO("[Lote] --pipeline se ignora con varias fuentes; se leen en un solo hilo con epoll.");
+        }
+        while (puertos.puertosAbiertos() > 0 && !detenerLote) {
+            puertos.atender(100);
+
+            long long lecturas = puertos.estadisticas().lecturas;
+            if (opciones.procesarCada > 0 && lecturas - lecturasUltimoProceso >= opciones.procesarCada) {
+                Reloj::time_point t0 = Reloj::now();
+                procesar(sistema, pool);
+                segundosProceso += std::chrono::duration<double>(Reloj::now() - t0).count();
+                lecturasUltimoProceso = lecturas;
+            }
+            exportador.revisar(&sistema);
+        }
+        puertos.finalizar();
+        ingesta = puertos.estadisticas();
+        parseo = puertos.estadisticasParseo();
+    } else if (opciones.pipeline) {
+        ingerirConPipeline(opciones, sistema, fuente, opciones.diario != nullptr ? &diario : nullptr,
+                           exportador, ingesta, parseo);
+    }
+
+    char* bloque = multipuerto || opciones.pipeline ? nullptr : new char[TAM_BLOQUE_LOTE];
+    while (bloque != nullptr && !detenerLote) {
+        int n = fuente.leerBloque(bloque, TAM_BLOQUE_LOTE);
+        if (n < 0) break;
+        if (n == 0) continue;
+        motor.alimentar(bloque, static_cast<size_t>(n));
+
+        long long lecturas = motor.estadisticas().lecturas;
+        if (opciones.procesarCada > 0 && lecturas - lecturasUltimoProceso >= opciones.procesarCada) {
+            Reloj::time_point t0 = Reloj::now();
+            procesar(sistema, pool);
+            segundosProceso += std::chrono::duration<double>(Reloj::now() - t0).count();
+            lecturasUltimoProceso = lecturas;
+        }
+        exportador.revisar(&sistema);
+    }
+    if (bloque != nullptr) {
+        motor.finalizar();
+        ingesta = motor.estadisticas();
+        parseo = motor.estadisticasParseo();
+        delete[] bloque;
+    }
+    diario.cerrar();
+
+    // El tiempo de ingesta excluye el procesamiento periódico
+    double segundos = std::chrono::duration<double>(Reloj::now() - inicio).count() - segundosProceso;
+
+    if (opciones.procesarAlFinal) {
+        Reloj::time_point t0 = Reloj::now();
+        procesar(sistema, pool);
+        segundosProceso += std::chrono::duration<double>(Reloj::now() - t0).count();
+    }
+    delete pool;
+    exportador.exportar(&sistema);
+    Log::vaciar();
+
+    if (opciones.mostrarEstado) {
+        sistema.imprimirTodos();
+    }
+    imprimirResumen(ingesta, parseo, sistema, segundos, segundosProceso);
+    if (multipuerto) {
+        imprimirPuertos(puertos);
+    }
+    if (opciones.diario != nullptr) {
+        imprimirDiario(diario.estadisticas());
+    }
+    if (opciones.metricas != nullptr) {
+        std::cout << "Métricas: " << exportador.getExportaciones() << " exportaciones a "
+                  << exportador.getDestino() << std::endl;
+    }
+
+    if (opciones.instantanea != nullptr) {
+        EstadisticasInstantanea guardada = EstadisticasInstantanea();
+        Reloj::time_point t0 = Reloj::now();
+        bool ok = Instantanea::guardar(sistema, opciones.instantanea, &guardada);
+        Log::vaciar();
+        if (!ok) {
+            std::cerr << "No se pudo guardar la instantánea " << opciones.instantanea << std::endl;
+            return 3;
+        }
+        imprimirInstantanea("guardada", guardada, std::chrono::duration<double>(Reloj::now() - t0).count());
+
+        // Punto de control: todo lo del diario ya está en la instantánea
+        if (opciones.diario != nullptr) {
+            std::remove(opciones.diario);
+        }
+    }
+    return 0;
+}
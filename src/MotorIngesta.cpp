@@ -0,0 +1,331 @@
+/**
+ * @file MotorIngesta.cpp
+ * @brief Implementación de la ingesta de flujos TIPO,ID,VALOR
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "MotorIngesta.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "DiarioLecturas.h"
+#include "Log.h"
+#include "Metricas.h"
+#include "TramaBinaria.h"
+#include "VentanaTiempo.h"
+#include <cstring>
+
+MotorIngesta::MotorIngesta(ListaGeneral& lista)
+    : lista(lista), parser(), stats(), retencion(), diario(nullptr),
+      formato(FormatoFlujo::AUTOMATICO), formatoActivo(FormatoFlujo::AUTOMATICO), secuenciaEsperada(0), haySecuencia(false), publicadas(),
+      lineasPublicadas(0), validasPublicadas(0), erroresPublicados(0), tamPendiente(0), descartandoLinea(false) {
+    for (int t = 0; t < 2; t++) {
+        for (int c = 0; c < 128; c++) {
+            idsTrama[t][c] = TablaNombres::NINGUNO;
+        }
+    }
+}
+
+SensorBase* MotorIngesta::registrar(const LecturaParseada& lectura) {
+    return registrar(lectura, relojMs());
+}
+
+SensorBase* MotorIngesta::registrar(const LecturaParseada& lectura, long long tiempo) {
+    IdNombre id = TablaNombres::global().internar(lectura.id.data(), static_cast<int>(lectura.id.size()));
+    if (id == TablaNombres::NINGUNO) return nullptr;    // Tabla de nombres llena
+    return registrar(id, lectura, tiempo);
+}
+
+SensorBase* MotorIngesta::registrar(IdNombre id, const LecturaParseada& lectura, long long tiempo) {
+    bool medir = Metricas::muestrear();
+    long long t0 = medir ? relojNs() : 0;
+    SensorBase* sensor = asegurarSensor(lectura.tipo, id);
+    long long t1 = medir ? relojNs() : 0;
+    bool aplicada = aplicarLectura(sensor, lectura, tiempo);
+    if (medir) {
+        Metricas::registrarLatencia(Operacion::BUSQUEDA, t1 - t0);
+        Metricas::registrarLatencia(Operacion::INSERCION, relojNs() - t1);
+    }
+
+    if (aplicada) {
+        stats.lecturas++;
+        if (diario != nullptr) {
+            diario->registrar(lectura.tipo, id, lectura.valorFloat, lectura.valorEntero, tiempo);
+        }
+        return sensor;
+    }
+
+    stats.conflictosTipo++;
+    LOG_AVISO("[Ingesta] El sensor " << sensor->getNombre() << " no es de tipo " << lectura.tipo << ".");
+    return nullptr;
+}
+
+SensorBase* MotorIngesta::asegurarSensor(char tipo, IdNombre id) {
+    SensorBase* sensor = lista.buscarPorId(id);
+    if (sensor == nullptr) {
+        sensor = crearSensor(tipo, id, retencion);
+        lista.insertarSensor(sensor);
+        stats.sensoresCreados++;
+    }
+    return sensor;
+}
+
+SensorBase* MotorIngesta::crearSensor(char tipo, IdNombre id, const PoliticaRetencion& politica) {
+    const char* nombre = TablaNombres::global().nombre(id);
+    SensorBase* sensor;
+    if (tipo == 'T') {
+        sensor = new SensorTemperatura(nombre);
+    } else {
+        sensor = new SensorPresion(nombre);
+    }
+    if (politica.limitada()) {
+        sensor->configurarRetencion(politica);
+    }
+    return sensor;
+}
+
+void MotorIngesta::setRetencion(const PoliticaRetencion& politica) {
+    retencion = politica;
+}
+
+void MotorIngesta::setDiario(DiarioLecturas* diarioLecturas) {
+    diario = diarioLecturas;
+}
+
+void MotorIngesta::setFormato(FormatoFlujo formatoFlujo) {
+    formato = formatoFlujo;
+    formatoActivo = formatoFlujo;
+}
+
+bool MotorIngesta::aplicarLectura(SensorBase* sensor, const LecturaParseada& lectura, long long tiempo) {
+    if (lectura.tipo == 'T') {
+        SensorTemperatura* sensorTemp = sensorComo<SensorTemperatura>(sensor);
+        if (sensorTemp) {
+            sensorTemp->registrarLectura(lectura.valorFloat, tiempo);
+            return true;
+        }
+    } else {
+        SensorPresion* sensorPres = sensorComo<SensorPresion>(sensor);
+        if (sensorPres) {
+            sensorPres->registrarLectura(lectura.valorEntero, tiempo);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MotorIngesta::procesarLinea(const char* linea, size_t longitud, long long tiempo) {
+    LecturaParseada lectura;
+    if (parser.parsearLinea(std::string_view(linea, longitud), lectura) == ResultadoParseo::VALIDA) {
+        registrar(lectura, tiempo);
+    }
+}
+
+bool MotorIngesta::procesarTrama(const unsigned char* datos, long long tiempo) {
+    TramaDecodificada trama;
+    if (TramaBinaria::decodificar(datos, trama) != ResultadoTrama::VALIDA) {
+        stats.tramasInvalidas++;
+        return false;
+    }
+    if (haySecuencia && trama.secuencia != secuenciaEsperada) {
+        stats.tramasPerdidas += static_cast<unsigned char>(trama.secuencia - secuenciaEsperada);
+    }
+    secuenciaEsperada = static_cast<unsigned char>(trama.secuencia + 1);
+    haySecuencia = true;
+    stats.tramas++;
+    if (formatoActivo == FormatoFlujo::AUTOMATICO) {
+        formatoActivo = FormatoFlujo::BINARIO;
+        LOG_DEPURACION("[Ingesta] Formato detectado: tramas binarias.");
+    }
+
+    // El nombre "T-NNN" sólo se interna la primera vez que aparece su canal
+    IdNombre& id = idsTrama[trama.lectura.tipo == 'P' ? 1 : 0][datos[1] & 0x7F];
+    if (id == TablaNombres::NINGUNO) {
+        id = TablaNombres::global().internar(trama.lectura.id.data(), static_cast<int>(trama.lectura.id.size()));
+    }
+    if (id != TablaNombres::NINGUNO) {
+        registrar(id, trama.lectura, tiempo);
+    }
+    return true;
+}
+
+size_t MotorIngesta::saltoTramaInvalida(const unsigned char* trama) {
+    // Un bit dañado no cambia la longitud: la trama siguiente empieza después de ésta,
+    // salvo que otra sincronía dentro de ella indique que el 0xA5 era falso
+    const void* sincronia = memchr(trama + 1, TramaBinaria::SINCRONIA, TramaBinaria::LONGITUD - 1);
+    if (sincronia != nullptr) {
+        return static_cast<size_t>(static_cast<const unsigned char*>(sincronia) - trama);
+    }
+    return static_cast<size_t>(TramaBinaria::LONGITUD);
+}
+
+void MotorIngesta::cerrarLineaPendiente(long long tiempo) {
+    if (descartandoLinea) {
+        stats.lineasLargas++;
+    } else if (tamPendiente > 0) {
+        procesarLinea(pendiente, tamPendiente, tiempo);
+    }
+    tamPendiente = 0;
+    descartandoLinea = false;
+}
+
+void MotorIngesta::alimentar(const char* datos, size_t longitud) {
+    stats.bytes += static_cast<long long>(longitud);
+    long long tiempo = relojMs();
+    if (formatoActivo == FormatoFlujo::TEXTO) {
+        alimentarTexto(datos, longitud, tiempo);
+    } else {
+        alimentarMixto(datos, longitud, tiempo);
+    }
+    publicarMetricas();
+}
+
+void MotorIngesta::publicarMetricas() {
+    if (!Metricas::activas()) return;
+    const EstadisticasParseo& parseo = parser.estadisticas();
+    Metricas::sumar(Contador::BYTES_LEIDOS, stats.bytes - publicadas.bytes);
+    Metricas::sumar(Contador::LINEAS_LEIDAS, parseo.lineas - lineasPublicadas);
+    Metricas::sumar(Contador::LINEAS_VALIDAS, parseo.validas - validasPublicadas);
+    Metricas::sumar(Contador::LINEAS_RECHAZADAS, parseo.errores() - erroresPublicados);
+    Metricas::sumar(Contador::LECTURAS_REGISTRADAS, stats.lecturas - publicadas.lecturas);
+    Metricas::sumar(Contador::SENSORES_CREADOS, stats.sensoresCreados - publicadas.sensoresCreados);
+    Metricas::sumar(Contador::CONFLICTOS_TIPO, stats.conflictosTipo - publicadas.conflictosTipo);
+    Metricas::sumar(Contador::TRAMAS, stats.tramas - publicadas.tramas);
+    Metricas::sumar(Contador::TRAMAS_INVALIDAS, stats.tramasInvalidas - publicadas.tramasInvalidas);
+    Metricas::sumar(Contador::TRAMAS_PERDIDAS, stats.tramasPerdidas - publicadas.tramasPerdidas);
+    publicadas = stats;
+    lineasPublicadas = parseo.lineas;
+    validasPublicadas = parseo.validas;
+    erroresPublicados = parseo.errores();
+}
+
+void MotorIngesta::alimentarMixto(const char* datos, size_t longitud, long long tiempo) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(datos);
+    const size_t L = static_cast<size_t>(TramaBinaria::LONGITUD);
+    size_t pos = 0;
+
+    // Completar la trama que quedó partida en el bloque anterior
+    if (tamPendiente > 0 && static_cast<unsigned char>(pendiente[0]) == TramaBinaria::SINCRONIA) {
+        size_t previos = tamPendiente;
+        size_t falta = L - previos;
+        size_t tomar = falta < longitud ? falta : longitud;
+        memcpy(pendiente + previos, datos, tomar);
+        tamPendiente += tomar;
+        if (tamPendiente < L) {
+            return;
+        }
+        tamPendiente = 0;
+        if (procesarTrama(reinterpret_cast<const unsigned char*>(pendiente), tiempo)) {
+            pos = falta;
+        } else {
+            size_t salto = saltoTramaInvalida(reinterpret_cast<const unsigned char*>(pendiente));
+            if (salto < previos) {
+                // La sincronía siguiente estaba entre los bytes del bloque anterior
+                char anteriores[TramaBinaria::LONGITUD];
+                memcpy(anteriores, pendiente + salto, previos - salto);
+                alimentarMixto(anteriores, previos - salto, tiempo);
+                alimentarMixto(datos, longitud, tiempo);
+                return;
+            }
+            pos = salto - previos;
+        }
+    }
+
+    while (pos < longitud) {
+        if (bytes[pos] == TramaBinaria::SINCRONIA) {
+            cerrarLineaPendiente(tiempo);
+            if (longitud - pos < L) {
+                memcpy(pendiente, datos + pos, longitud - pos);
+                tamPendiente = longitud - pos;
+                return;
+            }
+            pos += procesarTrama(bytes + pos, tiempo) ? L : saltoTramaInvalida(bytes + pos);
+            continue;
+        }
+
+        // Tramo sin sincronía: texto, o bytes sueltos que se descartan en modo BINARIO
+        const void* sincronia = memchr(datos + pos, TramaBinaria::SINCRONIA, longitud - pos);
+        size_t fin = sincronia ? static_cast<size_t>(static_cast<const char*>(sincronia) - datos) : longitud;
+        if (formatoActivo == FormatoFlujo::AUTOMATICO) {
+            long long validas = parser.estadisticas().validas;
+            alimentarTexto(datos + pos, fin - pos, tiempo);
+            if (parser.estadisticas().validas > validas) {
+                // Primera línea válida: el resto del flujo es texto y un 0xA5 ya no abre tramas
+                formatoActivo = FormatoFlujo::TEXTO;
+                LOG_DEPURACION("[Ingesta] Formato detectado: texto.");
+                alimentarTexto(datos + fin, longitud - fin, tiempo);
+                return;
+            }
+        }
+        pos = fin;
+    }
+}
+
+void MotorIngesta::alimentarTexto(const char* datos, size_t longitud, long long tiempo) {
+    size_t inicio = 0;
+
+    // Completar la línea que quedó partida en el bloque anterior
+    if (tamPendiente > 0 || descartandoLinea) {
+        const void* fin = memchr(datos, '\n', longitud);
+        size_t hasta = fin ? static_cast<size_t>(static_cast<const char*>(fin) - datos) : longitud;
+
+        if (!descartandoLinea && tamPendiente + hasta <= sizeof(pendiente)) {
+            memcpy(pendiente + tamPendiente, datos, hasta);
+            tamPendiente += hasta;
+        } else {
+            descartandoLinea = true;
+        }
+
+        if (fin == nullptr) {
+            return;
+        }
+        if (descartandoLinea) {
+            stats.lineasLargas++;
+        } else {
+            procesarLinea(pendiente, tamPendiente, tiempo);
+        }
+        tamPendiente = 0;
+        descartandoLinea = false;
+        inicio = hasta + 1;
+    }
+
+    // Líneas completas: se analizan directamente sobre el bloque recibido
+    size_t consumidos = parser.parsearBloque(datos + inicio, longitud - inicio,
+        [this, tiempo](const LecturaParseada& lectura) { registrar(lectura, tiempo); });
+    inicio += consumidos;
+
+    // Guardar el fragmento final sin '\n'
+    size_t resto = longitud - inicio;
+    if (resto > sizeof(pendiente)) {
+        descartandoLinea = true;
+    } else if (resto > 0) {
+        memcpy(pendiente, datos + inicio, resto);
+        tamPendiente = resto;
+    }
+}
+
+void MotorIngesta::finalizar() {
+    if (formatoActivo != FormatoFlujo::TEXTO && tamPendiente > 0 &&
+        static_cast<unsigned char>(pendiente[0]) == TramaBinaria::SINCRONIA) {
+        stats.tramasInvalidas++;    // Trama truncada al final del flujo
+    } else if (descartandoLinea) {
+        stats.lineasLargas++;
+    } else if (tamPendiente > 0) {
+        procesarLinea(pendiente, tamPendiente, relojMs());
+    }
+    tamPendiente = 0;
+    descartandoLinea = false;
+    publicarMetricas();
+}
+
+const EstadisticasIngesta& MotorIngesta::estadisticas() const {
+    return stats;
+}
+
+const EstadisticasParseo& MotorIngesta::estadisticasParseo() const {
+    return parser.estadisticas();
+}
+
+ParserLineas& MotorIngesta::getParser() {
+    return parser;
+}
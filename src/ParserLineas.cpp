@@ -0,0 +1,143 @@
+/**
+ * @file ParserLineas.cpp
+ * @brief Implementación del analizador del protocolo TIPO,ID,VALOR
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "ParserLineas.h"
+#include "VentanaTiempo.h"
+#include <charconv>
+#include <cmath>
+
+/**
+ * @brief Quita espacios y tabuladores de ambos extremos
+ * @param campo Vista a recortar
+ * @return Vista recortada
+ */
+static std::string_view recortar(std::string_view campo) {
+    size_t ini = 0;
+    size_t fin = campo.size();
+    while (ini < fin && (campo[ini] == ' ' || campo[ini] == '\t')) ini++;
+    while (fin > ini && (campo[fin - 1] == ' ' || campo[fin - 1] == '\t' || campo[fin - 1] == '\r')) fin--;
+    return campo.substr(ini, fin - ini);
+}
+
+/**
+ * @brief Convierte un campo completo con std::from_chars
+ * @tparam N Tipo numérico destino
+ * @param campo Texto del número (se admite un '+' inicial, pero no seguido de otro signo)
+ * @param valor Destino
+ * @return true si todo el campo es un número válido
+ */
+template <typename N>
+static bool convertir(std::string_view campo, N& valor) {
+    if (!campo.empty() && campo[0] == '+') {
+        campo.remove_prefix(1);
+        // from_chars aceptaría el '-' de "+-5": un solo signo por número
+        if (!campo.empty() && (campo[0] == '-' || campo[0] == '+')) return false;
+    }
+    if (campo.empty()) return false;
+    const char* fin = campo.data() + campo.size();
+    std::from_chars_result r = std::from_chars(campo.data(), fin, valor);
+    return r.ec == std::errc() && r.ptr == fin;
+}
+
+ParserLineas::ParserLineas() : stats() {}
+
+ResultadoParseo ParserLineas::analizar(std::string_view linea, LecturaParseada& salida) {
+    linea = recortar(linea);
+    if (linea.empty()) return ResultadoParseo::VACIA;
+    if (linea[0] == '#') return ResultadoParseo::COMENTARIO;
+
+    // Exactamente tres campos separados por coma
+    size_t coma1 = linea.find(',');
+    if (coma1 == std::string_view::npos) return ResultadoParseo::ERROR_CAMPOS;
+    size_t coma2 = linea.find(',', coma1 + 1);
+    if (coma2 == std::string_view::npos) return ResultadoParseo::ERROR_CAMPOS;
+    if (linea.find(',', coma2 + 1) != std::string_view::npos) return ResultadoParseo::ERROR_CAMPOS;
+
+    std::string_view tipo = recortar(linea.substr(0, coma1));
+    std::string_view id = recortar(linea.substr(coma1 + 1, coma2 - coma1 - 1));
+    std::string_view valor = recortar(linea.substr(coma2 + 1));
+
+    if (tipo.size() != 1) return ResultadoParseo::ERROR_TIPO;
+    char t = tipo[0];
+    if (t == 't') t = 'T';
+    if (t == 'p') t = 'P';
+    if (t != 'T' && t != 'P') return ResultadoParseo::ERROR_TIPO;
+
+    if (id.empty() || id.size() > static_cast<size_t>(LONGITUD_MAXIMA_ID)) return ResultadoParseo::ERROR_ID;
+    for (char c : id) {
+        if (c <= ' ' || c > '~') return ResultadoParseo::ERROR_ID;
+    }
+
+    salida.tipo = t;
+    salida.id = id;
+    salida.valorFloat = 0.0f;
+    salida.valorEntero = 0;
+    if (t == 'T') {
+        if (!convertir(valor, salida.valorFloat) || !std::isfinite(salida.valorFloat)) {
+            return ResultadoParseo::ERROR_VALOR;
+        }
+    } else {
+        if (!convertir(valor, salida.valorEntero)) {
+            return ResultadoParseo::ERROR_VALOR;
+        }
+    }
+    return ResultadoParseo::VALIDA;
+}
+
+ResultadoParseo ParserLineas::parsearLinea(std::string_view linea, LecturaParseada& salida) {
+    ResultadoParseo r = analizar(linea, salida);
+    contabilizar(r);
+    if (r == ResultadoParseo::COMENTARIO) {
+        medirLatencia(linea);
+    }
+    return r;
+}
+
+void ParserLineas::medirLatencia(std::string_view linea) {
+    linea = recortar(linea);
+    size_t prefijo = strlen(PREFIJO_LATENCIA);
+    if (linea.size() <= prefijo || linea.compare(0, prefijo, PREFIJO_LATENCIA) != 0) return;
+
+    long long enviada = 0;
+    if (convertir(linea.substr(prefijo), enviada)) {
+        stats.latencia.registrar((relojNs() - enviada) / 1000);
+    }
+}
+
+void ParserLineas::contabilizar(ResultadoParseo r) {
+    stats.lineas++;
+    switch (r) {
+        case ResultadoParseo::VALIDA: stats.validas++; break;
+        case ResultadoParseo::VACIA: stats.vacias++; break;
+        case ResultadoParseo::COMENTARIO: stats.comentarios++; break;
+        case ResultadoParseo::ERROR_CAMPOS: stats.errorCampos++; break;
+        case ResultadoParseo::ERROR_TIPO: stats.errorTipo++; break;
+        case ResultadoParseo::ERROR_ID: stats.errorId++; break;
+        case ResultadoParseo::ERROR_VALOR: stats.errorValor++; break;
+    }
+}
+
+const EstadisticasParseo& ParserLineas::estadisticas() const {
+    return stats;
+}
+
+void ParserLineas::reiniciar() {
+    stats = EstadisticasParseo();
+}
+
+const char* ParserLineas::describir(ResultadoParseo r) {
+    switch (r) {
+        case ResultadoParseo::VALIDA: return "valida";
+        case ResultadoParseo::VACIA: return "vacia";
+        case ResultadoParseo::COMENTARIO: return "comentario";
+        case ResultadoParseo::ERROR_CAMPOS: return "numero de campos incorrecto";
+        case ResultadoParseo::ERROR_TIPO: return "tipo desconocido";
+        case ResultadoParseo::ERROR_ID: return "identificador invalido";
+        case ResultadoParseo::ERROR_VALOR: return "valor invalido";
+    }
+    return "desconocido";
+}
@@ -0,0 +1,507 @@
+/**
+ * @file PipelineIngesta.cpp
+ * @brief Implementación de la tubería de ingesta multihilo
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "PipelineIngesta.h"
+#include "ColaAcotada.h"
+#include "ColaSPSC.h"
+#include "DiarioLecturas.h"
+#include "Log.h"
+#include "Metricas.h"
+#include "VentanaTiempo.h"
+#include <chrono>
+#include <cstring>
+
+/// Lecturas por lote enviado de un analizador a un registrador
+static const int CAPACIDAD_LOTE = 256;
+
+/**
+ * @brief Bloque de texto leído de la fuente, terminado en '\n'
+ */
+struct PipelineIngesta::BloqueDatos {
+    char* datos;        ///< Memoria del bloque (tamBloque bytes)
+    size_t longitud;    ///< Bytes válidos
+    long long tiempo;   ///< Marca de tiempo (ms) de la lectura del bloque
+};
+
+/**
+ * @brief Lectura ya analizada con el ID internado (el bloque se recicla antes)
+ */
+struct MensajeLectura {
+    IdNombre id;        ///< IdNombre del sensor
+    char tipo;          ///< 'T' o 'P'
+    float valorFloat;   ///< Valor si tipo == 'T'
+    int valorEntero;    ///< Valor si tipo == 'P'
+};
+
+/**
+ * @brief Lote de lecturas de un bloque dirigidas a un mismo registrador
+ */
+struct PipelineIngesta::LoteLecturas {
+    int analizador;         ///< Analizador dueño del lote (al que se devuelve)
+    int cantidad;           ///< Lecturas en el lote
+    bool finBloque;         ///< Último lote del bloque para este registrador
+    long long tiempo;       ///< Marca de tiempo del bloque de origen
+    MensajeLectura mensajes[CAPACIDAD_LOTE];    ///< Lecturas
+};
+
+/**
+ * @brief Caché local de un registrador: IdNombre -> sensor
+ *
+ * Evita tomar el mutex de la lista en cada lectura; sólo los sensores que
+ * el registrador aún no ha visto pasan por ListaGeneral. Los ids son
+ * densos, así que basta un arreglo indexado por id.
+ */
+class PipelineIngesta::CacheSensores {
+private:
+    SensorBase** sensores;  ///< Sensor de cada id (nullptr = aún no visto)
+    IdNombre capacidad;     ///< Casillas de sensores
+
+public:
+    CacheSensores() : sensores(new SensorBase*[64]()), capacidad(64) {}
+
+    ~CacheSensores() {
+        delete[] sensores;
+    }
+
+    CacheSensores(const CacheSensores&) = delete;
+    CacheSensores& operator=(const CacheSensores&) = delete;
+
+    SensorBase* buscar(IdNombre id) const {
+        return id < capacidad ? sensores[id] : nullptr;
+    }
+
+    void insertar(IdNombre id, SensorBase* sensor) {
+        if (id >= capacidad) {
+            IdNombre nueva = capacidad * 2;
+            while (nueva <= id) {
+                nueva *= 2;
+            }
+            SensorBase** arreglo = new SensorBase*[nueva]();
+            memcpy(arreglo, sensores, sizeof(SensorBase*) * capacidad);
+            delete[] sensores;
+            sensores = arreglo;
+            capacidad = nueva;
+        }
+        sensores[id] = sensor;
+    }
+};
+
+/**
+ * @brief Espera activa breve y después cede/duerme para no quemar CPU
+ * @param intentos Intentos fallidos consecutivos (se incrementa)
+ */
+static void esperarTurno(int& intentos) {
+    if (++intentos < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+PipelineIngesta::PipelineIngesta(ListaGeneral& lista, const ConfiguracionPipeline& configuracion)
+    : lista(lista), config(configuracion), fuente(nullptr), bloques(nullptr), memoriaBloques(nullptr),
+      lotes(nullptr), lotesPorAnalizador(0), bloquesLibres(nullptr), colasBloques(nullptr),
+      colasLotes(nullptr), lotesLibres(nullptr), hilosAnalisis(nullptr), hilosRegistro(nullptr),
+      enMarcha(false), detenerSolicitado(false), etapasActivas(0), stats(),
+      parseoPorHilo(nullptr), ingestaPorHilo(nullptr) {
+    if (config.hilosAnalisis < 1) config.hilosAnalisis = 1;
+    if (config.hilosRegistro < 1) config.hilosRegistro = 1;
+    if (config.tamBloque < 4096) config.tamBloque = 4096;
+    if (config.numBloques < 2 * config.hilosAnalisis) config.numBloques = 2 * config.hilosAnalisis;
+
+    int P = config.hilosAnalisis;
+    int U = config.hilosRegistro;
+
+    // Bloques de datos: una sola reserva contigua
+    bloques = new BloqueDatos[config.numBloques];
+    memoriaBloques = new char[static_cast<size_t>(config.numBloques) * config.tamBloque];
+    bloquesLibres = new ColaAcotada<BloqueDatos*>(config.numBloques);
+    for (int i = 0; i < config.numBloques; i++) {
+        bloques[i].datos = memoriaBloques + static_cast<size_t>(i) * config.tamBloque;
+        bloques[i].longitud = 0;
+        bloquesLibres->encolar(&bloques[i]);
+    }
+
+    // Las colas caben todo lo que puede circular, así que encolar nunca falla
+    colasBloques = new ColaSPSC<BloqueDatos*>*[P];
+    for (int p = 0; p < P; p++) {
+        colasBloques[p] = new ColaSPSC<BloqueDatos*>(config.numBloques + 1);
+    }
+
+    // Cada analizador retiene un lote por registrador más los que circulan
+    lotesPorAnalizador = 4 * U + 4;
+    lotes = new LoteLecturas[static_cast<size_t>(P) * lotesPorAnalizador];
+    lotesLibres = new ColaAcotada<LoteLecturas*>*[P];
+    colasLotes = new ColaSPSC<LoteLecturas*>*[P * U];
+    for (int p = 0; p < P; p++) {
+        lotesLibres[p] = new ColaAcotada<LoteLecturas*>(lotesPorAnalizador);
+        for (int i = 0; i < lotesPorAnalizador; i++) {
+            LoteLecturas* lote = &lotes[p * lotesPorAnalizador + i];
+            lote->analizador = p;
+            lote->cantidad = 0;
+            lote->finBloque = false;
+            lotesLibres[p]->encolar(lote);
+        }
+        for (int u = 0; u < U; u++) {
+            colasLotes[p * U + u] = new ColaSPSC<LoteLecturas*>(lotesPorAnalizador + 1);
+        }
+    }
+
+    parseoPorHilo = new EstadisticasParseo[P]();
+    ingestaPorHilo = new EstadisticasIngesta[U]();
+
+    LOG_DEPURACION("[Pipeline] " << P << " analizadores, " << U << " registradores, "
+                   << config.numBloques << " bloques de " << config.tamBloque << " bytes.");
+}
+
+PipelineIngesta::~PipelineIngesta() {
+    if (enMarcha) {
+        detener();
+        esperar();
+    }
+
+    int P = config.hilosAnalisis;
+    int U = config.hilosRegistro;
+    for (int p = 0; p < P; p++) {
+        delete colasBloques[p];
+        delete lotesLibres[p];
+        for (int u = 0; u < U; u++) {
+            delete colasLotes[p * U + u];
+        }
+    }
+    delete[] colasBloques;
+    delete[] colasLotes;
+    delete[] lotesLibres;
+    delete bloquesLibres;
+    delete[] lotes;
+    delete[] memoriaBloques;
+    delete[] bloques;
+    delete[] parseoPorHilo;
+    delete[] ingestaPorHilo;
+}
+
+bool PipelineIngesta::iniciar(SerialReader& origen) {
+    if (enMarcha) {
+        return false;
+    }
+    fuente = &origen;
+    enMarcha = true;
+    detenerSolicitado.store(false);
+
+    int P = config.hilosAnalisis;
+    int U = config.hilosRegistro;
+    etapasActivas.store(1 + P + U);
+
+    hilosRegistro = new std::thread[U];
+    for (int u = 0; u < U; u++) {
+        hilosRegistro[u] = std::thread(&PipelineIngesta::bucleRegistro, this, u);
+    }
+    hilosAnalisis = new std::thread[P];
+    for (int p = 0; p < P; p++) {
+        hilosAnalisis[p] = std::thread(&PipelineIngesta::bucleAnalisis, this, p);
+    }
+    hiloLector = std::thread(&PipelineIngesta::bucleLector, this);
+    return true;
+}
+
+void PipelineIngesta::detener() {
+    detenerSolicitado.store(true);
+}
+
+bool PipelineIngesta::terminada() const {
+    return etapasActivas.load() == 0;
+}
+
+void PipelineIngesta::esperar() {
+    if (!enMarcha) {
+        return;
+    }
+    hiloLector.join();
+    for (int p = 0; p < config.hilosAnalisis; p++) {
+        hilosAnalisis[p].join();
+        stats.parseo.sumar(parseoPorHilo[p]);
+    }
+    for (int u = 0; u < config.hilosRegistro; u++) {
+        hilosRegistro[u].join();
+        stats.ingesta.sumar(ingestaPorHilo[u]);
+    }
+    delete[] hilosAnalisis;
+    delete[] hilosRegistro;
+    hilosAnalisis = nullptr;
+    hilosRegistro = nullptr;
+    enMarcha = false;
+}
+
+EstadisticasPipeline PipelineIngesta::estadisticas() const {
+    return stats;
+}
+
+PipelineIngesta::LoteLecturas* PipelineIngesta::tomarLote(int analizador) {
+    LoteLecturas* lote = nullptr;
+    int intentos = 0;
+    while (!lotesLibres[analizador]->desencolar(lote)) {
+        esperarTurno(intentos);
+    }
+    lote->cantidad = 0;
+    lote->finBloque = false;
+    return lote;
+}
+
+void PipelineIngesta::bucleLector() {
+    const size_t capacidad = static_cast<size_t>(config.tamBloque);
+    const int P = config.hilosAnalisis;
+    // Una línea partida puede ocupar hasta medio bloque; más larga se descarta
+    const size_t maxResto = capacidad / 2;
+    char* resto = new char[maxResto];
+    size_t tamResto = 0;
+    bool descartando = false;       // La línea actual excede maxResto y se ignora
+    unsigned long long enviados = 0;
+    BloqueDatos* bloque = nullptr;
+    bool finFuente = false;
+
+    while (!finFuente) {
+        if (bloque == nullptr) {
+            int intentos = 0;
+            while (!bloquesLibres->desencolar(bloque)) {
+                if (intentos == 0) stats.esperasLector++;
+                esperarTurno(intentos);
+            }
+        }
+
+        // El bloque empieza con el fragmento que quedó del anterior
+        memcpy(bloque->datos, resto, tamResto);
+        size_t lleno = tamResto;
+        tamResto = 0;
+
+        int n = 0;
+        while (n == 0) {
+            if (detenerSolicitado.load(std::memory_order_relaxed)) {
+                n = -1;
+                break;
+            }
+            n = fuente->leerBloque(bloque->datos + lleno, static_cast<int>(capacidad - lleno));
+        }
+        if (n < 0) {
+            finFuente = true;
+            // Guardar lo que hubiera para terminarlo con '\n' abajo
+            memcpy(resto, bloque->datos, lleno);
+            tamResto = lleno;
+            break;
+        }
+        stats.ingesta.bytes += n;
+        Metricas::sumar(Contador::BYTES_LEIDOS, n);
+        size_t inicio = 0;
+        size_t fin = lleno + static_cast<size_t>(n);
+
+        // Saltar la continuación de una línea demasiado larga
+        if (descartando) {
+            const void* salto = memchr(bloque->datos, '\n', fin);
+            if (salto == nullptr) {
+                continue;
+            }
+            inicio = static_cast<size_t>(static_cast<const char*>(salto) - bloque->datos) + 1;
+            stats.ingesta.lineasLargas++;
+            descartando = false;
+        }
+
+        // Cortar en el último '\n'; lo demás pasa al siguiente bloque
+        size_t corte = fin;
+        while (corte > inicio && bloque->datos[corte - 1] != '\n') {
+            corte--;
+        }
+        size_t sobrante = fin - corte;
+        if (sobrante > maxResto) {
+            descartando = true;
+        } else {
+            memcpy(resto, bloque->datos + corte, sobrante);
+            tamResto = sobrante;
+        }
+
+        if (corte > inicio) {
+            if (inicio > 0) {
+                memmove(bloque->datos, bloque->datos + inicio, corte - inicio);
+            }
+            bloque->longitud = corte - inicio;
+            bloque->tiempo = relojMs();
+            colasBloques[enviados % P]->encolar(bloque);
+            enviados++;
+            stats.bloques++;
+            bloque = nullptr;
+        }
+    }
+
+    // Última línea sin '\n'
+    if (descartando) {
+        stats.ingesta.lineasLargas++;
+    } else if (tamResto > 0) {
+        if (bloque == nullptr) {
+            int intentos = 0;
+            while (!bloquesLibres->desencolar(bloque)) {
+                esperarTurno(intentos);
+            }
+        }
+        memcpy(bloque->datos, resto, tamResto);
+        bloque->datos[tamResto] = '\n';
+        bloque->longitud = tamResto + 1;
+        bloque->tiempo = relojMs();
+        colasBloques[enviados % P]->encolar(bloque);
+        enviados++;
+        stats.bloques++;
+        bloque = nullptr;
+    }
+    if (bloque != nullptr) {
+        bloquesLibres->encolar(bloque);
+    }
+    delete[] resto;
+
+    // Un fin por analizador, continuando el turno para que el registrador
+    // encuentre el fin justo donde esperaba el siguiente bloque
+    for (int i = 0; i < P; i++) {
+        colasBloques[(enviados + i) % P]->encolar(nullptr);
+    }
+    etapasActivas.fetch_sub(1);
+}
+
+void PipelineIngesta::bucleAnalisis(int indice) {
+    const int U = config.hilosRegistro;
+    ParserLineas parser;
+    EstadisticasParseo publicadas = EstadisticasParseo();  // Ya sumado a Metricas
+    TablaNombres& tabla = TablaNombres::global();
+    ColaSPSC<LoteLecturas*>** salidas = colasLotes + indice * U;
+    LoteLecturas** actuales = new LoteLecturas*[U];
+    for (int u = 0; u < U; u++) {
+        actuales[u] = tomarLote(indice);
+    }
+
+    while (true) {
+        BloqueDatos* bloque = nullptr;
+        int intentos = 0;
+        while (!colasBloques[indice]->desencolar(bloque)) {
+            esperarTurno(intentos);
+        }
+        if (bloque == nullptr) {
+            break;
+        }
+        for (int u = 0; u < U; u++) {
+            actuales[u]->tiempo = bloque->tiempo;
+        }
+
+        parser.parsearBloque(bloque->datos, bloque->longitud, [&](const LecturaParseada& lectura) {
+            // Con el ID internado aquí, los registradores ya no tocan el texto
+            IdNombre id = tabla.internar(lectura.id.data(), static_cast<int>(lectura.id.size()));
+            if (id == TablaNombres::NINGUNO) return;    // Tabla de nombres llena
+            int destino = static_cast<int>(id % static_cast<unsigned int>(U));
+
+            LoteLecturas* lote = actuales[destino];
+            MensajeLectura& mensaje = lote->mensajes[lote->cantidad++];
+            mensaje.id = id;
+            mensaje.tipo = lectura.tipo;
+            mensaje.valorFloat = lectura.valorFloat;
+            mensaje.valorEntero = lectura.valorEntero;
+
+            if (lote->cantidad == CAPACIDAD_LOTE) {
+                salidas[destino]->encolar(lote);
+                actuales[destino] = tomarLote(indice);
+                actuales[destino]->tiempo = bloque->tiempo;
+            }
+        });
+        bloquesLibres->encolar(bloque);
+
+        const EstadisticasParseo& parseo = parser.estadisticas();
+        Metricas::sumar(Contador::LINEAS_LEIDAS, parseo.lineas - publicadas.lineas);
+        Metricas::sumar(Contador::LINEAS_VALIDAS, parseo.validas - publicadas.validas);
+        Metricas::sumar(Contador::LINEAS_RECHAZADAS, parseo.errores() - publicadas.errores());
+        publicadas = parseo;
+
+        // Cerrar el bloque con cada registrador (aunque el lote vaya vacío)
+        for (int u = 0; u < U; u++) {
+            actuales[u]->finBloque = true;
+            salidas[u]->encolar(actuales[u]);
+            actuales[u] = tomarLote(indice);
+        }
+    }
+
+    for (int u = 0; u < U; u++) {
+        salidas[u]->encolar(nullptr);
+        lotesLibres[indice]->encolar(actuales[u]);
+    }
+    delete[] actuales;
+    parseoPorHilo[indice] = parser.estadisticas();
+    etapasActivas.fetch_sub(1);
+}
+
+void PipelineIngesta::bucleRegistro(int indice) {
+    const int P = config.hilosAnalisis;
+    const int U = config.hilosRegistro;
+    CacheSensores cache;
+    EstadisticasIngesta& contadores = ingestaPorHilo[indice];
+    EstadisticasIngesta publicadas = EstadisticasIngesta();    // Ya sumado a Metricas
+    unsigned long long bloqueActual = 0;
+
+    while (true) {
+        // Los bloques se consumen en el orden de lectura: el k-ésimo viene del analizador k % P
+        ColaSPSC<LoteLecturas*>* entrada = colasLotes[(bloqueActual % P) * U + indice];
+        LoteLecturas* lote = nullptr;
+        int intentos = 0;
+        while (!entrada->desencolar(lote)) {
+            esperarTurno(intentos);
+        }
+        if (lote == nullptr) {
+            break;
+        }
+
+        for (int i = 0; i < lote->cantidad; i++) {
+            const MensajeLectura& mensaje = lote->mensajes[i];
+            bool medir = Metricas::muestrear();
+            long long t0 = medir ? relojNs() : 0;
+            SensorBase* sensor = cache.buscar(mensaje.id);
+            if (sensor == nullptr) {
+                std::lock_guard<std::mutex> candado(mutexLista);
+                sensor = lista.buscarPorId(mensaje.id);
+                if (sensor == nullptr) {
+                    sensor = MotorIngesta::crearSensor(mensaje.tipo, mensaje.id, config.retencion);
+                    lista.insertarSensor(sensor);
+                    contadores.sensoresCreados++;
+                }
+                cache.insertar(mensaje.id, sensor);
+            }
+            long long t1 = medir ? relojNs() : 0;
+
+            LecturaParseada lectura;
+            lectura.tipo = mensaje.tipo;
+            lectura.valorFloat = mensaje.valorFloat;
+            lectura.valorEntero = mensaje.valorEntero;
+            bool aplicada = MotorIngesta::aplicarLectura(sensor, lectura, lote->tiempo);
+            if (medir) {
+                Metricas::registrarLatencia(Operacion::BUSQUEDA, t1 - t0);
+                Metricas::registrarLatencia(Operacion::INSERCION, relojNs() - t1);
+            }
+            if (aplicada) {
+                contadores.lecturas++;
+                if (config.diario != nullptr) {
+                    config.diario->registrar(mensaje.tipo, mensaje.id, mensaje.valorFloat, mensaje.valorEntero,
+                                             lote->tiempo);
+                }
+            } else {
+                contadores.conflictosTipo++;
+                LOG_AVISO("[Ingesta] El sensor " << sensor->getNombre() << " no es de tipo " << mensaje.tipo << ".");
+            }
+        }
+
+        Metricas::sumar(Contador::LECTURAS_REGISTRADAS, contadores.lecturas - publicadas.lecturas);
+        Metricas::sumar(Contador::SENSORES_CREADOS, contadores.sensoresCreados - publicadas.sensoresCreados);
+        Metricas::sumar(Contador::CONFLICTOS_TIPO, contadores.conflictosTipo - publicadas.conflictosTipo);
+        publicadas = contadores;
+
+        bool finBloque = lote->finBloque;
+        lotesLibres[lote->analizador]->encolar(lote);
+        if (finBloque) {
+            bloqueActual++;
+        }
+    }
+    etapasActivas.fetch_sub(1);
+}
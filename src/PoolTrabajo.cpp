@@ -0,0 +1,168 @@
+/**
+ * @file PoolTrabajo.cpp
+ * @brief Implementación del grupo de hilos con robo de trabajo
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "PoolTrabajo.h"
+#include "Log.h"
+
+/**
+ * @brief Empaqueta un rango [inicio, fin) en un entero
+ */
+static inline unsigned long long empaquetar(unsigned int inicio, unsigned int fin) {
+    return (static_cast<unsigned long long>(inicio) << 32) | fin;
+}
+
+static inline unsigned int inicioDe(unsigned long long limites) {
+    return static_cast<unsigned int>(limites >> 32);
+}
+
+static inline unsigned int finDe(unsigned long long limites) {
+    return static_cast<unsigned int>(limites & 0xFFFFFFFFu);
+}
+
+PoolTrabajo::PoolTrabajo(int hilosTotales)
+    : numHilos(hilosTotales), hilos(nullptr), rangos(nullptr), generacion(0), terminar(false),
+      auxiliaresActivos(0), invocar(nullptr), contexto(nullptr), pendientes(0), robos(0) {
+    if (numHilos <= 0) {
+        numHilos = static_cast<int>(std::thread::hardware_concurrency());
+        if (numHilos <= 0) numHilos = 1;
+    }
+
+    rangos = new Rango[numHilos];
+    for (int i = 0; i < numHilos; i++) {
+        rangos[i].limites.store(0);
+    }
+
+    hilos = new std::thread[numHilos - 1];
+    for (int i = 1; i < numHilos; i++) {
+        hilos[i - 1] = std::thread(&PoolTrabajo::bucleAuxiliar, this, i);
+    }
+    LOG_DEPURACION("[PoolTrabajo] " << numHilos << " hilos.");
+}
+
+PoolTrabajo::~PoolTrabajo() {
+    {
+        std::lock_guard<std::mutex> candado(mutexTrabajo);
+        terminar = true;
+    }
+    avisoTrabajo.notify_all();
+    for (int i = 0; i < numHilos - 1; i++) {
+        hilos[i].join();
+    }
+    delete[] hilos;
+    delete[] rangos;
+}
+
+void PoolTrabajo::bucleAuxiliar(int indice) {
+    unsigned long long vista = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> candado(mutexTrabajo);
+            avisoTrabajo.wait(candado, [&] { return terminar || generacion != vista; });
+            if (terminar) return;
+            vista = generacion;
+        }
+
+        trabajar(indice);
+
+        std::lock_guard<std::mutex> candado(mutexTrabajo);
+        if (--auxiliaresActivos == 0) {
+            avisoFin.notify_one();
+        }
+    }
+}
+
+bool PoolTrabajo::tomar(int indice, int& tarea) {
+    std::atomic<unsigned long long>& limites = rangos[indice].limites;
+    unsigned long long actual = limites.load(std::memory_order_acquire);
+    while (inicioDe(actual) < finDe(actual)) {
+        unsigned long long nuevo = empaquetar(inicioDe(actual) + 1, finDe(actual));
+        if (limites.compare_exchange_weak(actual, nuevo, std::memory_order_acq_rel)) {
+            tarea = static_cast<int>(inicioDe(actual));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PoolTrabajo::robar(int indice) {
+    for (int k = 1; k < numHilos; k++) {
+        int victima = (indice + k) % numHilos;
+        std::atomic<unsigned long long>& limites = rangos[victima].limites;
+        unsigned long long actual = limites.load(std::memory_order_acquire);
+
+        while (true) {
+            unsigned int inicio = inicioDe(actual);
+            unsigned int fin = finDe(actual);
+            if (fin <= inicio) break;
+
+            // Con un solo índice se roba completo; si no, la mitad final
+            unsigned int medio = inicio + (fin - inicio) / 2;
+            if (limites.compare_exchange_weak(actual, empaquetar(inicio, medio), std::memory_order_acq_rel)) {
+                // Nadie escribe una parte vacía salvo su dueño
+                rangos[indice].limites.store(empaquetar(medio, fin), std::memory_order_release);
+                robos.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PoolTrabajo::trabajar(int indice) {
+    while (pendientes.load(std::memory_order_acquire) > 0) {
+        int tarea;
+        while (tomar(indice, tarea)) {
+            invocar(contexto, tarea);
+            pendientes.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        if (!robar(indice)) {
+            // Quedan tareas en curso en otros hilos pero nada que robar
+            std::this_thread::yield();
+        }
+    }
+}
+
+void PoolTrabajo::ejecutar(int n, void (*funcion)(void*, int), void* ctx) {
+    if (n <= 0) return;
+
+    invocar = funcion;
+    contexto = ctx;
+    pendientes.store(n, std::memory_order_relaxed);
+
+    // Partes contiguas del mismo tamaño (la última absorbe el residuo)
+    int hilosUsados = numHilos < n ? numHilos : n;
+    int porHilo = n / hilosUsados;
+    for (int i = 0; i < numHilos; i++) {
+        unsigned int inicio = 0, fin = 0;
+        if (i < hilosUsados) {
+            inicio = static_cast<unsigned int>(i * porHilo);
+            fin = (i == hilosUsados - 1) ? static_cast<unsigned int>(n) : inicio + porHilo;
+        }
+        rangos[i].limites.store(empaquetar(inicio, fin), std::memory_order_release);
+    }
+
+    if (numHilos > 1) {
+        std::lock_guard<std::mutex> candado(mutexTrabajo);
+        auxiliaresActivos = numHilos - 1;
+        generacion++;
+    }
+    avisoTrabajo.notify_all();
+
+    trabajar(0);
+
+    // Los auxiliares ya no leen invocar/contexto cuando auxiliaresActivos llega a 0
+    std::unique_lock<std::mutex> candado(mutexTrabajo);
+    avisoFin.wait(candado, [&] { return auxiliaresActivos == 0; });
+}
+
+int PoolTrabajo::getNumHilos() const {
+    return numHilos;
+}
+
+long long PoolTrabajo::getRobos() const {
+    return robos.load(std::memory_order_relaxed);
+}
@@ -6,20 +6,45 @@
  */
 
 #include "SensorBase.h"
+#include "Log.h"
 
-SensorBase::SensorBase() {
-    nombre[0] = '\0';
-}
+SensorBase::SensorBase() : SensorBase("", TipoSensor::OTRO) {}
+
+SensorBase::SensorBase(const char* nombre) : SensorBase(nombre, TipoSensor::OTRO) {}
 
-SensorBase::SensorBase(const char* nombre) {
-    strncpy(this->nombre, nombre, 49);
-    this->nombre[49] = '\0';
+SensorBase::SensorBase(const char* nombre, TipoSensor tipo) : tipo(tipo) {
+    // Los nombres de más de 49 caracteres se truncan al internarlos
+    TablaNombres& tabla = TablaNombres::global();
+    idNombre = tabla.internar(nombre, static_cast<int>(strlen(nombre)));
+    // Con la tabla llena el sensor queda sin id: no se indexa ni se anota en el diario
+    this->nombre = idNombre != TablaNombres::NINGUNO ? tabla.nombre(idNombre) : "";
 }
 
 SensorBase::~SensorBase() {
-    std::cout << "[Destructor SensorBase] Liberando sensor base." << std::endl;
+    LOG_DEPURACION("[Destructor SensorBase] Liberando sensor base.");
 }
 
 const char* SensorBase::getNombre() const {
     return nombre;
 }
+
+ResumenVentana SensorBase::resumirVentana(long long t0, long long t1) const {
+    return agregados.resumir(t0, t1);
+}
+
+const AgregadosTiempo& SensorBase::getAgregados() const {
+    return agregados;
+}
+
+void SensorBase::imprimirAgregados() const {
+    ResumenVentana hora = agregados.resumirUltimos(3600LL * 1000);
+    if (hora.cantidad == 0) return;
+    std::cout << "Última hora: " << hora.cantidad << " lecturas, promedio " << hora.promedio()
+              << ", mínimo " << hora.minimo << ", máximo " << hora.maximo << std::endl;
+}
+
+void SensorBase::imprimirArchivo(long long lecturas, long long bytes) const {
+    if (lecturas == 0) return;
+    std::cout << "Archivo comprimido: " << lecturas << " lecturas en " << bytes << " bytes ("
+              << static_cast<double>(bytes) / static_cast<double>(lecturas) << " bytes/lectura)" << std::endl;
+}
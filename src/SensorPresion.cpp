@@ -6,36 +6,70 @@
  */
 
 #include "SensorPresion.h"
+#include "Log.h"
 
-SensorPresion::SensorPresion(const char* nombre) : SensorBase(nombre) {
-    std::cout << "[Sensor Presion] Sensor '" << nombre << "' creado." << std::endl;
+SensorPresion::SensorPresion(const char* nombre) : SensorBase(nombre, TIPO) {
+    LOG_INFO("[Sensor Presion] Sensor '" << nombre << "' creado.");
 }
 
 SensorPresion::~SensorPresion() {
-    std::cout << "[Destructor Sensor " << nombre << "] Liberando Lista Interna..." << std::endl;
+    LOG_DEPURACION("[Destructor Sensor " << nombre << "] Liberando Lista Interna...");
     // El destructor de ListaSensor<int> se llama automáticamente
 }
 
 void SensorPresion::registrarLectura(int valor) {
-    historial.insertarAlFinal(valor);
+    registrarLectura(valor, relojMs());
+}
+
+void SensorPresion::registrarLectura(int valor, long long tiempo) {
+    historial.insertarAlFinal(valor, tiempo);
+    agregados.agregar(valor, tiempo);
 }
 
 void SensorPresion::procesarLectura() {
-    std::cout << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
+    LOG_INFO("\n-> Procesando Sensor " << nombre << "...");
     
     if (historial.estaVacia()) {
-        std::cout << "[Sensor Presion] No hay lecturas para procesar." << std::endl;
+        LOG_INFO("[Sensor Presion] No hay lecturas para procesar.");
         return;
     }
 
     // Calcular promedio
     int promedio = historial.calcularPromedio();
-    std::cout << "[Sensor Presion] Promedio de lecturas: " << promedio << std::endl;
-    std::cout << "[Sensor Presion] Total de lecturas: " << historial.getTamanio() << std::endl;
+    LOG_INFO("[Sensor Presion] Promedio de lecturas: " << promedio);
+    LOG_INFO("[Sensor Presion] Total de lecturas: " << historial.getTamanio());
 }
 
 void SensorPresion::imprimirInfo() const {
     std::cout << "\n[" << nombre << "] (Presion - INT)" << std::endl;
     std::cout << "Lecturas actuales (" << historial.getTamanio() << "): ";
     historial.imprimir();
+    imprimirAgregados();
+    const ArchivoComprimido<int>* archivo = historial.getArchivo();
+    if (archivo != nullptr) {
+        imprimirArchivo(archivo->getTamanio(), archivo->memoriaUsada());
+    }
+}
+
+void SensorPresion::configurarRetencion(const PoliticaRetencion& politica) {
+    historial.setRetencion(politica);
+}
+
+ResumenVentana SensorPresion::resumirVentana(long long t0, long long t1) const {
+    // Segundos completos, o un tramo que la retención ya descartó: agregados
+    if (AgregadosTiempo::alineada(t0, t1) || !historial.conservaDesde(t0)) {
+        return SensorBase::resumirVentana(t0, t1);
+    }
+    return historial.resumirRango(t0, t1);
+}
+
+void SensorPresion::restaurarLecturas(const int* valores, const long long* tiempos, int n, long long desplazamiento) {
+    historial.insertarVarias(valores, tiempos, n, desplazamiento);
+    for (int i = 0; i < n; i++) {
+        agregados.agregar(valores[i], tiempos[i] + desplazamiento);
+    }
+}
+
+const ListaSensor<int>& SensorPresion::getHistorial() const {
+    return historial;
 }
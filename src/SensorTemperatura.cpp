@@ -6,38 +6,44 @@
  */
 
 #include "SensorTemperatura.h"
+#include "Log.h"
 
-SensorTemperatura::SensorTemperatura(const char* nombre) : SensorBase(nombre) {
-    std::cout << "[Sensor Temperatura] Sensor '" << nombre << "' creado." << std::endl;
+SensorTemperatura::SensorTemperatura(const char* nombre) : SensorBase(nombre, TIPO) {
+    LOG_INFO("[Sensor Temperatura] Sensor '" << nombre << "' creado.");
 }
 
 SensorTemperatura::~SensorTemperatura() {
-    std::cout << "[Destructor Sensor " << nombre << "] Liberando Lista Interna..." << std::endl;
+    LOG_DEPURACION("[Destructor Sensor " << nombre << "] Liberando Lista Interna...");
     // El destructor de ListaSensor<float> se llama automáticamente
 }
 
 void SensorTemperatura::registrarLectura(float valor) {
-    historial.insertarAlFinal(valor);
+    registrarLectura(valor, relojMs());
+}
+
+void SensorTemperatura::registrarLectura(float valor, long long tiempo) {
+    historial.insertarAlFinal(valor, tiempo);
+    agregados.agregar(valor, tiempo);
 }
 
 void SensorTemperatura::procesarLectura() {
-    std::cout << "\n-> Procesando Sensor " << nombre << "..." << std::endl;
+    LOG_INFO("\n-> Procesando Sensor " << nombre << "...");
     
     if (historial.estaVacia()) {
-        std::cout << "[Sensor Temp] No hay lecturas para procesar." << std::endl;
+        LOG_INFO("[Sensor Temp] No hay lecturas para procesar.");
         return;
     }
 
     // Eliminar el valor más bajo
     float masBajo = historial.eliminarMasBajo();
-    std::cout << "[Sensor Temp] Lectura más baja (" << masBajo << ") eliminada." << std::endl;
+    LOG_INFO("[Sensor Temp] Lectura más baja (" << masBajo << ") eliminada.");
 
     // Calcular promedio de las lecturas restantes
     if (!historial.estaVacia()) {
         float promedio = historial.calcularPromedio();
-        std::cout << "[Sensor Temp] Promedio restante: " << promedio << std::endl;
+        LOG_INFO("[Sensor Temp] Promedio restante: " << promedio);
     } else {
-        std::cout << "[Sensor Temp] No quedan lecturas después de eliminar la más baja." << std::endl;
+        LOG_INFO("[Sensor Temp] No quedan lecturas después de eliminar la más baja.");
     }
 }
 
@@ -45,4 +51,32 @@ void SensorTemperatura::imprimirInfo() const {
     std::cout << "\n[" << nombre << "] (Temperatura - FLOAT)" << std::endl;
     std::cout << "Lecturas actuales (" << historial.getTamanio() << "): ";
     historial.imprimir();
+    imprimirAgregados();
+    const ArchivoComprimido<float>* archivo = historial.getArchivo();
+    if (archivo != nullptr) {
+        imprimirArchivo(archivo->getTamanio(), archivo->memoriaUsada());
+    }
+}
+
+void SensorTemperatura::configurarRetencion(const PoliticaRetencion& politica) {
+    historial.setRetencion(politica);
+}
+
+ResumenVentana SensorTemperatura::resumirVentana(long long t0, long long t1) const {
+    // Segundos completos, o un tramo que la retención ya descartó: agregados
+    if (AgregadosTiempo::alineada(t0, t1) || !historial.conservaDesde(t0)) {
+        return SensorBase::resumirVentana(t0, t1);
+    }
+    return historial.resumirRango(t0, t1);
+}
+
+void SensorTemperatura::restaurarLecturas(const float* valores, const long long* tiempos, int n, long long desplazamiento) {
+    historial.insertarVarias(valores, tiempos, n, desplazamiento);
+    for (int i = 0; i < n; i++) {
+        agregados.agregar(valores[i], tiempos[i] + desplazamiento);
+    }
+}
+
+const ListaSensor<float>& SensorTemperatura::getHistorial() const {
+    return historial;
 }
@@ -6,20 +6,71 @@
  */
 
 #include "SerialReader.h"
+#include "Log.h"
 #include <cstring>
 
-SerialReader::SerialReader() {
+#ifdef POSIX_SERIAL
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * @brief Traduce una velocidad numérica a la constante de termios
+ * @param baudios Velocidad en baudios
+ * @return Constante speed_t o B0 si no está soportada
+ */
+static speed_t velocidadTermios(int baudios) {
+    switch (baudios) {
+        case 1200: return B1200;
+        case 2400: return B2400;
+        case 4800: return B4800;
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+        default: return B0;
+    }
+}
+#endif
+
+SerialReader::SerialReader()
+    : conectado(false), finDeDatos(false), anillo(nullptr), capacidad(CAPACIDAD_BUFFER),
+      posLectura(0), posEscritura(0), vmin(1), vtime(1), bytesLeidos(0), llamadasLectura(0) {
 #ifdef WINDOWS_SERIAL
     hSerial = INVALID_HANDLE_VALUE;
-    conectado = false;
+#elif defined(POSIX_SERIAL)
+    fd = -1;
+    esTerminal = false;
 #endif
+    anillo = new char[capacidad];
 }
 
 SerialReader::~SerialReader() {
     desconectar();
+    delete[] anillo;
+}
+
+void SerialReader::configurarTiempos(int bytesMinimos, int decimasEspera) {
+    vmin = bytesMinimos;
+    vtime = decimasEspera;
 }
 
-bool SerialReader::conectar(const char* puerto) {
+bool SerialReader::conectar(const char* puerto, int baudios) {
+    desconectar();
+    posLectura = 0;
+    posEscritura = 0;
+    finDeDatos = false;
+
 #ifdef WINDOWS_SERIAL
     // Abrir el puerto serial
     hSerial = CreateFileA(puerto,
@@ -31,7 +82,7 @@ bool SerialReader::conectar(const char* puerto) {
                           NULL);
 
     if (hSerial == INVALID_HANDLE_VALUE) {
-        std::cerr << "[Serial] Error al abrir puerto " << puerto << std::endl;
+        LOG_ERROR("[Serial] Error al abrir puerto " << puerto);
         return false;
     }
 
@@ -40,88 +91,309 @@ bool SerialReader::conectar(const char* puerto) {
     dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
 
     if (!GetCommState(hSerial, &dcbSerialParams)) {
-        std::cerr << "[Serial] Error al obtener estado del puerto." << std::endl;
+        LOG_ERROR("[Serial] Error al obtener estado del puerto.");
         CloseHandle(hSerial);
         return false;
     }
 
-    dcbSerialParams.BaudRate = CBR_9600;
+    dcbSerialParams.BaudRate = static_cast<DWORD>(baudios);
     dcbSerialParams.ByteSize = 8;
     dcbSerialParams.StopBits = ONESTOPBIT;
     dcbSerialParams.Parity = NOPARITY;
 
     if (!SetCommState(hSerial, &dcbSerialParams)) {
-        std::cerr << "[Serial] Error al configurar puerto." << std::endl;
+        LOG_ERROR("[Serial] Error al configurar puerto.");
         CloseHandle(hSerial);
         return false;
     }
 
-    // Configurar timeouts
+    // Configurar timeouts: cada ReadFile en bloque regresa a lo más en 50 ms
+    // con lo que haya llegado (sin multiplicador por byte solicitado)
     COMMTIMEOUTS timeouts = {0};
     timeouts.ReadIntervalTimeout = 50;
     timeouts.ReadTotalTimeoutConstant = 50;
-    timeouts.ReadTotalTimeoutMultiplier = 10;
+    timeouts.ReadTotalTimeoutMultiplier = 0;
 
     if (!SetCommTimeouts(hSerial, &timeouts)) {
-        std::cerr << "[Serial] Error al configurar timeouts." << std::endl;
+        LOG_ERROR("[Serial] Error al configurar timeouts.");
         CloseHandle(hSerial);
         return false;
     }
 
     conectado = true;
-    std::cout << "[Serial] Conectado exitosamente a " << puerto << std::endl;
+    LOG_INFO("[Serial] Conectado exitosamente a " << puerto);
+    return true;
+#elif defined(POSIX_SERIAL)
+    // Los FIFO y archivos se abren sólo en lectura para detectar el fin de datos
+    struct stat info;
+    int modo = O_RDWR;
+    if (stat(puerto, &info) == 0 && (S_ISFIFO(info.st_mode) || S_ISREG(info.st_mode))) {
+        modo = O_RDONLY;
+    }
+
+    if (strcmp(puerto, "-") == 0) {
+        fd = dup(STDIN_FILENO);
+    } else {
+        fd = open(puerto, modo | O_NOCTTY);
+    }
+    if (fd < 0) {
+        LOG_ERROR("[Serial] Error al abrir puerto " << puerto << ": " << strerror(errno));
+        return false;
+    }
+
+    esTerminal = isatty(fd) == 1;
+    if (esTerminal) {
+        speed_t velocidad = velocidadTermios(baudios);
+        if (velocidad == B0) {
+            LOG_ERROR("[Serial] Velocidad no soportada: " << baudios);
+            close(fd);
+            fd = -1;
+            return false;
+        }
+
+        struct termios opciones;
+        if (tcgetattr(fd, &opciones) != 0) {
+            LOG_ERROR("[Serial] Error al obtener estado del puerto.");
+            close(fd);
+            fd = -1;
+            return false;
+        }
+
+        // Modo crudo 8N1: sin eco, sin procesamiento de líneas ni de control de flujo
+        cfmakeraw(&opciones);
+        opciones.c_cflag |= (CLOCAL | CREAD);
+        opciones.c_cflag &= ~(CSTOPB | PARENB);
+        cfsetispeed(&opciones, velocidad);
+        cfsetospeed(&opciones, velocidad);
+        opciones.c_cc[VMIN] = static_cast<cc_t>(vmin);
+        opciones.c_cc[VTIME] = static_cast<cc_t>(vtime);
+
+        if (tcsetattr(fd, TCSANOW, &opciones) != 0) {
+            LOG_ERROR("[Serial] Error al configurar puerto.");
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        tcflush(fd, TCIFLUSH);
+    } else {
+        LOG_DEPURACION("[Serial] " << puerto << " no es una terminal; se lee como flujo.");
+    }
+
+    conectado = true;
+    LOG_INFO("[Serial] Conectado exitosamente a " << puerto);
     return true;
 #else
-    std::cout << "[Serial] Modo simulación - puerto serial no disponible en esta plataforma." << std::endl;
+    (void)puerto;
+    (void)baudios;
+    LOG_AVISO("[Serial] Modo simulación - puerto serial no disponible en esta plataforma.");
     return false;
 #endif
 }
 
-bool SerialReader::leerLinea(char* buffer, int maxSize) {
+int SerialReader::leerDispositivo(char* destino, int maxBytes) {
+    if (!conectado || finDeDatos) return -1;
+    llamadasLectura++;
+
 #ifdef WINDOWS_SERIAL
-    if (!conectado) return false;
+    DWORD bytesRead = 0;
+    if (!ReadFile(hSerial, destino, static_cast<DWORD>(maxBytes), &bytesRead, NULL)) {
+        finDeDatos = true;
+        return -1;
+    }
+    return static_cast<int>(bytesRead);   // 0 = venció el timeout
+#elif defined(POSIX_SERIAL)
+    ssize_t n = read(fd, destino, static_cast<size_t>(maxBytes));
+    if (n > 0) {
+        return static_cast<int>(n);
+    }
+    if (n == 0) {
+        // En una terminal 0 significa que venció VTIME; en otro caso es fin de archivo
+        if (esTerminal) return 0;
+        finDeDatos = true;
+        return -1;
+    }
+    if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+    }
+    finDeDatos = true;   // EIO: el otro extremo del pty se cerró
+    return -1;
+#else
+    (void)destino;
+    (void)maxBytes;
+    return -1;
+#endif
+}
 
-    DWORD bytesRead;
-    char c;
-    int i = 0;
+unsigned int SerialReader::pendientes() const {
+    return static_cast<unsigned int>(posEscritura - posLectura);
+}
 
-    while (i < maxSize - 1) {
-        if (!ReadFile(hSerial, &c, 1, &bytesRead, NULL)) {
-            return false;
+int SerialReader::rellenar() {
+    unsigned int libre = capacidad - pendientes();
+    if (libre == 0) return 0;
+
+    unsigned int pos = static_cast<unsigned int>(posEscritura & (capacidad - 1));
+    unsigned int contiguo = capacidad - pos;
+    if (contiguo > libre) contiguo = libre;
+
+    int n = leerDispositivo(anillo + pos, static_cast<int>(contiguo));
+    if (n > 0) {
+        posEscritura += static_cast<unsigned int>(n);
+        bytesLeidos += n;
+    }
+    return n;
+}
+
+bool SerialReader::leerLinea(char* buffer, int maxSize) {
+    if (maxSize <= 1) return false;
+    unsigned int maxLinea = static_cast<unsigned int>(maxSize - 1);
+    unsigned int revisados = 0;     // Bytes ya examinados sin encontrar '\n'
+
+    while (true) {
+        unsigned int n = pendientes();
+        unsigned int mascara = capacidad - 1;
+
+        // Buscar '\n' en los bytes nuevos (hasta dos segmentos contiguos del anillo)
+        int finLinea = -1;
+        while (revisados < n && revisados <= maxLinea) {
+            unsigned int pos = static_cast<unsigned int>((posLectura + revisados) & mascara);
+            unsigned int tramo = capacidad - pos;
+            if (tramo > n - revisados) tramo = n - revisados;
+            const void* hallado = memchr(anillo + pos, '\n', tramo);
+            if (hallado != nullptr) {
+                finLinea = static_cast<int>(revisados + (static_cast<const char*>(hallado) - (anillo + pos)));
+                break;
+            }
+            revisados += tramo;
         }
 
-        if (bytesRead == 1) {
-            if (c == '\n') {
-                buffer[i] = '\0';
-                return true;
+        unsigned int copiar = 0;
+        unsigned int consumir = 0;
+        if (finLinea >= 0 && static_cast<unsigned int>(finLinea) <= maxLinea) {
+            copiar = static_cast<unsigned int>(finLinea);
+            consumir = copiar + 1;
+        } else if (n >= maxLinea || n == capacidad) {
+            // Línea demasiado larga (o más que el búfer): se entrega truncada
+            copiar = n < maxLinea ? n : maxLinea;
+            consumir = copiar;
+        } else {
+            int r = rellenar();
+            if (r > 0) {
+                continue;
             }
-            if (c != '\r') {
-                buffer[i++] = c;
+            if (r == 0) {
+                return false;       // Venció la espera: lo recibido queda en el búfer
             }
+            if (n == 0) {
+                return false;
+            }
+            copiar = n;             // Última línea sin '\n' al final de los datos
+            consumir = n;
+        }
+
+        for (unsigned int i = 0; i < copiar; i++) {
+            buffer[i] = anillo[(posLectura + i) & mascara];
         }
+        posLectura += consumir;
+        if (copiar > 0 && buffer[copiar - 1] == '\r') {
+            copiar--;
+        }
+        buffer[copiar] = '\0';
+        return true;
+    }
+}
+
+int SerialReader::leerBloque(char* destino, int maxBytes) {
+    unsigned int n = pendientes();
+    if (n == 0) {
+        int r = leerDispositivo(destino, maxBytes);
+        if (r > 0) bytesLeidos += r;
+        return r;
+    }
+
+    unsigned int copiar = n < static_cast<unsigned int>(maxBytes) ? n : static_cast<unsigned int>(maxBytes);
+    unsigned int mascara = capacidad - 1;
+    for (unsigned int i = 0; i < copiar; i++) {
+        destino[i] = anillo[(posLectura + i) & mascara];
     }
+    posLectura += copiar;
+    return static_cast<int>(copiar);
+}
+
+bool SerialReader::escribir(const char* datos, int longitud) {
+    if (!conectado) return false;
 
-    buffer[i] = '\0';
+#ifdef WINDOWS_SERIAL
+    DWORD escritos = 0;
+    return WriteFile(hSerial, datos, static_cast<DWORD>(longitud), &escritos, NULL) &&
+           escritos == static_cast<DWORD>(longitud);
+#elif defined(POSIX_SERIAL)
+    // Archivos, FIFO y stdin se abren sólo en lectura: no hay a quién enviar
+    if (!esTerminal) return false;
+    while (longitud > 0) {
+        ssize_t n = write(fd, datos, static_cast<size_t>(longitud));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += n;
+        longitud -= static_cast<int>(n);
+    }
     return true;
 #else
+    (void)datos;
+    (void)longitud;
     return false;
 #endif
 }
 
-bool SerialReader::estaConectado() const {
-#ifdef WINDOWS_SERIAL
-    return conectado;
+bool SerialReader::setNoBloqueante() {
+    if (!conectado) return false;
+#ifdef POSIX_SERIAL
+    int banderas = fcntl(fd, F_GETFL);
+    if (banderas < 0 || fcntl(fd, F_SETFL, banderas | O_NONBLOCK) != 0) {
+        LOG_ERROR("[Serial] No se pudo poner el puerto en modo no bloqueante: " << strerror(errno));
+        return false;
+    }
+    return true;
 #else
     return false;
 #endif
 }
 
+int SerialReader::getDescriptor() const {
+#ifdef POSIX_SERIAL
+    return conectado ? fd : -1;
+#else
+    return -1;
+#endif
+}
+
+bool SerialReader::estaConectado() const {
+    return conectado;
+}
+
+bool SerialReader::hayMasDatos() const {
+    return pendientes() > 0 || (conectado && !finDeDatos);
+}
+
+long long SerialReader::getBytesLeidos() const {
+    return bytesLeidos;
+}
+
+long long SerialReader::getLlamadasLectura() const {
+    return llamadasLectura;
+}
+
 void SerialReader::desconectar() {
+    if (!conectado) return;
 #ifdef WINDOWS_SERIAL
-    if (conectado) {
-        CloseHandle(hSerial);
-        conectado = false;
-        std::cout << "[Serial] Conexión cerrada." << std::endl;
-    }
+    CloseHandle(hSerial);
+    hSerial = INVALID_HANDLE_VALUE;
+#elif defined(POSIX_SERIAL)
+    close(fd);
+    fd = -1;
 #endif
+    conectado = false;
+    LOG_INFO("[Serial] Conexión cerrada.");
 }
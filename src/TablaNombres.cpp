@@ -0,0 +1,156 @@
+/**
+ * @file TablaNombres.cpp
+ * @brief Implementación del internado de nombres de sensores
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "TablaNombres.h"
+#include "Log.h"
+#include <cstring>
+
+/// Casillas del primer índice (potencia de 2)
+static const unsigned int CAPACIDAD_INICIAL = 64;
+
+TablaNombres& TablaNombres::global() {
+    static TablaNombres tabla;
+    return tabla;
+}
+
+unsigned int TablaNombres::hashNombre(const char* nombre, int longitud) {
+    unsigned int hash = 2166136261u;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(nombre);
+    for (int i = 0; i < longitud; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+TablaNombres::TablaNombres() : indice(nullptr), segmentos(nullptr), numNombres(0), llenaAvisada(false) {
+    Indice* inicial = new Indice;
+    inicial->casillas = new std::atomic<unsigned long long>[CAPACIDAD_INICIAL];
+    for (unsigned int i = 0; i < CAPACIDAD_INICIAL; i++) {
+        inicial->casillas[i].store(0, std::memory_order_relaxed);
+    }
+    inicial->capacidad = CAPACIDAD_INICIAL;
+    inicial->anterior = nullptr;
+    indice.store(inicial, std::memory_order_release);
+
+    segmentos = new std::atomic<Entrada*>[MAX_SEGMENTOS];
+    for (int i = 0; i < MAX_SEGMENTOS; i++) {
+        segmentos[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+TablaNombres::~TablaNombres() {
+    Indice* actual = indice.load(std::memory_order_acquire);
+    while (actual != nullptr) {
+        Indice* anterior = actual->anterior;
+        delete[] actual->casillas;
+        delete actual;
+        actual = anterior;
+    }
+    for (int i = 0; i < MAX_SEGMENTOS; i++) {
+        delete[] segmentos[i].load(std::memory_order_relaxed);
+    }
+    delete[] segmentos;
+}
+
+const TablaNombres::Entrada& TablaNombres::entrada(IdNombre id) const {
+    Entrada* segmento = segmentos[id >> BITS_SEGMENTO].load(std::memory_order_acquire);
+    return segmento[id & ((1u << BITS_SEGMENTO) - 1)];
+}
+
+IdNombre TablaNombres::buscar(const char* nombre, int longitud) const {
+    if (longitud > LONGITUD_MAXIMA) return NINGUNO;
+    unsigned int hash = hashNombre(nombre, longitud);
+    const Indice* actual = indice.load(std::memory_order_acquire);
+    unsigned int mascara = actual->capacidad - 1;
+
+    // Sondeo lineal: el índice nunca se llena, siempre hay una casilla libre
+    for (unsigned int pos = hash & mascara;; pos = (pos + 1) & mascara) {
+        unsigned long long casilla = actual->casillas[pos].load(std::memory_order_acquire);
+        if (casilla == 0) return NINGUNO;
+        if (static_cast<unsigned int>(casilla >> 32) == hash) {
+            IdNombre id = static_cast<IdNombre>(casilla & 0xFFFFFFFFu) - 1;
+            const Entrada& e = entrada(id);
+            if (e.longitud == longitud && memcmp(e.texto, nombre, longitud) == 0) {
+                return id;
+            }
+        }
+    }
+}
+
+void TablaNombres::colocar(Indice* destino, unsigned int hash, IdNombre id) {
+    unsigned int mascara = destino->capacidad - 1;
+    unsigned int pos = hash & mascara;
+    while (destino->casillas[pos].load(std::memory_order_relaxed) != 0) {
+        pos = (pos + 1) & mascara;
+    }
+    unsigned long long casilla = (static_cast<unsigned long long>(hash) << 32) | (static_cast<unsigned long long>(id) + 1);
+    destino->casillas[pos].store(casilla, std::memory_order_release);
+}
+
+IdNombre TablaNombres::internar(const char* nombre, int longitud) {
+    if (longitud > LONGITUD_MAXIMA) longitud = LONGITUD_MAXIMA;
+    IdNombre id = buscar(nombre, longitud);
+    if (id != NINGUNO) return id;
+
+    std::lock_guard<std::mutex> candado(mutex);
+    id = buscar(nombre, longitud);     // Otro hilo pudo agregarlo mientras se esperaba
+    if (id != NINGUNO) return id;
+
+    id = numNombres.load(std::memory_order_relaxed);
+    unsigned int numSegmento = id >> BITS_SEGMENTO;
+    if (numSegmento >= static_cast<unsigned int>(MAX_SEGMENTOS)) {
+        if (!llenaAvisada) {
+            LOG_ERROR("[TablaNombres] No caben más de " << id << " nombres; los nuevos se rechazan.");
+            llenaAvisada = true;
+        }
+        return NINGUNO;
+    }
+    Entrada* segmento = segmentos[numSegmento].load(std::memory_order_relaxed);
+    if (segmento == nullptr) {
+        segmento = new Entrada[1u << BITS_SEGMENTO];
+        segmentos[numSegmento].store(segmento, std::memory_order_release);
+    }
+    Entrada& e = segmento[id & ((1u << BITS_SEGMENTO) - 1)];
+    memcpy(e.texto, nombre, longitud);
+    e.texto[longitud] = '\0';
+    e.longitud = static_cast<unsigned char>(longitud);
+
+    // Factor de carga <= 1/2: al crecer se publica un índice nuevo completo
+    Indice* actual = indice.load(std::memory_order_relaxed);
+    if ((id + 1) * 2 > actual->capacidad) {
+        Indice* nuevo = new Indice;
+        nuevo->capacidad = actual->capacidad * 2;
+        nuevo->casillas = new std::atomic<unsigned long long>[nuevo->capacidad];
+        for (unsigned int i = 0; i < nuevo->capacidad; i++) {
+            nuevo->casillas[i].store(0, std::memory_order_relaxed);
+        }
+        nuevo->anterior = actual;
+        for (IdNombre k = 0; k < id; k++) {
+            const Entrada& otra = entrada(k);
+            colocar(nuevo, hashNombre(otra.texto, otra.longitud), k);
+        }
+        colocar(nuevo, hashNombre(nombre, longitud), id);
+        indice.store(nuevo, std::memory_order_release);
+    } else {
+        colocar(actual, hashNombre(nombre, longitud), id);
+    }
+    numNombres.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+const char* TablaNombres::nombre(IdNombre id) const {
+    return entrada(id).texto;
+}
+
+int TablaNombres::longitud(IdNombre id) const {
+    return entrada(id).longitud;
+}
+
+unsigned int TablaNombres::cantidad() const {
+    return numNombres.load(std::memory_order_acquire);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file TramaBinaria.cpp
+ * @brief Implementación del protocolo binario de tramas fijas
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ */
+
+#include "TramaBinaria.h"
+
+/**
+ * @brief Tabla del CRC-16/CCITT-FALSE, un byte por paso
+ */
+static const struct TablaCrc16 {
+    unsigned short v[256];
+    TablaCrc16() {
+        for (int i = 0; i < 256; i++) {
+            unsigned short c = static_cast<unsigned short>(i << 8);
+            for (int k = 0; k < 8; k++) {
+                c = static_cast<unsigned short>((c & 0x8000) ? (c << 1) ^ 0x1021 : c << 1);
+            }
+            v[i] = c;
+        }
+    }
+} tablaCrc16;
+
+unsigned short TramaBinaria::crc16(const unsigned char* datos, int longitud) {
+    unsigned short crc = 0xFFFF;
+    for (int i = 0; i < longitud; i++) {
+        crc = static_cast<unsigned short>((crc << 8) ^ tablaCrc16.v[((crc >> 8) ^ datos[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+void TramaBinaria::codificar(char tipo, int canal, int valor, unsigned char secuencia, unsigned char* destino) {
+    if (valor > 32767) valor = 32767;
+    if (valor < -32768) valor = -32768;
+    unsigned short bits = static_cast<unsigned short>(static_cast<short>(valor));
+
+    destino[0] = SINCRONIA;
+    destino[1] = static_cast<unsigned char>((tipo == 'P' ? 0x80 : 0x00) | (canal & CANAL_MAXIMO));
+    destino[2] = static_cast<unsigned char>(bits & 0xFF);
+    destino[3] = static_cast<unsigned char>(bits >> 8);
+    destino[4] = secuencia;
+    unsigned short crc = crc16(destino + 1, 4);
+    destino[5] = static_cast<unsigned char>(crc & 0xFF);
+    destino[6] = static_cast<unsigned char>(crc >> 8);
+}
+
+ResultadoTrama TramaBinaria::decodificar(const unsigned char* datos, TramaDecodificada& salida) {
+    if (datos[0] != SINCRONIA) return ResultadoTrama::ERROR_SINCRONIA;
+    unsigned short crc = static_cast<unsigned short>(datos[5] | (datos[6] << 8));
+    if (crc16(datos + 1, 4) != crc) return ResultadoTrama::ERROR_CRC;
+
+    int canal = datos[1] & CANAL_MAXIMO;
+    int valor = static_cast<short>(static_cast<unsigned short>(datos[2] | (datos[3] << 8)));
+    char tipo = (datos[1] & 0x80) ? 'P' : 'T';
+
+    salida.nombre[0] = tipo;
+    salida.nombre[1] = '-';
+    salida.nombre[2] = static_cast<char>('0' + canal / 100);
+    salida.nombre[3] = static_cast<char>('0' + canal / 10 % 10);
+    salida.nombre[4] = static_cast<char>('0' + canal % 10);
+    salida.lectura.tipo = tipo;
+    salida.lectura.id = std::string_view(salida.nombre, 5);
+    salida.lectura.valorFloat = tipo == 'T' ? static_cast<float>(valor) / 10.0f : 0.0f;
+    salida.lectura.valorEntero = tipo == 'P' ? valor : 0;
+    salida.secuencia = datos[4];
+    return ResultadoTrama::VALIDA;
+}
@@ -11,9 +11,19 @@
 #include "SensorTemperatura.h"
 #include "SensorPresion.h"
 #include "SerialReader.h"
+#include "Log.h"
+#include "MotorIngesta.h"
+#include "ModoLote.h"
+#include "Instantanea.h"
+#include "DiarioLecturas.h"
+#include <cstdio>
+#include <cstdlib>
 
 using namespace std;
 
+/// Diario de lecturas de la sesión interactiva (IOT_DIARIO) o nullptr
+static DiarioLecturas* diario = nullptr;
+
 /**
  * @brief Muestra el menú principal del sistema
  */
@@ -42,6 +52,9 @@ void crearSensorTemperatura(ListaGeneral& lista) {
     
     SensorTemperatura* sensor = new SensorTemperatura(nombre);
     lista.insertarSensor(sensor);
+    if (diario != nullptr) {
+        diario->registrarSensor('T', nombre);
+    }
 }
 
 /**
@@ -55,6 +68,9 @@ void crearSensorPresion(ListaGeneral& lista) {
     
     SensorPresion* sensor = new SensorPresion(nombre);
     lista.insertarSensor(sensor);
+    if (diario != nullptr) {
+        diario->registrarSensor('P', nombre);
+    }
 }
 
 /**
@@ -81,9 +97,13 @@ void registrarLecturaManual(ListaGeneral& lista) {
         cout << "Valor (float): ";
         cin >> valor;
         
-        SensorTemperatura* sensorTemp = dynamic_cast<SensorTemperatura*>(sensor);
+        SensorTemperatura* sensorTemp = sensorComo<SensorTemperatura>(sensor);
         if (sensorTemp) {
-            sensorTemp->registrarLectura(valor);
+            long long tiempo = relojMs();
+            sensorTemp->registrarLectura(valor, tiempo);
+            if (diario != nullptr) {
+                diario->registrar('T', sensor->getIdNombre(), valor, 0, tiempo);
+            }
             cout << "Lectura registrada en " << nombre << endl;
         } else {
             cout << "Error: El sensor no es de tipo Temperatura." << endl;
@@ -93,9 +113,13 @@ void registrarLecturaManual(ListaGeneral& lista) {
         cout << "Valor (int): ";
         cin >> valor;
         
-        SensorPresion* sensorPres = dynamic_cast<SensorPresion*>(sensor);
+        SensorPresion* sensorPres = sensorComo<SensorPresion>(sensor);
         if (sensorPres) {
-            sensorPres->registrarLectura(valor);
+            long long tiempo = relojMs();
+            sensorPres->registrarLectura(valor, tiempo);
+            if (diario != nullptr) {
+                diario->registrar('P', sensor->getIdNombre(), 0.0f, valor, tiempo);
+            }
             cout << "Lectura registrada en " << nombre << endl;
         } else {
             cout << "Error: El sensor no es de tipo Presión." << endl;
@@ -108,8 +132,8 @@ void registrarLecturaManual(ListaGeneral& lista) {
  * @param lista Lista general de sensores
  */
 void leerDesdeSerial(ListaGeneral& lista) {
-    char puerto[10];
-    cout << "\nPuerto COM (ej: COM3): ";
+    char puerto[64];
+    cout << "\nPuerto serial (ej: COM3 o /dev/ttyUSB0): ";
     cin >> puerto;
     
     SerialReader serial;
@@ -119,15 +143,34 @@ void leerDesdeSerial(ListaGeneral& lista) {
         
         // Datos de simulación
         cout << "\n[Simulación] Creando sensores de prueba..." << endl;
+        const float temperaturas[] = { 45.3f, 42.1f };
+        const int presiones[] = { 80, 85 };
+
         SensorTemperatura* t1 = new SensorTemperatura("T-001");
-        t1->registrarLectura(45.3f);
-        t1->registrarLectura(42.1f);
         lista.insertarSensor(t1);
+        if (diario != nullptr) {
+            diario->registrarSensor('T', "T-001");
+        }
+        for (float valor : temperaturas) {
+            long long tiempo = relojMs();
+            t1->registrarLectura(valor, tiempo);
+            if (diario != nullptr) {
+                diario->registrar('T', t1->getIdNombre(), valor, 0, tiempo);
+            }
+        }
         
         SensorPresion* p1 = new SensorPresion("P-105");
-        p1->registrarLectura(80);
-        p1->registrarLectura(85);
         lista.insertarSensor(p1);
+        if (diario != nullptr) {
+            diario->registrarSensor('P', "P-105");
+        }
+        for (int valor : presiones) {
+            long long tiempo = relojMs();
+            p1->registrarLectura(valor, tiempo);
+            if (diario != nullptr) {
+                diario->registrar('P', p1->getIdNombre(), 0.0f, valor, tiempo);
+            }
+        }
         
         return;
     }
@@ -137,51 +180,81 @@ void leerDesdeSerial(ListaGeneral& lista) {
     
     char buffer[100];
     int lecturas = 0;
+    MotorIngesta motor(lista);
+    motor.setDiario(diario);
     
-    while (lecturas < 10 && serial.leerLinea(buffer, 100)) {
+    while (lecturas < 10) {
+        if (!serial.leerLinea(buffer, 100)) {
+            if (!serial.hayMasDatos()) break;
+            continue;   // Venció la espera: la línea se completa en la siguiente lectura
+        }
+
+        // Marca de llegada, antes de analizar
+        long long tiempo = relojMs();
+
         // Parsear: TIPO,ID,VALOR
-        char* tipo = strtok(buffer, ",");
-        char* id = strtok(nullptr, ",");
-        char* valor = strtok(nullptr, ",");
-        
-        if (tipo && id && valor) {
-            SensorBase* sensor = lista.buscarSensor(id);
-            
-            if (tipo[0] == 'T' || tipo[0] == 't') {
-                if (!sensor) {
-                    sensor = new SensorTemperatura(id);
-                    lista.insertarSensor(sensor);
-                }
-                SensorTemperatura* sensorTemp = dynamic_cast<SensorTemperatura*>(sensor);
-                if (sensorTemp) {
-                    sensorTemp->registrarLectura(atof(valor));
-                    cout << "[Arduino] " << id << ": " << valor << "°C" << endl;
-                    lecturas++;
-                }
-            } else if (tipo[0] == 'P' || tipo[0] == 'p') {
-                if (!sensor) {
-                    sensor = new SensorPresion(id);
-                    lista.insertarSensor(sensor);
-                }
-                SensorPresion* sensorPres = dynamic_cast<SensorPresion*>(sensor);
-                if (sensorPres) {
-                    sensorPres->registrarLectura(atoi(valor));
-                    cout << "[Arduino] " << id << ": " << valor << " Pa" << endl;
-                    lecturas++;
-                }
+        LecturaParseada lectura;
+        ResultadoParseo resultado = motor.getParser().parsearLinea(buffer, lectura);
+        if (resultado != ResultadoParseo::VALIDA) {
+            if (resultado != ResultadoParseo::VACIA && resultado != ResultadoParseo::COMENTARIO) {
+                LOG_AVISO("[Arduino] Línea descartada (" << ParserLineas::describir(resultado) << "): " << buffer);
             }
+            continue;
+        }
+
+        SensorBase* sensor = motor.registrar(lectura, tiempo);
+        if (sensor != nullptr) {
+            if (lectura.tipo == 'T') {
+                LOG_INFO("[Arduino] " << sensor->getNombre() << ": " << lectura.valorFloat << "°C");
+            } else {
+                LOG_INFO("[Arduino] " << sensor->getNombre() << ": " << lectura.valorEntero << " Pa");
+            }
+            lecturas++;
         }
     }
     
     cout << "\nTotal de lecturas capturadas: " << lecturas << endl;
+    cout << "Líneas rechazadas: " << motor.estadisticasParseo().errores() << endl;
 }
 
 /**
  * @brief Función principal
+ * @param argc Número de argumentos
+ * @param argv Argumentos; si hay alguno se ejecuta el modo por lotes
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // Bitácora asíncrona: el nivel se toma de IOT_LOG_NIVEL (info por defecto)
+    Log::configurarDesdeEntorno();
+    Log::iniciarAsincrono();
+
+    if (argc > 1) {
+        OpcionesLote opciones;
+        if (!analizarArgumentosLote(argc, argv, opciones)) {
+            mostrarUsoLote(argv[0]);
+            return 1;
+        }
+        return ejecutarModoLote(opciones);
+    }
+
     ListaGeneral sistema;
     int opcion;
+
+    // Con IOT_INSTANTANEA los sensores sobreviven al cierre del programa
+    const char* instantanea = std::getenv("IOT_INSTANTANEA");
+    if (instantanea != nullptr && instantanea[0] != '\0') {
+        Instantanea::cargar(sistema, instantanea);
+    }
+
+    // Con IOT_DIARIO cada lectura aceptada se anota y se recupera tras una caída
+    const char* rutaDiario = std::getenv("IOT_DIARIO");
+    DiarioLecturas diarioSesion;
+    if (rutaDiario != nullptr && rutaDiario[0] != '\0') {
+        MotorIngesta recuperacion(sistema);
+        DiarioLecturas::reproducir(rutaDiario, recuperacion);
+        if (diarioSesion.abrir(rutaDiario)) {
+            diario = &diarioSesion;
+        }
+    }
     
     cout << "==================================================" << endl;
     cout << "  Sistema de Gestión Polimórfica de Sensores IoT" << endl;
@@ -189,6 +262,7 @@ int main() {
     cout << "==================================================" << endl;
     
     do {
+        Log::vaciar();  // Los mensajes pendientes salen antes del menú
         mostrarMenu();
         cin >> opcion;
         
@@ -214,6 +288,14 @@ int main() {
                 break;
             case 7:
                 cout << "\n--- Opción 5: Cerrar Sistema (Liberar Memoria) ---" << endl;
+                if (diario != nullptr) {
+                    diario->cerrar();
+                    diario = nullptr;
+                }
+                if (instantanea != nullptr && instantanea[0] != '\0' && Instantanea::guardar(sistema, instantanea) &&
+                    rutaDiario != nullptr && rutaDiario[0] != '\0') {
+                    std::remove(rutaDiario);    // Su contenido ya está en la instantánea
+                }
                 cout << "Saliendo del sistema..." << endl;
                 break;
             default:
@@ -222,6 +304,7 @@ int main() {
         
     } while (opcion != 7);
     
-    // El destructor de ListaGeneral liberará toda la memoria automáticamente
+    // El destructor de ListaGeneral liberará toda la memoria automáticamente;
+    // Log::detener() (registrado con atexit) escribe los mensajes pendientes
     return 0;
 }
@@ -0,0 +1,653 @@
+/**
+ * @file generador_carga.cpp
+ * @brief Generador de carga TIPO,ID,VALOR para medir la ingesta sin Arduino
+ * @author Diego Ibarra
+ * @date 30 de octubre de 2025
+ *
+ * Uso: generador_carga [opciones]
+ *   --salida RUTA   Archivo o FIFO destino (sin ella, la salida estándar)
+ *   --pty           Crea un pseudoterminal y escribe en él
+ *   --sensores N    Sensores distintos, mitad T y mitad P (100)
+ *   --tasa N        Líneas por segundo; 0 = tan rápido como se pueda (0)
+ *   --lineas N      Total de líneas; 0 = hasta --duracion o Ctrl+C (1000000)
+ *   --duracion S    Segundos como máximo; 0 = sin límite (0)
+ *   --valores D     uniforme, normal, constante u onda (uniforme)
+ *   --errores F     Fracción de líneas malformadas entre 0 y 1 (0)
+ *   --rafagas A:I   Emite durante A ms y calla durante I ms, en ciclo
+ *   --marcas N      Una marca de latencia cada N líneas; 0 = ninguna (1000)
+ *   --binario       Tramas de 7 bytes (como el simulador tras 'B')
+ *   --semilla N     Semilla del generador pseudoaleatorio (1)
+ *   --espera S      Segundos que se espera a que alguien abra el pty (30)
+ *
+ * Emite el mismo flujo que arduino/sensor_simulator (T-001.., P-001..),
+ * pero a la tasa pedida, desde un búfer de 64 KB que se escribe de una
+ * vez. Los sensores se recorren en orden circular.
+ *
+ * Las marcas de latencia son comentarios "#LAT,<ns>" con la hora de
+ * relojNs(): el programa las cuenta como comentarios y reporta la
+ * latencia desde que se escribieron hasta que se analizaron. Sólo son
+ * comparables si ambos procesos corren en la misma máquina.
+ *
+ * Al terminar se reporta en stderr la tasa lograda y el tiempo bloqueado
+ * en write(): si el lector no alcanza, el pty o el FIFO se llenan y ese
+ * tiempo crece, lo que marca el punto de saturación.
+ */
+
+#include "ParserLineas.h"
+#include "TramaBinaria.h"
+#include "VentanaTiempo.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Bytes del búfer de salida
+static const int TAM_SALIDA = 64 * 1024;
+/// Espacio que debe quedar libre para formatear una línea más
+static const int MARGEN_LINEA = 128;
+/// Longitud máxima de un ID generado
+static const int TAM_ID = 16;
+
+/// Se activa con Ctrl+C para terminar y reportar
+static volatile std::sig_atomic_t detener = 0;
+
+/**
+ * @brief Manejador de SIGINT
+ */
+static void alInterrumpir(int) {
+    detener = 1;
+}
+
+/**
+ * @brief Distribución de los valores de cada sensor
+ */
+enum class Distribucion {
+    UNIFORME,   ///< Uniforme alrededor del valor base del sensor
+    NORMAL,     ///< Aproximadamente normal (suma de cuatro uniformes)
+    CONSTANTE,  ///< Siempre el valor base
+    ONDA        ///< Senoidal (256 vueltas por periodo), desfasada por sensor
+};
+
+/**
+ * @brief Opciones de la ejecución
+ */
+struct OpcionesGenerador {
+    const char* salida;         ///< Archivo o FIFO (nullptr = salida estándar)
+    bool pty;                   ///< Crear un pseudoterminal
+    int sensores;               ///< Sensores distintos
+    double tasa;                ///< Líneas por segundo (0 = sin límite)
+    long long lineas;           ///< Total de líneas (0 = sin límite)
+    double duracion;            ///< Segundos como máximo (0 = sin límite)
+    Distribucion valores;       ///< Distribución de los valores
+    double errores;             ///< Fracción de líneas malformadas
+    int rafagaMs;               ///< Duración de cada ráfaga (0 = flujo continuo)
+    int silencioMs;             ///< Pausa entre ráfagas
+    int marcas;                 ///< Líneas entre marcas de latencia (0 = ninguna)
+    bool binario;               ///< Tramas binarias en lugar de texto
+    unsigned long long semilla; ///< Semilla pseudoaleatoria
+    int esperaPty;              ///< Segundos de espera al lector del pty
+
+    /**
+     * @brief Constructor con los valores predeterminados
+     */
+    OpcionesGenerador()
+        : salida(nullptr), pty(false), sensores(100), tasa(0.0), lineas(1000000), duracion(0.0),
+          valores(Distribucion::UNIFORME), errores(0.0), rafagaMs(0), silencioMs(0), marcas(1000),
+          binario(false), semilla(1), esperaPty(30) {}
+};
+
+/**
+ * @brief Contadores de la ejecución
+ */
+struct EstadisticasGenerador {
+    long long lineas;           ///< Lecturas, errores y marcas emitidas
+    long long malformadas;      ///< Líneas o tramas dañadas a propósito
+    long long marcas;           ///< Marcas de latencia
+    long long bytes;            ///< Bytes escritos
+    long long escrituras;       ///< Llamadas a write()
+    long long nsEscribiendo;    ///< Tiempo dentro de write() (bloqueado si el lector no alcanza)
+};
+
+/**
+ * @brief xorshift64*: rápido y suficiente para generar carga
+ */
+class Aleatorio {
+private:
+    unsigned long long estado;  ///< Estado (nunca 0)
+
+public:
+    /**
+     * @brief Constructor
+     * @param semilla Semilla (0 se sustituye)
+     */
+    explicit Aleatorio(unsigned long long semilla) : estado(semilla != 0 ? semilla : 0x9E3779B97F4A7C15ULL) {}
+
+    /**
+     * @brief Siguiente número de 32 bits
+     */
+    unsigned int siguiente() {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return static_cast<unsigned int>((estado * 0x2545F4914F6CDD1DULL) >> 32);
+    }
+
+    /**
+     * @brief Entero uniforme en [-amplitud, amplitud]
+     * @param amplitud Semiancho del intervalo
+     */
+    int centrado(int amplitud) {
+        return static_cast<int>(siguiente() % static_cast<unsigned int>(2 * amplitud + 1)) - amplitud;
+    }
+};
+
+/**
+ * @brief Escribe un entero en decimal
+ * @param destino Búfer con espacio suficiente
+ * @param valor Entero a escribir
+ * @return Puntero después del último dígito
+ */
+static char* escribirEntero(char* destino, long long valor) {
+    if (valor < 0) {
+        *destino++ = '-';
+        valor = -valor;
+    }
+    char digitos[20];
+    int n = 0;
+    do {
+        digitos[n++] = static_cast<char>('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+    while (n > 0) {
+        *destino++ = digitos[--n];
+    }
+    return destino;
+}
+
+/**
+ * @brief Genera el flujo y lo escribe en el descriptor de salida
+ */
+class Generador {
+private:
+    const OpcionesGenerador& opciones;  ///< Opciones de la ejecución
+    EstadisticasGenerador stats;        ///< Contadores
+    Aleatorio aleatorio;                ///< Valores y errores
+    int fd;                             ///< Descriptor destino
+
+    int numTemperatura;                 ///< Sensores T (los primeros del recorrido)
+    char* ids;                          ///< IDs de los sensores, TAM_ID bytes cada uno
+    unsigned char* longitudes;          ///< Longitud de cada ID
+    unsigned int umbralError;           ///< Probabilidad de error escalada a 2^32
+    short onda[256];                    ///< Tabla del seno en milésimas
+    unsigned char secuencia;            ///< Secuencia de las tramas
+    long long lecturas;                 ///< Lecturas emitidas (las marcas no avanzan el recorrido)
+    char* salida;                       ///< Búfer de salida
+    int usados;                         ///< Bytes en el búfer
+
+    /**
+     * @brief Valor de un sensor en unidades del protocolo
+     * @param sensor Índice del sensor
+     * @param vuelta Veces que se ha recorrido la lista de sensores
+     * @return Décimas de grado (T) o presión entera (P)
+     */
+    int valor(int sensor, long long vuelta) {
+        bool temperatura = sensor < numTemperatura;
+        int base = temperatura ? 200 + (sensor % 10) * 10 : 75 + sensor % 20;
+        int amplitud = temperatura ? 50 : 10;
+        switch (opciones.valores) {
+            case Distribucion::UNIFORME:
+                return base + aleatorio.centrado(amplitud);
+            case Distribucion::NORMAL: {
+                int suma = 0;
+                for (int i = 0; i < 4; i++) suma += aleatorio.centrado(amplitud);
+                return base + suma / 2;
+            }
+            case Distribucion::CONSTANTE:
+                return base;
+            case Distribucion::ONDA:
+                return base + amplitud * onda[(vuelta + sensor * 7) & 255] / 1000;
+        }
+        return base;
+    }
+
+    /**
+     * @brief Agrega una línea malformada (una de las cuatro causas del analizador, en turno)
+     * @param sensor Índice del sensor
+     */
+    void agregarMalformada(int sensor) {
+        char* p = salida + usados;
+        const char* id = ids + sensor * TAM_ID;
+        switch (stats.malformadas % 4) {
+            case 0:     // Faltan campos
+                *p++ = 'T'; *p++ = ',';
+                memcpy(p, id, longitudes[sensor]); p += longitudes[sensor];
+                break;
+            case 1:     // Tipo desconocido
+                *p++ = 'X'; *p++ = ',';
+                memcpy(p, id, longitudes[sensor]); p += longitudes[sensor];
+                memcpy(p, ",1.0", 4); p += 4;
+                break;
+            case 2:     // ID vacío
+                memcpy(p, "T,,1.0", 6); p += 6;
+                break;
+            default:    // Valor no numérico
+                *p++ = 'P'; *p++ = ',';
+                memcpy(p, id, longitudes[sensor]); p += longitudes[sensor];
+                memcpy(p, ",abc", 4); p += 4;
+                break;
+        }
+        *p++ = '\n';
+        usados = static_cast<int>(p - salida);
+    }
+
+    /**
+     * @brief Agrega la lectura de un sensor en texto o como trama
+     * @param sensor Índice del sensor
+     * @param vuelta Veces que se ha recorrido la lista de sensores
+     * @param danada La lectura debe llegar malformada
+     */
+    void agregarLectura(int sensor, long long vuelta, bool danada) {
+        bool temperatura = sensor < numTemperatura;
+        int v = valor(sensor, vuelta);
+        if (opciones.binario) {
+            int canal = temperatura ? sensor + 1 : sensor - numTemperatura + 1;
+            unsigned char* trama = reinterpret_cast<unsigned char*>(salida + usados);
+            TramaBinaria::codificar(temperatura ? 'T' : 'P', canal, v, secuencia++, trama);
+            if (danada) {
+                trama[TramaBinaria::LONGITUD - 1] ^= 0x5A;  // CRC incorrecto
+            }
+            usados += TramaBinaria::LONGITUD;
+            return;
+        }
+        if (danada) {
+            agregarMalformada(sensor);
+            return;
+        }
+
+        char* p = salida + usados;
+        *p++ = temperatura ? 'T' : 'P';
+        *p++ = ',';
+        memcpy(p, ids + sensor * TAM_ID, longitudes[sensor]);
+        p += longitudes[sensor];
+        *p++ = ',';
+        if (temperatura) {
+            if (v < 0) {
+                *p++ = '-';
+                v = -v;
+            }
+            p = escribirEntero(p, v / 10);
+            *p++ = '.';
+            *p++ = static_cast<char>('0' + v % 10);
+        } else {
+            p = escribirEntero(p, v);
+        }
+        *p++ = '\n';
+        usados = static_cast<int>(p - salida);
+    }
+
+    /**
+     * @brief Agrega una marca de latencia con la hora actual
+     */
+    void agregarMarca() {
+        char* p = salida + usados;
+        size_t prefijo = strlen(ParserLineas::PREFIJO_LATENCIA);
+        memcpy(p, ParserLineas::PREFIJO_LATENCIA, prefijo);
+        p = escribirEntero(p + prefijo, relojNs());
+        *p++ = '\n';
+        usados = static_cast<int>(p - salida);
+        stats.marcas++;
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param opciones Opciones de la ejecución (ya validadas)
+     * @param fd Descriptor destino
+     */
+    Generador(const OpcionesGenerador& opciones, int fd)
+        : opciones(opciones), stats(), aleatorio(opciones.semilla), fd(fd),
+          numTemperatura((opciones.sensores + 1) / 2), ids(new char[static_cast<size_t>(opciones.sensores) * TAM_ID]),
+          longitudes(new unsigned char[opciones.sensores]), umbralError(0), onda(), secuencia(0), lecturas(0),
+          salida(new char[TAM_SALIDA]), usados(0) {
+        for (int i = 0; i < opciones.sensores; i++) {
+            bool temperatura = i < numTemperatura;
+            int numero = temperatura ? i + 1 : i - numTemperatura + 1;
+            int n = snprintf(ids + i * TAM_ID, TAM_ID, "%c-%03d", temperatura ? 'T' : 'P', numero);
+            longitudes[i] = static_cast<unsigned char>(n);
+        }
+        umbralError = static_cast<unsigned int>(opciones.errores * 4294967295.0);
+        for (int i = 0; i < 256; i++) {
+            // Aproximación parabólica del seno: sobra para una onda de prueba
+            int x = i < 128 ? i : i - 128;
+            int s = 4 * x * (128 - x) * 1000 / (128 * 128);
+            onda[i] = static_cast<short>(i < 128 ? s : -s);
+        }
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~Generador() {
+        delete[] ids;
+        delete[] longitudes;
+        delete[] salida;
+    }
+
+    Generador(const Generador&) = delete;               ///< No copiable
+    Generador& operator=(const Generador&) = delete;    ///< No asignable
+
+    /**
+     * @brief Llena el búfer con hasta maximo líneas
+     * @param maximo Líneas permitidas por la tasa
+     * @return Líneas agregadas
+     */
+    long long llenar(long long maximo) {
+        long long agregadas = 0;
+        while (agregadas < maximo && usados <= TAM_SALIDA - MARGEN_LINEA) {
+            long long n = stats.lineas;
+            if (opciones.marcas > 0 && n % opciones.marcas == 0) {
+                agregarMarca();
+            } else {
+                bool danada = umbralError > 0 && aleatorio.siguiente() < umbralError;
+                int sensor = static_cast<int>(lecturas % opciones.sensores);
+                agregarLectura(sensor, lecturas / opciones.sensores, danada);
+                if (danada) stats.malformadas++;
+                lecturas++;
+            }
+            stats.lineas++;
+            agregadas++;
+        }
+        return agregadas;
+    }
+
+    /**
+     * @brief Escribe el búfer completo
+     * @return false si el lector cerró el otro extremo o hubo un error
+     */
+    bool vaciar() {
+        const char* p = salida;
+        int restantes = usados;
+        long long t0 = relojNs();
+        while (restantes > 0) {
+            ssize_t n = write(fd, p, static_cast<size_t>(restantes));
+            if (n < 0) {
+                if (errno == EINTR && !detener) continue;
+                if (errno != EINTR) {
+                    fprintf(stderr, "Error al escribir: %s\n", strerror(errno));
+                }
+                return false;
+            }
+            stats.escrituras++;
+            stats.bytes += n;
+            p += n;
+            restantes -= static_cast<int>(n);
+        }
+        stats.nsEscribiendo += relojNs() - t0;
+        usados = 0;
+        return true;
+    }
+
+    /**
+     * @brief Contadores de la ejecución
+     */
+    const EstadisticasGenerador& estadisticas() const {
+        return stats;
+    }
+};
+
+/**
+ * @brief Duerme una cantidad de nanosegundos (interrumpible por Ctrl+C)
+ * @param ns Nanosegundos
+ */
+static void dormirNs(long long ns) {
+    if (ns <= 0) return;
+    timespec pausa;
+    pausa.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    pausa.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    nanosleep(&pausa, nullptr);
+}
+
+/**
+ * @brief Tiempo activo transcurrido descontando los silencios entre ráfagas
+ * @param opciones Opciones con el patrón de ráfagas
+ * @param ns Tiempo total transcurrido
+ * @param silencioRestante Si ahora es un silencio, ns que faltan para la siguiente ráfaga (0 si no)
+ * @return ns en los que se ha estado emitiendo
+ */
+static long long tiempoActivo(const OpcionesGenerador& opciones, long long ns, long long& silencioRestante) {
+    silencioRestante = 0;
+    if (opciones.rafagaMs <= 0) return ns;
+    long long rafaga = opciones.rafagaMs * 1000000LL;
+    long long ciclo = rafaga + opciones.silencioMs * 1000000LL;
+    long long dentro = ns % ciclo;
+    if (dentro >= rafaga) {
+        silencioRestante = ciclo - dentro;
+        dentro = rafaga;
+    }
+    return (ns / ciclo) * rafaga + dentro;
+}
+
+/**
+ * @brief Crea un pseudoterminal en modo crudo y espera a que alguien abra el esclavo
+ * @param esperaS Segundos como máximo
+ * @return Descriptor del maestro, o -1
+ */
+static int abrirPty(int esperaS) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+        fprintf(stderr, "No se pudo crear el pseudoterminal: %s\n", strerror(errno));
+        if (maestro >= 0) close(maestro);
+        return -1;
+    }
+    const char* esclavo = ptsname(maestro);
+
+    // Sin eco ni conversión de saltos de línea aunque el lector tarde en configurarlo
+    int fdEsclavo = open(esclavo, O_RDWR | O_NOCTTY);
+    if (fdEsclavo >= 0) {
+        struct termios tty;
+        if (tcgetattr(fdEsclavo, &tty) == 0) {
+            cfmakeraw(&tty);
+            tcsetattr(fdEsclavo, TCSANOW, &tty);
+        }
+        close(fdEsclavo);
+    }
+    fprintf(stderr, "Pseudoterminal: %s (esperando al lector)\n", esclavo);
+
+    // Mientras nadie tenga abierto el esclavo, el maestro reporta POLLHUP
+    long long limite = relojNs() + esperaS * 1000000000LL;
+    while (!detener && relojNs() < limite) {
+        struct pollfd vigilado;
+        vigilado.fd = maestro;
+        vigilado.events = POLLOUT;
+        vigilado.revents = 0;
+        if (poll(&vigilado, 1, 50) > 0 && (vigilado.revents & POLLHUP) == 0) {
+            return maestro;
+        }
+        dormirNs(50000000LL);
+    }
+    fprintf(stderr, "Nadie abrió %s\n", esclavo);
+    close(maestro);
+    return -1;
+}
+
+/**
+ * @brief Espera a que el lector del pty consuma lo que queda en la cola
+ * @param maestro Descriptor del maestro
+ *
+ * Al cerrar el maestro se descarta lo que el esclavo no haya leído.
+ */
+static void esperarDrenado(int maestro) {
+    long long limite = relojNs() + 5000000000LL;
+    int pendientes = 0;
+    while (relojNs() < limite && ioctl(maestro, TIOCOUTQ, &pendientes) == 0 && pendientes > 0) {
+        dormirNs(1000000LL);
+    }
+}
+
+/**
+ * @brief Imprime la forma de uso
+ * @param programa Nombre del ejecutable
+ */
+static void imprimirUso(const char* programa) {
+    fprintf(stderr,
+            "Uso: %s [--salida RUTA | --pty] [--sensores N] [--tasa N] [--lineas N] [--duracion S]\n"
+            "       [--valores uniforme|normal|constante|onda] [--errores F] [--rafagas A:I]\n"
+            "       [--marcas N] [--binario] [--semilla N] [--espera S]\n",
+            programa);
+}
+
+/**
+ * @brief Interpreta la línea de comandos
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @param opciones Destino
+ * @return false si hay una opción inválida
+ */
+static bool leerOpciones(int argc, char* argv[], OpcionesGenerador& opciones) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hayValor = i + 1 < argc;
+        if (strcmp(arg, "--pty") == 0) {
+            opciones.pty = true;
+        } else if (strcmp(arg, "--binario") == 0) {
+            opciones.binario = true;
+        } else if (!hayValor) {
+            return false;
+        } else if (strcmp(arg, "--salida") == 0) {
+            opciones.salida = argv[++i];
+        } else if (strcmp(arg, "--sensores") == 0) {
+            opciones.sensores = atoi(argv[++i]);
+        } else if (strcmp(arg, "--tasa") == 0) {
+            opciones.tasa = atof(argv[++i]);
+        } else if (strcmp(arg, "--lineas") == 0) {
+            opciones.lineas = atoll(argv[++i]);
+        } else if (strcmp(arg, "--duracion") == 0) {
+            opciones.duracion = atof(argv[++i]);
+        } else if (strcmp(arg, "--errores") == 0) {
+            opciones.errores = atof(argv[++i]);
+        } else if (strcmp(arg, "--marcas") == 0) {
+            opciones.marcas = atoi(argv[++i]);
+        } else if (strcmp(arg, "--semilla") == 0) {
+            opciones.semilla = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--espera") == 0) {
+            opciones.esperaPty = atoi(argv[++i]);
+        } else if (strcmp(arg, "--rafagas") == 0) {
+            if (sscanf(argv[++i], "%d:%d", &opciones.rafagaMs, &opciones.silencioMs) != 2) return false;
+        } else if (strcmp(arg, "--valores") == 0) {
+            const char* d = argv[++i];
+            if (strcmp(d, "uniforme") == 0) opciones.valores = Distribucion::UNIFORME;
+            else if (strcmp(d, "normal") == 0) opciones.valores = Distribucion::NORMAL;
+            else if (strcmp(d, "constante") == 0) opciones.valores = Distribucion::CONSTANTE;
+            else if (strcmp(d, "onda") == 0) opciones.valores = Distribucion::ONDA;
+            else return false;
+        } else {
+            return false;
+        }
+    }
+
+    if (opciones.sensores < 1 || opciones.tasa < 0.0 || opciones.lineas < 0 || opciones.marcas < 0 ||
+        opciones.errores < 0.0 || opciones.errores > 1.0 || opciones.rafagaMs < 0 || opciones.silencioMs < 0) {
+        return false;
+    }
+    if (opciones.binario && opciones.sensores > 2 * TramaBinaria::CANAL_MAXIMO) {
+        fprintf(stderr, "Con --binario hay a lo sumo %d sensores por tipo.\n", TramaBinaria::CANAL_MAXIMO);
+        return false;
+    }
+    if (opciones.sensores > 9999999) {
+        fprintf(stderr, "Demasiados sensores.\n");
+        return false;
+    }
+    return !(opciones.pty && opciones.salida != nullptr);
+}
+
+int main(int argc, char* argv[]) {
+    OpcionesGenerador opciones;
+    if (!leerOpciones(argc, argv, opciones)) {
+        imprimirUso(argv[0]);
+        return 1;
+    }
+
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = alInterrumpir;
+    sigemptyset(&accion.sa_mask);
+    sigaction(SIGINT, &accion, nullptr);
+    signal(SIGPIPE, SIG_IGN);   // Si el lector cierra el FIFO, write() falla con EPIPE
+
+    int fd = STDOUT_FILENO;
+    if (opciones.pty) {
+        fd = abrirPty(opciones.esperaPty);
+    } else if (opciones.salida != nullptr) {
+        // Un FIFO bloquea aquí hasta que el programa lo abre para leer
+        fd = open(opciones.salida, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "No se pudo abrir %s: %s\n", opciones.salida, strerror(errno));
+        }
+    }
+    if (fd < 0) return 2;
+
+    Generador generador(opciones, fd);
+    long long limiteNs = opciones.duracion > 0.0 ? static_cast<long long>(opciones.duracion * 1e9) : 0;
+    long long inicio = relojNs();
+    long long emitidas = 0;
+    bool abierto = true;
+
+    while (abierto && !detener && (opciones.lineas == 0 || emitidas < opciones.lineas)) {
+        long long transcurrido = relojNs() - inicio;
+        if (limiteNs > 0 && transcurrido >= limiteNs) break;
+
+        long long silencio = 0;
+        long long activo = tiempoActivo(opciones, transcurrido, silencio);
+        if (silencio > 0) {
+            dormirNs(silencio);
+            continue;
+        }
+
+        // Líneas que la tasa permite hasta ahora (sin límite si tasa = 0)
+        long long permitidas = opciones.lineas > 0 ? opciones.lineas - emitidas : TAM_SALIDA;
+        if (opciones.tasa > 0.0) {
+            long long objetivo = static_cast<long long>(static_cast<double>(activo) * opciones.tasa / 1e9) + 1;
+            if (objetivo - emitidas < permitidas) permitidas = objetivo - emitidas;
+            if (permitidas <= 0) {
+                long long siguiente = static_cast<long long>(1e9 / opciones.tasa);
+                dormirNs(siguiente < 1000000LL ? siguiente : 1000000LL);
+                continue;
+            }
+        }
+        emitidas += generador.llenar(permitidas);
+        abierto = generador.vaciar();
+    }
+    double segundos = static_cast<double>(relojNs() - inicio) / 1e9;
+
+    if (opciones.pty) {
+        esperarDrenado(fd);
+    }
+    if (fd != STDOUT_FILENO) {
+        close(fd);
+    }
+
+    const EstadisticasGenerador& stats = generador.estadisticas();
+    double base = segundos > 0.0 ? segundos : 1e-9;
+    fprintf(stderr, "\n=== Generador de carga ===\n");
+    fprintf(stderr, "Líneas:            %lld (%lld malformadas, %lld marcas)\n", stats.lineas, stats.malformadas,
+            stats.marcas);
+    fprintf(stderr, "Bytes:             %lld en %lld escrituras\n", stats.bytes, stats.escrituras);
+    fprintf(stderr, "Tiempo:            %.3f s\n", segundos);
+    fprintf(stderr, "Tasa lograda:      %.0f líneas/s, %.1f MiB/s", stats.lineas / base,
+            stats.bytes / base / (1024.0 * 1024.0));
+    if (opciones.tasa > 0.0) {
+        fprintf(stderr, " (pedida %.0f)", opciones.tasa);
+    }
+    fprintf(stderr, "\nBloqueado en write: %.3f s (%.1f %%)\n", stats.nsEscribiendo / 1e9,
+            100.0 * static_cast<double>(stats.nsEscribiendo) / 1e9 / base);
+    return abierto || detener ? 0 : 3;
+}